@@ -41,6 +41,7 @@ list( APPEND DS_CINDER_SRC_FILES
 	${ROOT_PATH}/src/ds/query/query_result.cpp			
 	${ROOT_PATH}/src/ds/query/sql_query_result_builder.cpp
 	${ROOT_PATH}/src/ds/query/query_result_builder.cpp
+	${ROOT_PATH}/src/ds/query/sql_connection_pool.cpp
 	${ROOT_PATH}/src/ds/query/sql_database.cpp
 	${ROOT_PATH}/src/ds/query/query_client.cpp			# error: invalid initialization of non-const reference of type ‘std::unique_ptr<ds::WorkRequest>&’ from an rvalue of type ‘std::unique_ptr<ds::WorkRequest>’
 	${ROOT_PATH}/src/ds/query/query_result_editor.cpp
@@ -50,11 +51,15 @@ list( APPEND DS_CINDER_SRC_FILES
 	${ROOT_PATH}/src/ds/app/engine/engine_server.cpp
 	${ROOT_PATH}/src/ds/app/engine/engine_client_list.cpp
 	${ROOT_PATH}/src/ds/app/engine/engine_roots.cpp
+	${ROOT_PATH}/src/ds/app/engine/engine_replication.cpp
 	${ROOT_PATH}/src/ds/app/engine/engine_cfg.cpp
 	${ROOT_PATH}/src/ds/app/engine/engine_stats_view.cpp
 	${ROOT_PATH}/src/ds/app/engine/unique_id.cpp
 	${ROOT_PATH}/src/ds/app/engine/engine_settings.cpp
+	${ROOT_PATH}/src/ds/app/engine/engine_sprite_table.cpp
+	${ROOT_PATH}/src/ds/app/engine/engine_world_writer.cpp
 	${ROOT_PATH}/src/ds/app/engine/engine_data.cpp
+	${ROOT_PATH}/src/ds/app/engine/engine_frame_coalescer.cpp
 	${ROOT_PATH}/src/ds/app/engine/engine.cpp
 	${ROOT_PATH}/src/ds/app/engine/engine_client.cpp
 	${ROOT_PATH}/src/ds/app/engine/engine_io_defs.cpp
@@ -88,6 +93,7 @@ list( APPEND DS_CINDER_SRC_FILES
 	${ROOT_PATH}/src/ds/ui/tween/sprite_anim.cpp
 	${ROOT_PATH}/src/ds/ui/service/glsl_image_service.cpp
 	${ROOT_PATH}/src/ds/ui/service/pango_font_service.cpp
+	${ROOT_PATH}/src/ds/ui/service/text_cache.cpp
 	${ROOT_PATH}/src/ds/ui/service/load_image_service.cpp
 	${ROOT_PATH}/src/ds/ui/sprite/util/blend.cpp
 	${ROOT_PATH}/src/ds/ui/sprite/util/clip_plane.cpp
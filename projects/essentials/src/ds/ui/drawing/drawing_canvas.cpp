@@ -152,6 +152,7 @@ DrawingCanvas::DrawingCanvas(ds::ui::SpriteEngine& eng, const std::string& brush
   , mBrushSize(24.0f)
   , mBrushColor(1.0f, 0.0f, 0.0f, 0.5f)
   , mEraseMode(false) {
+	setWantsUpdates(true);
 
 	mBlobType = BLOB_TYPE;
 	setBaseShader(vertShader, opacityFrag, shaderNameOpaccy);
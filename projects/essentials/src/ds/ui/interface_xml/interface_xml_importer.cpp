@@ -86,6 +86,8 @@ namespace ds::ui {
 
 static const std::string INVALID_VALUE = "UNACCEPTABLE!!!!";
 
+static const ds::cfg::VariableMap EMPTY_VARIABLES;
+
 
 std::string XmlImporter::getGradientColorsAsString(ds::ui::Gradient* grad) {
 	if (!grad) return "";
@@ -297,9 +299,12 @@ void XmlImporter::setSpriteProperty(ds::ui::Sprite& sprite, const std::string& p
 	DS_LOG_VERBOSE(4, "XmlImporter: setSpriteProperty, prop=" << property << " value=" << theValue
 															  << " referer=" << referer);
 
-	std::string value = ds::cfg::SettingsVariables::replaceVariables(theValue, local_map);
-	value			  = ds::cfg::SettingsVariables::parseAllExpressions(value);
+	std::string value = ds::cfg::SettingsVariables::replaceVariablesAndExpressions(theValue, local_map);
+	applySpriteProperty(sprite, property, value, referer, local_map);
+}
 
+void XmlImporter::applySpriteProperty(ds::ui::Sprite& sprite, const std::string& property, const std::string& value,
+									  const std::string& referer, const ds::cfg::VariableMap& local_map) {
 	// TODO: build this in a different function?
 	static std::unordered_map<std::string, std::function<void(const SprProps & p)>> propertyMap;
 
@@ -1593,6 +1598,51 @@ void XmlImporter::dispatchSingleEvent(const std::string& value, ds::ui::Sprite*
 	}
 }
 
+/// The sprites of an interface, flattened into a list by compileLayout(). The nodes point into the xml they came from,
+/// which is only used to create sprites that need it (custom importers, <xml> tags).
+struct XmlImporter::CompiledLayout {
+	struct Property {
+		std::string mName;
+		std::string mValue;
+		/// Where a stylesheet property came from. Those only see the app's variables, the rest see the layout's.
+		const Stylesheet* mStylesheet;
+		/// No variables or expressions, so the value is set exactly as written
+		bool mLiteral;
+		/// Overrides are only set for their layout target, and if the sprite parses its children
+		bool		mOverride;
+		bool		mHasTarget;
+		std::string mTarget;
+	};
+
+	struct Node {
+		std::unique_ptr<ci::XmlTree>* mXml;
+		std::string					  mType;
+		std::string					  mValue;
+		bool						  mHasTarget;
+		std::string					  mTarget;
+		/// An <xml> tag, which is read from the xml as usual
+		bool		mInclude;
+		std::string mName;
+		std::string mLink;
+		std::string mAttachState;
+		/// Stylesheet properties, then attributes, then overrides, the order readSprite() sets them in
+		std::vector<Property> mProperties;
+		std::vector<size_t>	  mChildren;
+	};
+
+	const ci::XmlTree*	mSource;
+	std::vector<Node>	mNodes;
+	std::vector<size_t> mRoots;
+};
+
+/// Compiles the preloaded data if it hasn't been, or if it was compiled for a different copy of the xml
+static const XmlImporter::CompiledLayout* getCompiled(XmlImporter::XmlPreloadData& data) {
+	if (!data.mCompiled || data.mCompiled->mSource != &data.mXmlTree) {
+		XmlImporter::compileLayout(data);
+	}
+	return data.mCompiled.get();
+}
+
 XmlImporter::~XmlImporter() {
 	BOOST_FOREACH (auto s, mStylesheets) {
 		delete s;
@@ -1603,6 +1653,8 @@ bool XmlImporter::preloadXml(const std::string& filename, XmlPreloadData& outDat
 	DS_LOG_VERBOSE(3, "XmlImporter: preloadXml filename=" << filename);
 
 	outData.mFilename = filename;
+	// The compiled nodes point into the old tree, which is about to be replaced at the same address
+	outData.mCompiled.reset();
 	try {
 		if (!ds::safeFileExistsCheck(filename, false)) {
 			DS_LOG_WARNING("XmlImporter file doesn't exist: " << filename);
@@ -1677,21 +1729,19 @@ bool XmlImporter::loadXMLto(ds::ui::Sprite* parent, const std::string& filename,
 	XmlPreloadData preloadData;
 
 	// if auto caching, look up the xml in the static cache
-	bool cachedAlready = false;
 	if (AUTO_CACHE) {
 		auto xmlIt = PRELOADED_CACHE.find(filename);
 		if (xmlIt != PRELOADED_CACHE.end()) {
-			cachedAlready = true;
-			preloadData	  = xmlIt->second;
+			// Build straight from the cached copy, which is flattened the first time it's used
+			auto& cached = xmlIt->second;
+			return xmlImporter.load(cached.mXmlTree, mergeFirstChild, override_map, local_map, getCompiled(cached));
 		}
 	}
 
 	// we don't have this in our cache, so look it up
-	if (!cachedAlready) {
-		preloadData.mFilename = filename;
-		if (!preloadXml(filename, preloadData)) {
-			return false;
-		}
+	preloadData.mFilename = filename;
+	if (!preloadXml(filename, preloadData)) {
+		return false;
 	}
 
 	// copy each stylesheet, cause the xml importer will delete it's copies when it destructs
@@ -1712,26 +1762,19 @@ bool XmlImporter::loadXMLto(ds::ui::Sprite* parent, XmlPreloadData& preloadData,
 				   "XmlImporter: loadXMLto preloaded filename=" << preloadData.mFilename << " prefix=" << prefixName);
 	XmlImporter xmlImporter(parent, preloadData.mFilename, map, customImporter, prefixName);
 
-	// copy each stylesheet, cause the xml importer will delete it's copies when it destructs
-	for (auto it = preloadData.mStylesheets.begin(); it < preloadData.mStylesheets.end(); ++it) {
-		Stylesheet* ss = new Stylesheet();
-		ss->mRules	   = (*it)->mRules;
-		ss->mReferer   = (*it)->mReferer;
-		xmlImporter.mStylesheets.push_back(ss);
-	}
-
-	return xmlImporter.load(preloadData.mXmlTree, mergeFirstChild, override_map, local_map);
+	// The stylesheets are already applied in the compiled layout
+	return xmlImporter.load(preloadData.mXmlTree, mergeFirstChild, override_map, local_map, getCompiled(preloadData));
 }
 
 
 bool XmlImporter::load(ci::XmlTree& xml, const bool mergeFirstChild, const ds::cfg::Settings& override_map,
-					   ds::cfg::VariableMap local_map) {
+					   ds::cfg::VariableMap local_map, const CompiledLayout* compiled) {
 	if (!xml.hasChild("interface")) {
 		DS_LOG_WARNING("No interface found in xml file: " << mXmlFile);
 		return false;
 	}
 
-	auto				 interface = xml.getChild("interface");
+	auto&				 interface = xml.getChild("interface");
 	ds::cfg::VariableMap new_local_map;
 
 	// if this file has a settings block grab it.
@@ -1778,12 +1821,20 @@ bool XmlImporter::load(ci::XmlTree& xml, const bool mergeFirstChild, const ds::c
 	bool mergeFirst = mergeFirstChild;
 
 	count = 0;
-	BOOST_FOREACH (auto& xmlNode, sprites) {
-		if (xmlNode->getTag() != "settings") {
-			readSprite(mTargetSprite, xmlNode, mergeFirst);
+	if (compiled) {
+		for (auto it = compiled->mRoots.begin(), end = compiled->mRoots.end(); it != end; ++it) {
+			replaySprite(mTargetSprite, *compiled, *it, mergeFirst);
 			mergeFirst = false;
 			count++;
 		}
+	} else {
+		BOOST_FOREACH (auto& xmlNode, sprites) {
+			if (xmlNode->getTag() != "settings") {
+				readSprite(mTargetSprite, xmlNode, mergeFirst);
+				mergeFirst = false;
+				count++;
+			}
+		}
 	}
 
 	if (count < 1) {
@@ -1836,31 +1887,33 @@ struct SelectorMatchChecker : public boost::static_visitor<bool> {
 	const std::string&				mIdToCheck;
 };
 
+static bool ruleMatches(const ds::ui::stylesheets::Rule& rule, const std::vector<std::string>& classes_vec,
+						const std::string& name) {
+	BOOST_FOREACH (auto& matcher, rule.matchers) {
+
+		// Iterate through .class_rules and #name(id)_rules
+		// ALL the sub-matchers have to match for this matcher to match
+		bool all_submatchers_match = true;
+		BOOST_FOREACH (auto& selector, matcher) {
+			if (!boost::apply_visitor(SelectorMatchChecker(classes_vec, name), selector)) {
+				all_submatchers_match = false;
+				break;
+			}
+		}
+		if (all_submatchers_match) return true;
+	}
+	return false;
+}
+
 static void applyStylesheet(const Stylesheet& stylesheet, ds::ui::Sprite& sprite, const std::string& name,
 							const std::string& classes) {
 
 	DS_LOG_VERBOSE(3, "XmlImporter: applyStylesheet stylesheet=" << stylesheet.mReferer << " name=" << name
 																 << " classes=" << classes);
 
+	auto classes_vec = ds::split(classes, " ", true);
 	BOOST_FOREACH (auto& rule, stylesheet.mRules) {
-		auto classes_vec  = ds::split(classes, " ", true);
-		bool matches_rule = false;
-		BOOST_FOREACH (auto& matcher, rule.matchers) {
-
-			// Iterate through .class_rules and #name(id)_rules
-			// ALL the sub-matchers have to match for this matcher to match
-			bool all_submatchers_match = true;
-			BOOST_FOREACH (auto& selector, matcher) {
-				if (!boost::apply_visitor(SelectorMatchChecker(classes_vec, name), selector)) {
-					all_submatchers_match = false;
-					break;
-				}
-			}
-			matches_rule = all_submatchers_match;
-			if (matches_rule) break;
-		}
-
-		if (matches_rule) {
+		if (ruleMatches(rule, classes_vec, name)) {
 			BOOST_FOREACH (auto& prop, rule.properties) {
 				cinder::XmlTree::Attr attr(nullptr, prop.property_name, prop.property_value);
 				XmlImporter::setSpriteProperty(sprite, attr, stylesheet.mReferer);
@@ -1990,8 +2043,8 @@ ds::ui::Sprite* XmlImporter::createSpriteByType(ds::ui::SpriteEngine& engine, co
 				std::string theValue  = it.substr(colony + 1);
 				if (paramType.empty() || theValue.empty()) continue;
 
-				std::string paramValue = ds::cfg::SettingsVariables::replaceVariables(theValue, local_map);
-				paramValue			   = ds::cfg::SettingsVariables::parseAllExpressions(paramValue);
+				std::string paramValue =
+					ds::cfg::SettingsVariables::replaceVariablesAndExpressions(theValue, local_map);
 
 				if (paramType == "type") {
 					keyboardType = paramValue;
@@ -2099,8 +2152,8 @@ ds::ui::Sprite* XmlImporter::createSpriteByType(ds::ui::SpriteEngine& engine, co
 				std::string theValue  = it.substr(colony + 1);
 				if (paramType.empty() || theValue.empty()) continue;
 
-				std::string paramValue = ds::cfg::SettingsVariables::replaceVariables(theValue, local_map);
-				paramValue			   = ds::cfg::SettingsVariables::parseAllExpressions(paramValue);
+				std::string paramValue =
+					ds::cfg::SettingsVariables::replaceVariablesAndExpressions(theValue, local_map);
 
 				if (paramType == "text_config") {
 					efs.mTextConfig = paramValue;
@@ -2241,30 +2294,8 @@ bool XmlImporter::readSprite(ds::ui::Sprite* parent, std::unique_ptr<ci::XmlTree
 
 
 	} else {
-		ds::ui::Sprite* spriddy = nullptr;
-		if (mergeFirstSprite) {
-			auto parentType = getSpriteTypeForSprite(parent);
-			if (parentType == type) {
-				spriddy = parent;
-			}
-		}
-
-		if (!spriddy) {
-			spriddy = createSpriteByType(engine, type, value);
-		}
-
-		if (!spriddy) {
-			spriddy = engine.createSpriteImporter(type);
-		}
-
-		if (!spriddy && mCustomImporter) {
-			spriddy = mCustomImporter(type, *node);
-		}
-
-		if (!spriddy) {
-			DS_LOG_WARNING("Error creating sprite! Type=" << type);
-			return false;
-		}
+		ds::ui::Sprite* spriddy = createSprite(parent, *node, type, value, mergeFirstSprite);
+		if (!spriddy) return false;
 
 		if (spriddy->parseChildren()) {
 			BOOST_FOREACH (auto& sprite, node->getChildren()) {
@@ -2280,36 +2311,7 @@ bool XmlImporter::readSprite(ds::ui::Sprite* parent, std::unique_ptr<ci::XmlTree
 			mSpriteLinks[spriddy] = linkValue;
 		}
 
-		ds::ui::ScrollArea*	  parentScroll = dynamic_cast<ds::ui::ScrollArea*>(parent);
-		ds::ui::SpriteButton* spriteButton = dynamic_cast<ds::ui::SpriteButton*>(parent);
-		ds::ui::LayoutButton* layoutButton = dynamic_cast<ds::ui::LayoutButton*>(parent);
-		if (parentScroll) {
-			parentScroll->addSpriteToScroll(spriddy);
-		} else if (spriteButton || layoutButton) {
-			std::string attachState = node->getAttributeValue<std::string>("attach_state", "");
-			if (attachState.empty()) {
-				parent->addChildPtr(spriddy);
-			} else if (attachState == "normal") {
-				if (spriteButton) {
-					spriteButton->getNormalSprite().addChildPtr(spriddy);
-				} else if (layoutButton) {
-					layoutButton->getNormalSprite().addChildPtr(spriddy);
-				}
-			} else if (attachState == "high") {
-				if (spriteButton) {
-					spriteButton->getHighSprite().addChildPtr(spriddy);
-				} else if (layoutButton) {
-					layoutButton->getHighSprite().addChildPtr(spriddy);
-				}
-			}
-			if (spriteButton) {
-				spriteButton->showUp();
-			} else if (layoutButton) {
-				layoutButton->showUp();
-			}
-		} else if (parent != spriddy) {
-			parent->addChildPtr(spriddy);
-		}
+		attachSprite(parent, spriddy, node->getAttributeValue<std::string>("attach_state", ""));
 
 		// Get sprite name and classes
 		std::string sprite_name	   = node->getAttributeValue<std::string>("name", "");
@@ -2344,25 +2346,240 @@ bool XmlImporter::readSprite(ds::ui::Sprite* parent, std::unique_ptr<ci::XmlTree
 		}
 
 		// Put sprite in named sprites map
-		if (sprite_name != "") {
+		nameSprite(spriddy, sprite_name);
+	}
 
-			if (!mNamePrefix.empty()) {
-				std::stringstream ss;
-				ss << mNamePrefix << "." << sprite_name;
-				sprite_name = ss.str();
+
+	return true;
+}
+
+ds::ui::Sprite* XmlImporter::createSprite(ds::ui::Sprite* parent, ci::XmlTree& node, const std::string& type,
+										  const std::string& value, const bool mergeFirstSprite) {
+	auto& engine = parent->getEngine();
+
+	ds::ui::Sprite* spriddy = nullptr;
+	if (mergeFirstSprite) {
+		auto parentType = getSpriteTypeForSprite(parent);
+		if (parentType == type) {
+			spriddy = parent;
+		}
+	}
+
+	if (!spriddy) {
+		spriddy = createSpriteByType(engine, type, value);
+	}
+
+	if (!spriddy) {
+		spriddy = engine.createSpriteImporter(type);
+	}
+
+	if (!spriddy && mCustomImporter) {
+		spriddy = mCustomImporter(type, node);
+	}
+
+	if (!spriddy) {
+		DS_LOG_WARNING("Error creating sprite! Type=" << type);
+	}
+
+	return spriddy;
+}
+
+void XmlImporter::attachSprite(ds::ui::Sprite* parent, ds::ui::Sprite* spriddy, const std::string& attachState) {
+	ds::ui::ScrollArea*	  parentScroll = dynamic_cast<ds::ui::ScrollArea*>(parent);
+	ds::ui::SpriteButton* spriteButton = dynamic_cast<ds::ui::SpriteButton*>(parent);
+	ds::ui::LayoutButton* layoutButton = dynamic_cast<ds::ui::LayoutButton*>(parent);
+	if (parentScroll) {
+		parentScroll->addSpriteToScroll(spriddy);
+	} else if (spriteButton || layoutButton) {
+		if (attachState.empty()) {
+			parent->addChildPtr(spriddy);
+		} else if (attachState == "normal") {
+			if (spriteButton) {
+				spriteButton->getNormalSprite().addChildPtr(spriddy);
+			} else if (layoutButton) {
+				layoutButton->getNormalSprite().addChildPtr(spriddy);
 			}
+		} else if (attachState == "high") {
+			if (spriteButton) {
+				spriteButton->getHighSprite().addChildPtr(spriddy);
+			} else if (layoutButton) {
+				layoutButton->getHighSprite().addChildPtr(spriddy);
+			}
+		}
+		if (spriteButton) {
+			spriteButton->showUp();
+		} else if (layoutButton) {
+			layoutButton->showUp();
+		}
+	} else if (parent != spriddy) {
+		parent->addChildPtr(spriddy);
+	}
+}
 
-			spriddy->setSpriteName(ds::wstr_from_utf8(sprite_name));
+void XmlImporter::nameSprite(ds::ui::Sprite* spriddy, std::string sprite_name) {
+	if (sprite_name.empty()) return;
 
-			if (mNamedSpriteMap.find(sprite_name) != mNamedSpriteMap.end()) {
-				DS_LOG_WARNING("Interface xml file " << mXmlFile << " contains duplicate sprites named:" << sprite_name
-													 << ", only the first one will be identified.");
-			} else {
-				mNamedSpriteMap.insert(std::make_pair(sprite_name, spriddy));
+	if (!mNamePrefix.empty()) {
+		std::stringstream ss;
+		ss << mNamePrefix << "." << sprite_name;
+		sprite_name = ss.str();
+	}
+
+	spriddy->setSpriteName(ds::wstr_from_utf8(sprite_name));
+
+	if (mNamedSpriteMap.find(sprite_name) != mNamedSpriteMap.end()) {
+		DS_LOG_WARNING("Interface xml file " << mXmlFile << " contains duplicate sprites named:" << sprite_name
+											 << ", only the first one will be identified.");
+	} else {
+		mNamedSpriteMap.insert(std::make_pair(sprite_name, spriddy));
+	}
+}
+
+static bool isLiteralValue(const std::string& value) {
+	return value.find("$_") == std::string::npos && value.find("#expr") == std::string::npos;
+}
+
+static void compileProperty(XmlImporter::CompiledLayout::Node& node, const std::string& name, const std::string& value,
+							const Stylesheet* stylesheet) {
+	// Commented out
+	if (name.empty() || name.front() == '_') return;
+
+	node.mProperties.emplace_back();
+	auto& prop		 = node.mProperties.back();
+	prop.mName		 = name;
+	prop.mValue		 = value;
+	prop.mStylesheet = stylesheet;
+	prop.mLiteral	 = isLiteralValue(value);
+	prop.mOverride	 = false;
+	prop.mHasTarget	 = false;
+}
+
+static size_t compileNode(XmlImporter::CompiledLayout& layout, std::unique_ptr<ci::XmlTree>& xml,
+						  const std::vector<Stylesheet*>& stylesheets) {
+	const size_t index = layout.mNodes.size();
+	layout.mNodes.emplace_back();
+
+	std::vector<size_t> children;
+	{
+		auto& node		= layout.mNodes.back();
+		node.mXml		= &xml;
+		node.mType		= xml->getTag();
+		node.mValue		= xml->getValue();
+		node.mHasTarget = xml->hasAttribute("target");
+		node.mTarget	= xml->getAttributeValue<std::string>("target", "");
+		node.mInclude	= (node.mType == "xml");
+		if (node.mInclude) return index;
+
+		node.mName		  = xml->getAttributeValue<std::string>("name", "");
+		node.mLink		  = xml->getAttributeValue<std::string>("sprite_link", "");
+		node.mAttachState = xml->getAttributeValue<std::string>("attach_state", "");
+
+		// Stylesheets only depend on the name and classes, so they can be matched once
+		auto classes_vec = ds::split(xml->getAttributeValue<std::string>("class", ""), " ", true);
+		for (auto sit = stylesheets.begin(), send = stylesheets.end(); sit != send; ++sit) {
+			BOOST_FOREACH (auto& rule, (*sit)->mRules) {
+				if (!ruleMatches(rule, classes_vec, node.mName)) continue;
+				BOOST_FOREACH (auto& prop, rule.properties) {
+					compileProperty(node, prop.property_name, prop.property_value, *sit);
+				}
+			}
+		}
+
+		BOOST_FOREACH (auto& attr, xml->getAttributes()) {
+			if (attr.getName() != "target") compileProperty(node, attr.getName(), attr.getValue(), nullptr);
+		}
+
+		BOOST_FOREACH (auto& override_, xml->getChildren()) {
+			if (override_->getTag() != "override") continue;
+			const bool hasTarget = override_->hasAttribute("target");
+			const auto target	 = override_->getAttributeValue<std::string>("target", "");
+			for (auto& attr : override_->getAttributes()) {
+				if (attr.getName() == "target") continue;
+				compileProperty(node, attr.getName(), attr.getValue(), nullptr);
+				node.mProperties.back().mOverride  = true;
+				node.mProperties.back().mHasTarget = hasTarget;
+				node.mProperties.back().mTarget	   = target;
 			}
 		}
 	}
 
+	// Adding children moves the nodes around, so hang on to their indices until the end
+	BOOST_FOREACH (auto& child, xml->getChildren()) {
+		if (child->getTag() != "override") children.push_back(compileNode(layout, child, stylesheets));
+	}
+	layout.mNodes[index].mChildren.swap(children);
+
+	return index;
+}
+
+void XmlImporter::compileLayout(XmlPreloadData& data) {
+	auto compiled	  = std::make_shared<CompiledLayout>();
+	compiled->mSource = &data.mXmlTree;
+
+	if (data.mXmlTree.hasChild("interface")) {
+		BOOST_FOREACH (auto& xmlNode, data.mXmlTree.getChild("interface").getChildren()) {
+			if (xmlNode->getTag() != "settings") {
+				compiled->mRoots.push_back(compileNode(*compiled, xmlNode, data.mStylesheets));
+			}
+		}
+	}
+
+	DS_LOG_VERBOSE(3, "XmlImporter: compiled " << data.mFilename << " into " << compiled->mNodes.size() << " sprites");
+	data.mCompiled = compiled;
+}
+
+bool XmlImporter::replaySprite(ds::ui::Sprite* parent, const CompiledLayout& layout, const size_t nodeIndex,
+							   const bool mergeFirstSprite) {
+	if (!parent) {
+		DS_LOG_WARNING("No parent sprite specified when reading a sprite from xml file=" << mXmlFile);
+		return false;
+	}
+
+	const auto& node = layout.mNodes[nodeIndex];
+	if (node.mInclude) return readSprite(parent, *node.mXml, mergeFirstSprite);
+
+	auto& engine = parent->getEngine();
+
+	// Allows access to the XML structure on construction.
+	ScopedCurrentNode scn(engine, node.mXml->get());
+
+	// Layout targets can change between loads, so they're checked every time
+	if (node.mHasTarget && !engine.hasLayoutTarget(node.mTarget)) {
+		return true;
+	}
+
+	DS_LOG_VERBOSE(6, "XmlImporter: replaySprite type=" << node.mType << " value=" << node.mValue);
+	ds::ui::Sprite* spriddy = createSprite(parent, **node.mXml, node.mType, node.mValue, mergeFirstSprite);
+	if (!spriddy) return false;
+
+	if (spriddy->parseChildren()) {
+		for (auto it = node.mChildren.begin(), end = node.mChildren.end(); it != end; ++it) {
+			replaySprite(spriddy, layout, *it, false);
+		}
+	}
+
+	if (!node.mLink.empty()) {
+		mSpriteLinks[spriddy] = node.mLink;
+	}
+
+	attachSprite(parent, spriddy, node.mAttachState);
+
+	for (auto it = node.mProperties.begin(), end = node.mProperties.end(); it != end; ++it) {
+		if (it->mOverride) {
+			if (!spriddy->parseChildren()) continue;
+			if (it->mHasTarget && !engine.hasLayoutTarget(it->mTarget)) continue;
+		}
+
+		const std::string&			referer	  = (it->mStylesheet ? it->mStylesheet->mReferer : mXmlFile);
+		const ds::cfg::VariableMap& local_map = (it->mStylesheet ? EMPTY_VARIABLES : mCombinedSettings);
+		if (it->mLiteral) {
+			applySpriteProperty(*spriddy, it->mName, it->mValue, referer, local_map);
+		} else {
+			setSpriteProperty(*spriddy, it->mName, it->mValue, referer, local_map);
+		}
+	}
+
+	nameSprite(spriddy, node.mName);
 
 	return true;
 }
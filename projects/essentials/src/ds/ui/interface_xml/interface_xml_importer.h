@@ -9,6 +9,7 @@
 #include <ds/util/bit_mask.h>
 #include <functional>
 #include <map>
+#include <memory>
 
 namespace ds::ui {
 
@@ -20,10 +21,15 @@ struct Stylesheet;
 class XmlImporter {
 
   public:
+	struct CompiledLayout;
+
 	struct XmlPreloadData {
 		ci::XmlTree				 mXmlTree;
 		std::vector<Stylesheet*> mStylesheets;
 		std::string				 mFilename;
+		/// The sprites in mXmlTree flattened by compileLayout(). Cleared by preloadXml(), and rebuilt if it came from
+		/// a different copy of the data
+		std::shared_ptr<CompiledLayout> mCompiled;
 	};
 
 	typedef std::function<ds::ui::Sprite*(const std::string& typeName, ci::XmlTree&)> SpriteImporter;
@@ -54,11 +60,19 @@ class XmlImporter {
 	/// If true, will automatically cache xml interfaces after the first time they're loaded
 	static void setAutoCache(const bool doCaching);
 
+	/// Flattens the sprites in preloaded xml into a list with their stylesheets already matched and their attributes
+	/// already read, so loading the same xml again doesn't walk the xml. loadXMLto() does this on its own for cached
+	/// and preloaded xml, the first time it's loaded.
+	static void compileLayout(XmlPreloadData&);
+
 	static void setSpriteProperty(ds::ui::Sprite& sprite, ci::XmlTree::Attr& attr, const std::string& referer = "",
 								  const ds::cfg::VariableMap& localMap = ds::cfg::VariableMap());
 	static void setSpriteProperty(ds::ui::Sprite& sprite, const std::string& property, const std::string& value,
 								  const std::string&	referer	 = "",
 								  const ds::cfg::VariableMap& localMap = ds::cfg::VariableMap());
+	/// Same as setSpriteProperty(), for a value that's already had its variables and expressions replaced
+	static void applySpriteProperty(ds::ui::Sprite& sprite, const std::string& property, const std::string& value,
+									const std::string& referer, const ds::cfg::VariableMap& localMap);
 
 	static std::string getSpriteTypeForSprite(ds::ui::Sprite* sp);
 
@@ -89,10 +103,19 @@ class XmlImporter {
 	  , mCustomImporter(customImporter) {}
 	~XmlImporter();
 
+	/// Builds the sprites from compiled instead of walking the xml, if it's supplied
 	bool load(ci::XmlTree&, const bool mergeFirstSprite, const ds::cfg::Settings& override_map = ds::cfg::Settings(),
-			  ds::cfg::VariableMap local_map = ds::cfg::VariableMap());
+			  ds::cfg::VariableMap local_map = ds::cfg::VariableMap(), const CompiledLayout* compiled = nullptr);
 
 	bool readSprite(ds::ui::Sprite*, std::unique_ptr<ci::XmlTree>&, const bool mergeFirstSprite);
+	/// Same as readSprite(), for a sprite in a compiled layout
+	bool replaySprite(ds::ui::Sprite*, const CompiledLayout&, const size_t nodeIndex, const bool mergeFirstSprite);
+
+	/// The parts of reading a sprite shared by readSprite() and replaySprite()
+	ds::ui::Sprite* createSprite(ds::ui::Sprite* parent, ci::XmlTree& node, const std::string& type,
+								 const std::string& value, const bool mergeFirstSprite);
+	void			attachSprite(ds::ui::Sprite* parent, ds::ui::Sprite* spriddy, const std::string& attachState);
+	void			nameSprite(ds::ui::Sprite* spriddy, std::string spriteName);
 
 	NamedSpriteMap&			 mNamedSpriteMap;
 	ds::cfg::VariableMap	 mCombinedSettings;
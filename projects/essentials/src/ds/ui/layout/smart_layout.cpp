@@ -25,6 +25,7 @@ SmartLayout::SmartLayout(ds::ui::SpriteEngine& engine, const std::string& xmlLay
   , mLayoutFile(xmlFileLocation + xmlLayoutFile)
   , mNeedsLayout(false)
   , mEventClient(engine) {
+	setWantsUpdates(true);
 
 	if (loadImmediately) {
 		initialize();
@@ -36,7 +37,9 @@ SmartLayout::SmartLayout(ds::ui::SpriteEngine& engine)
   , mInitialized(false)
   , mLayoutFile("")
   , mNeedsLayout(false)
-  , mEventClient(engine) {}
+  , mEventClient(engine) {
+	setWantsUpdates(true);
+}
 
 void SmartLayout::setLayoutFile(const std::string& xmlLayoutFile, const std::string xmlFileLocation,
 								const bool loadImmediately) {
@@ -112,6 +112,7 @@ ScrollArea::ScrollArea(ds::ui::SpriteEngine& engine, const float startWidth, con
   , mScrollUpdatedFunction(nullptr)
   , mTweenCompleteFunction(nullptr)
   , mSnapToPositionFunction(nullptr) {
+	setWantsUpdates(true);
 
 	mReturnAnimateTime = mEngine.getAnimDur();
 
@@ -73,6 +73,8 @@ class LineSprite : public ds::ui::Sprite {
 	virtual bool contains(const ci::vec3& point, const float pad = 0.0f) const;
 
   protected:
+	/// contains() checks the line itself, which isn't bound to my size
+	virtual bool hasPickBounds() const { return false; }
 	virtual void writeAttributesTo(ds::DataBuffer&);
 	virtual void readAttributeFrom(const char attributeId, ds::DataBuffer&);
 	virtual void buildRenderBatch();
@@ -18,6 +18,7 @@ PngSequenceSprite::PngSequenceSprite(SpriteEngine& engine, const std::vector<std
   , mFrameTime(0.0f)
   , mAnimationEndedCallback(nullptr)
   , mLoadedCallback(nullptr) {
+	setWantsUpdates(true);
 
 	mLayoutFixedAspect = true;
 	setImages(imageFiles);
@@ -37,6 +38,7 @@ PngSequenceSprite::PngSequenceSprite(SpriteEngine& engine)
   , mPlaying(true)
   , mIsLoaded(false)
   , mFrameTime(0.0f) {
+	setWantsUpdates(true);
 
 	mLayoutFixedAspect = true;
 	mLastFrameTime	   = ci::app::getElapsedSeconds();
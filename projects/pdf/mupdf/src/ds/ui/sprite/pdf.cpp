@@ -72,6 +72,7 @@ Pdf::Pdf(ds::ui::SpriteEngine& e)
   , mHolder(e)
   , mTexture(nullptr)
   , mPrevScale(0.0f, 0.0f, 0.0f) {
+	setWantsUpdates(true);
 	// Should be unnecessary, but make sure we reference the static.
 	INIT.doNothing();
 	mLayoutFixedAspect = true;
@@ -150,10 +151,12 @@ void Pdf::onUpdateClient(const UpdateParams& p) {
 		mHolder.setScale(mScale);
 		mPrevScale = mScale;
 	}
+	updateVisibleArea();
 	mHolder.update();
 }
 
 void Pdf::onUpdateServer(const UpdateParams& p) {
+	updateVisibleArea();
 	if (mHolder.update()) {
 
 		if (auto theSurface = mHolder.getSurface()) {
@@ -191,6 +194,35 @@ void Pdf::onUpdateServer(const UpdateParams& p) {
 	}
 }
 
+void Pdf::setTiledRendering(const bool tiled) {
+	mHolder.setTiled(tiled);
+}
+
+bool Pdf::getTiledRendering() const {
+	return mHolder.getTiled();
+}
+
+void Pdf::updateVisibleArea() {
+	if (!mHolder.getTiled() || getWidth() < 1.0f || getHeight() < 1.0f) return;
+
+	// The bounds of the world on screen, in page units
+	ci::Rectf world = mEngine.getSrcRect();
+	if (world.getWidth() <= 0.0f || world.getHeight() <= 0.0f) {
+		world = ci::Rectf(0.0f, 0.0f, mEngine.getWorldWidth(), mEngine.getWorldHeight());
+	}
+	const ci::vec3 corners[] = {globalToLocal(ci::vec3(world.x1, world.y1, 0.0f)),
+								globalToLocal(ci::vec3(world.x2, world.y1, 0.0f)),
+								globalToLocal(ci::vec3(world.x2, world.y2, 0.0f)),
+								globalToLocal(ci::vec3(world.x1, world.y2, 0.0f))};
+	ci::Rectf	   area(corners[0].x, corners[0].y, corners[0].x, corners[0].y);
+	for (const auto& corner : corners) {
+		area.include(ci::vec2(corner.x, corner.y));
+	}
+
+	mHolder.setVisibleArea(
+		ci::Rectf(area.x1 / getWidth(), area.y1 / getHeight(), area.x2 / getWidth(), area.y2 / getHeight()));
+}
+
 void Pdf::setPageNum(const int pageNum) {
 	mHolder.setPageNum(pageNum);
 	markAsDirty(PDF_CURPAGE_DIRTY);
@@ -255,6 +287,8 @@ void Pdf::drawLocalClient() {
 	}
 
 	mTexture->unbind();
+
+	mHolder.drawTiles();
 }
 
 void Pdf::writeAttributesTo(ds::DataBuffer& buf) {
@@ -327,7 +361,8 @@ void Pdf::destroyLinks() {
  */
 Pdf::ResHolder::ResHolder(ds::ui::SpriteEngine& e)
   : mService(e.getService<ds::pdf::Service>("pdf"))
-  , mRes(nullptr) {}
+  , mRes(nullptr)
+  , mTiled(mService.mTiledDefault) {}
 
 Pdf::ResHolder::~ResHolder() {
 	clear();
@@ -343,8 +378,9 @@ void Pdf::ResHolder::clear() {
 bool Pdf::ResHolder::setResourceFilename(const std::string& filename) {
 	clear();
 	bool success = false;
-	mRes		 = new ds::pdf::PdfRes(mService.mThread);
+	mRes		 = new ds::pdf::PdfRes(mService);
 	if (mRes) {
+		mRes->setTiled(mTiled);
 		success = mRes->loadPDF(ds::Environment::expand(filename));
 	}
 
@@ -423,4 +459,23 @@ std::vector<ds::pdf::PdfLinkInfo> Pdf::ResHolder::getLinks() {
 	return emptyLinks;
 }
 
+void Pdf::ResHolder::setTiled(const bool tiled) {
+	mTiled = tiled;
+	if (mRes) mRes->setTiled(tiled);
+}
+
+void Pdf::ResHolder::setVisibleArea(const ci::Rectf& area) {
+	if (mRes) mRes->setVisibleArea(area);
+}
+
+void Pdf::ResHolder::drawTiles() {
+	if (!mRes) return;
+
+	for (const auto& tile : mRes->getTiles()) {
+		tile.mTexture->bind();
+		ci::gl::drawSolidRect(tile.mRect, ci::vec2(0, 0), ci::vec2(1, 1));
+		tile.mTexture->unbind();
+	}
+}
+
 } // namespace ds::ui
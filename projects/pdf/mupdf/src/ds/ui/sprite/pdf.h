@@ -113,6 +113,11 @@ class Pdf : public IPdf {
 	/** Returns the current texture for the current page (might not exist so use with caution **/
 	ci::gl::TextureRef getTextureRef() { return mTexture; }
 
+	/** When zoomed in, draw the whole page at a preview size first, then the part on screen sharp in tiles.
+	 * Saves rasterizing and uploading huge pages. Defaults to the pdf:tiled_render setting */
+	void setTiledRendering(const bool tiled);
+	bool getTiledRendering() const;
+
 #ifdef _DEBUG
 	virtual void writeState(std::ostream&, const size_t tab) const override;
 #endif
@@ -157,10 +162,15 @@ class Pdf : public IPdf {
 		void						  goToNextPage();
 		void						  goToPreviousPage();
 		std::vector<pdf::PdfLinkInfo> getLinks();
+		void						  setTiled(const bool tiled);
+		bool						  getTiled() const { return mTiled; }
+		void						  setVisibleArea(const ci::Rectf&);
+		void						  drawTiles();
 
 	  private:
 		ds::pdf::Service& mService;
 		ds::pdf::PdfRes*  mRes;
+		bool			  mTiled;
 	};
 	ResHolder mHolder;
 
@@ -169,6 +179,9 @@ class Pdf : public IPdf {
 	// For clients to detect scale changes and re-render
 	ci::vec3 mPrevScale;
 
+	/// Tells the holder which part of the page is on screen, for tiled rendering
+	void updateVisibleArea();
+
 	void					   createLinks();
 	void					   destroyLinks();
 	std::vector<pdf::PdfLink*> mLinks;
@@ -2,8 +2,16 @@
 
 #include "private/pdf_res.h"
 
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <list>
+#include <unordered_set>
+
 #include <ds/debug/logger.h>
 
+#include "private/pdf_service.h"
+
 extern "C" {
 // #include "MuPDF/fitz.h"
 #include <MuPDF/pdf.h>
@@ -14,121 +22,89 @@ extern "C" {
 
 namespace {
 
-/* LOAD
- * Bundle up the details of loading a PDF
- ******************************************************************/
-class Load {
-  public:
-	class Op {
-	  public:
-		Op() {}
-		virtual ~Op() {}
-		virtual bool run(fz_context&, fz_document&, fz_page&) = 0;
-	};
-
-  public:
-	Load()
-	  : mCtx(nullptr)
-	  , mDoc(nullptr)
-	  , mPage(nullptr) {}
-	~Load() { clear(); }
-
-	bool run(Op& op, const std::string& file, const int pageNumber) {
-		clear();
-		if (!setTo(file, pageNumber)) return false;
-		return op.run(*mCtx, *mDoc, *mPage);
-	}
+/// Pages kept interpreted in each document, so flipping back and forth or zooming doesn't parse them again
+const size_t MAX_PAGES = 8;
+/// Tiles are drawn at scales this many steps apart per doubling, so a pinch doesn't redraw them every frame
+const float TILE_LEVELS_PER_DOUBLING = 2.0f;
 
-  private:
-	bool setTo(const std::string& file, const int pageNumber) {
-		clear();
-		try {
-			bool ans = false;
-			if ((mCtx = fz_new_context(NULL, NULL, FZ_STORE_UNLIMITED)) == nullptr) return false;
+uint64_t tile_key(const int pageNum, const int level, const int col, const int row) {
+	return (static_cast<uint64_t>(pageNum) << 40) | (static_cast<uint64_t>((level + 128) & 0xff) << 32) |
+		   (static_cast<uint64_t>(col & 0xffff) << 16) | static_cast<uint64_t>(row & 0xffff);
+}
 
-			fz_register_document_handlers(mCtx);
+/* TILE JOB
+ * One tile for a tile thread to draw, and the pixels it drew.
+ ******************************************************************/
+struct TileJob {
+	uint64_t				   mKey;
+	int						   mGeneration;
+	int						   mPageNum;
+	float					   mScale;
+	int						   mX, mY, mW, mH; // In pixels of the page drawn at mScale
+	ci::Rectf				   mRect;		   // In page units
+	std::vector<unsigned char> mPixels;		   // RGB
+};
 
-			// This is pretty ugly because MuPDF uses custom C++-like error handing that
-			// has stringent rules, like you're not allowed to return.
-			fz_try(mCtx) {
-				if ((mDoc = fz_open_document(mCtx, file.c_str()))) {
+/* PAGE
+ * A page interpreted into a display list, which can be drawn at any
+ * scale without going back to the document.
+ ******************************************************************/
+struct Page {
+	Page()
+	  : mPageNum(0)
+	  , mList(nullptr)
+	  , mSize(0, 0) {}
+
+	int								  mPageNum;
+	fz_display_list*				  mList;
+	ci::ivec2						  mSize;
+	std::vector<ds::pdf::PdfLinkInfo> mLinks;
+};
 
-					const int pageCount = fz_count_pages(mCtx, mDoc);
-					if (!(pageCount <= 0 || pageNumber > pageCount)) {
+/// The size of a page with these bounds, or 0 x 0 if the bounds are empty or infinite
+ci::ivec2 page_size(const fz_rect& bounds) {
+	if (fz_is_empty_rect(bounds) || fz_is_infinite_rect(bounds)) return ci::ivec2(0, 0);
+	return ci::ivec2(static_cast<int>(ceilf(bounds.x1 - bounds.x0)), static_cast<int>(ceilf(bounds.y1 - bounds.y0)));
+}
 
-						if ((mPage = fz_load_page(mCtx, mDoc, pageNumber - 1))) {
-							ans = true;
-						}
-					}
-				}
+std::vector<ds::pdf::PdfLinkInfo> load_links(fz_context& ctx, fz_page& page, const ci::ivec2& size) {
+	std::vector<ds::pdf::PdfLinkInfo> links;
+	const float						  width	 = static_cast<float>(size.x);
+	const float						  height = static_cast<float>(size.y);
+
+	fz_link* first = fz_load_links(&ctx, &page);
+	for (fz_link* linky = first; linky; linky = linky->next) {
+		if (!linky->uri) continue;
+
+		ds::pdf::PdfLinkInfo this_link;
+		this_link.mRawUri = linky->uri;
+		this_link.mRect	  = ci::Rectf(linky->rect.x0 / width, linky->rect.y0 / height, linky->rect.x1 / width,
+									  linky->rect.y1 / height);
+
+		if (this_link.mRawUri.find("#") == 0) {
+			auto pageNum = this_link.mRawUri.substr(1);
+			auto findy	 = pageNum.find(",");
+			if (findy != std::string::npos) {
+				pageNum				= pageNum.substr(0, findy);
+				this_link.mPageDest = ds::string_to_int(pageNum);
 			}
-			fz_always(mCtx) {}
-			fz_catch(mCtx) {}
-			return ans;
-		} catch (std::exception& ex) {
-			DS_LOG_WARNING("pdf_res.cpp::Load::setTo() exception=" << ex.what());
+		} else {
+			this_link.mUrl = this_link.mRawUri;
 		}
-		DS_LOG_WARNING("ds::ui::sprite::Pdf unable to load document \"" << file << "\".");
-		return false;
-	}
-
-	void clear() {
-		try {
-			if (mPage) {
-				fz_drop_page(mCtx, mPage);
-			}
-		} catch (...) {}
-		try {
-			if (mDoc) {
-				fz_drop_document(mCtx, mDoc);
-			}
-		} catch (...) {}
-		try {
-			if (mCtx) {
-				fz_drop_context(mCtx);
-			}
-		} catch (...) {}
-		mPage = nullptr;
-		mDoc  = nullptr;
-		mCtx  = nullptr;
-	}
 
-	fz_context*	 mCtx;
-	fz_document* mDoc;
-	fz_page*	 mPage;
-};
-
-/* EXAMINE
- * Get the top level details of a PDF
- ******************************************************************/
-class Examine : public Load::Op {
-  public:
-	int mWidth, mHeight, mPageCount;
+		// std::cout << "Found link in page: " << this_link.mPageDest << " " << this_link.mRawUri <<
+		// " " << this_link.mRect << " " << this_link.mUrl << std::endl;
 
-  public:
-	Examine()
-	  : mWidth(0)
-	  , mHeight(0)
-	  , mPageCount(0) {}
-
-	virtual bool run(fz_context& ctx, fz_document& doc, fz_page& page) {
-		fz_rect bounds;
-		bounds = fz_bound_page(&ctx, &page);
-		if (fz_is_empty_rect(bounds) || fz_is_infinite_rect(bounds)) return false;
-
-		mWidth	= ceilf(bounds.x1 - bounds.x0);
-		mHeight = ceilf(bounds.y1 - bounds.y0);
-		//		mWidth = page.mediabox.x1;
-		//		mHeight = page.mediabox.y1;
-		mPageCount = fz_count_pages(&ctx, &doc);
-		return mWidth > 0 && mHeight > 0 && mPageCount > 0;
+		links.emplace_back(this_link);
 	}
-};
+	if (first) fz_drop_link(&ctx, first);
+	return links;
+}
 
 /* DRAW
- * Draw the page to a surface.
+ * Draw a page to a surface.
  ******************************************************************/
-class Draw : public Load::Op {
+class Draw {
   public:
 	Draw(ds::pdf::PdfRes::Pixels& pixels, const float scale)
 	  : mPixels(pixels)
@@ -141,7 +117,16 @@ class Draw : public Load::Op {
 
 	const ci::ivec2& getPageSize() const { return mPageSize; }
 
-	virtual bool run(fz_context& ctx, fz_document& doc, fz_page& page) {
+	bool run(fz_context& ctx, const Page& page) {
+		if (!page.mList || page.mSize.x < 1 || page.mSize.y < 1) return false;
+
+		mPageSize	  = page.mSize;
+		mLinks		  = page.mLinks;
+		mWidth		  = static_cast<float>(mPageSize.x);
+		mHeight		  = static_cast<float>(mPageSize.y);
+		mScaledWidth  = static_cast<int>(mScale * mWidth);
+		mScaledHeight = static_cast<int>(mScale * mHeight);
+
 		if (mScaledWidth > 12000.0f || mScaledHeight > 12000.0f) {
 			DS_LOG_WARNING("Aborting PdfRes render due to too large of a size of a pdf w/h: " << mScaledWidth << " "
 																							  << mScaledHeight);
@@ -152,69 +137,19 @@ class Draw : public Load::Op {
 		try {
 
 			fz_pixmap* pixmap = nullptr;
+			fz_var(pixmap);
 			// This is pretty ugly because MuPDF uses custom C++-like error handing that
 			// has stringent rules, like you're not allowed to return.
 			fz_try((&ctx)) {
-				if (!getPageSize(ctx, page)) return false;
-
-				// Take the page bounds and transform them by the same matrix that
-				// we will use to render the page.
-				fz_rect rect;
-				rect = fz_bound_page(&ctx, &page);
-
-
-				mWidth		  = static_cast<float>(mPageSize.x);
-				mHeight		  = static_cast<float>(mPageSize.y);
-				mScaledWidth  = static_cast<int>(mScale * mWidth);
-				mScaledHeight = static_cast<int>(mScale * mHeight);
-
-
-				/// load links!
-				mLinks.clear();
-				auto linky = fz_load_links(&ctx, &page);
-				if (linky) {
-					while (true) {
-						ds::pdf::PdfLinkInfo this_link;
-						this_link.mRawUri = linky->uri;
-						this_link.mRect	  = ci::Rectf(linky->rect.x0 / mWidth, linky->rect.y0 / mHeight,
-													  linky->rect.x1 / mWidth, linky->rect.y1 / mHeight);
-
-						if (this_link.mRawUri.find("#") == 0) {
-							auto pageNum = this_link.mRawUri.substr(1);
-							auto findy	 = pageNum.find(",");
-							if (findy != std::string::npos) {
-								pageNum				= pageNum.substr(0, findy);
-								this_link.mPageDest = ds::string_to_int(pageNum);
-							}
-						} else {
-							this_link.mUrl = this_link.mRawUri;
-						}
-
-						// std::cout << "Found link in page: " << this_link.mPageDest << " " << this_link.mRawUri <<
-						// " " << this_link.mRect << " " << this_link.mUrl << std::endl;
-
-						mLinks.emplace_back(this_link);
-
-						if (linky->next) {
-							linky = linky->next;
-						} else {
-							break;
-						}
-					}
-				}
-
-
 				const float zoom	  = static_cast<float>(mScaledWidth) / mWidth;
 				fz_matrix	transform = fz_identity;
 				transform			  = fz_scale(zoom, zoom);
 
-				rect = fz_transform_rect(rect, transform);
-
 				// Create a blank pixmap to hold the result of rendering. The
-				// pixmap bounds used here are the same as the transformed page
-				// bounds, so it will contain the entire page. The page coordinate
-				// space has the origin at the top left corner and the x axis
-				// extends to the right and the y axis extends down.
+				// pixmap covers the transformed page bounds, so it will contain
+				// the entire page. The page coordinate space has the origin at
+				// the top left corner and the x axis extends to the right and
+				// the y axis extends down.
 				int w = mScaledWidth, h = mScaledHeight;
 				if (mPixels.setSize(w, h)) {
 					mPixels.clearPixels();
@@ -225,7 +160,8 @@ class Draw : public Load::Op {
 						fz_clear_pixmap_with_value(&ctx, pixmap, 0xff);
 						fz_device* device = fz_new_draw_device(&ctx, transform, pixmap);
 						if (device) {
-							fz_run_page(&ctx, &page, device, fz_identity, nullptr);
+							// Replaying the display list skips parsing the page's content streams again
+							fz_run_display_list(&ctx, page.mList, device, fz_identity, fz_infinite_rect, nullptr);
 							ans = true;
 							fz_close_device(&ctx, device);
 							fz_drop_device(&ctx, device);
@@ -246,27 +182,251 @@ class Draw : public Load::Op {
 		return ans;
 	}
 
-	virtual bool getPageSize(fz_context& ctx, fz_page& page) {
-		fz_rect bounds;
-		bounds = fz_bound_page(&ctx, &page);
-		if (fz_is_empty_rect(bounds) || fz_is_infinite_rect(bounds)) return false;
-		mPageSize.x = ceilf(bounds.x1 - bounds.x0);
-		mPageSize.y = ceilf(bounds.y1 - bounds.y0);
-		return mPageSize.x > 0 && mPageSize.y > 0;
-	}
-
 	std::vector<ds::pdf::PdfLinkInfo> mLinks;
 	ds::pdf::PdfRes::Pixels&		  mPixels;
 	int								  mScaledWidth, mScaledHeight;
 	const float						  mScale;
 	float							  mWidth, mHeight;
-	ci::ivec2						  mOutSize, mPageSize;
+	ci::ivec2						  mPageSize;
 };
 
 } // namespace
 
 namespace ds::pdf {
 
+/* DOCUMENT
+ * An open document and its most recently used pages. Opening the
+ * document parses its xref, and interpreting a page loads its fonts
+ * and images into the context's store, so keeping both around makes
+ * page turns and zooms much cheaper. MuPDF contexts are single
+ * threaded, so hold mMutex while touching anything in here, except
+ * for drawTile(), which draws in a context cloned for its thread.
+ ******************************************************************/
+struct PdfRes::Document {
+	Document()
+	  : mCtx(nullptr)
+	  , mDoc(nullptr)
+	  , mPageCount(0) {}
+	~Document() { close(); }
+
+	bool open(const std::string& file) {
+		close();
+		try {
+			// The store caches fonts and images between pages, so it's bounded now that the context lives on.
+			// Each open PdfRes has its own, so it can hold up to FZ_STORE_DEFAULT (256 MB) plus MAX_PAGES display
+			// lists. The locks let the tile threads share the store and display lists through cloned contexts.
+			fz_locks_context locks;
+			locks.user	 = this;
+			locks.lock	 = lockFn;
+			locks.unlock = unlockFn;
+			if ((mCtx = fz_new_context(NULL, &locks, FZ_STORE_DEFAULT)) == nullptr) return false;
+
+			// This is pretty ugly because MuPDF uses custom C++-like error handing that
+			// has stringent rules, like you're not allowed to return.
+			fz_try(mCtx) {
+				fz_register_document_handlers(mCtx);
+				mDoc	   = fz_open_document(mCtx, file.c_str());
+				mPageCount = fz_count_pages(mCtx, mDoc);
+			}
+			fz_always(mCtx) {}
+			fz_catch(mCtx) {}
+			if (mDoc && mPageCount > 0) {
+				mFileName = file;
+				return true;
+			}
+		} catch (std::exception& ex) {
+			DS_LOG_WARNING("pdf_res.cpp::Document::open() exception=" << ex.what());
+		}
+		DS_LOG_WARNING("ds::ui::sprite::Pdf unable to load document \"" << file << "\".");
+		close();
+		return false;
+	}
+
+	void close() {
+		for (auto it = mPages.begin(), end = mPages.end(); it != end; ++it) {
+			fz_drop_display_list(mCtx, it->mList);
+		}
+		mPages.clear();
+		for (auto it = mClones.begin(), end = mClones.end(); it != end; ++it) {
+			fz_drop_context(*it);
+		}
+		mClones.clear();
+		try {
+			if (mDoc) {
+				fz_drop_document(mCtx, mDoc);
+			}
+		} catch (...) {}
+		try {
+			if (mCtx) {
+				fz_drop_context(mCtx);
+			}
+		} catch (...) {}
+		mDoc	   = nullptr;
+		mCtx	   = nullptr;
+		mPageCount = 0;
+		mFileName.clear();
+	}
+
+	/// Answers pageNum, interpreting it if it isn't cached, or null if it can't be loaded.
+	/// The page is good until the next call.
+	const Page* getPage(const int pageNum, bool* wasCached = nullptr) {
+		if (wasCached) *wasCached = false;
+		if (!mCtx || !mDoc || pageNum < 1 || pageNum > mPageCount) return nullptr;
+
+		for (auto it = mPages.begin(), end = mPages.end(); it != end; ++it) {
+			if (it->mPageNum != pageNum) continue;
+			mPages.splice(mPages.begin(), mPages, it);
+			if (wasCached) *wasCached = true;
+			return &mPages.front();
+		}
+
+		Page	 page;
+		fz_page* fzPage = nullptr;
+		fz_var(fzPage);
+		try {
+			fz_try(mCtx) {
+				fzPage			= fz_load_page(mCtx, mDoc, pageNum - 1);
+				const auto size = page_size(fz_bound_page(mCtx, fzPage));
+				if (size.x > 0 && size.y > 0) {
+					page.mPageNum = pageNum;
+					page.mSize	  = size;
+					page.mLinks	  = load_links(*mCtx, *fzPage, page.mSize);
+					page.mList	  = fz_new_display_list_from_page(mCtx, fzPage);
+				}
+			}
+			fz_always(mCtx) {
+				if (fzPage) fz_drop_page(mCtx, fzPage);
+			}
+			fz_catch(mCtx) {
+				DS_LOG_WARNING("PdfRes: unable to load page " << pageNum << " of \"" << mFileName
+															  << "\": " << fz_caught_message(mCtx));
+			}
+		} catch (std::exception const& e) {
+			DS_LOG_WARNING("Exception in PdfRes loading page: " << e.what());
+		}
+		if (!page.mList) return nullptr;
+
+		// Make room, least recently used first
+		while (mPages.size() >= MAX_PAGES) {
+			fz_drop_display_list(mCtx, mPages.back().mList);
+			mPages.pop_back();
+		}
+		mPages.push_front(page);
+		return &mPages.front();
+	}
+
+	/// The size of pageNum, from its bounds alone, so it's cheap enough for the main thread. Answers 0 x 0 if it
+	/// can't be loaded.
+	ci::ivec2 getPageSize(const int pageNum) {
+		if (!mCtx || !mDoc || pageNum < 1 || pageNum > mPageCount) return ci::ivec2(0, 0);
+
+		for (auto it = mPages.begin(), end = mPages.end(); it != end; ++it) {
+			if (it->mPageNum == pageNum) return it->mSize;
+		}
+
+		ci::ivec2 size(0, 0);
+		fz_page*  fzPage = nullptr;
+		fz_var(fzPage);
+		try {
+			fz_try(mCtx) {
+				fzPage = fz_load_page(mCtx, mDoc, pageNum - 1);
+				size   = page_size(fz_bound_page(mCtx, fzPage));
+			}
+			fz_always(mCtx) {
+				if (fzPage) fz_drop_page(mCtx, fzPage);
+			}
+			fz_catch(mCtx) {
+				DS_LOG_WARNING("PdfRes: unable to load page " << pageNum << " of \"" << mFileName
+															  << "\": " << fz_caught_message(mCtx));
+			}
+		} catch (std::exception const& e) {
+			DS_LOG_WARNING("Exception in PdfRes loading page: " << e.what());
+		}
+		return size;
+	}
+
+	/// Draws the w x h pixels at x, y of pageNum drawn at scale, on the calling thread. Don't hold mMutex.
+	bool drawTile(const int pageNum, const float scale, const int x, const int y, const int w, const int h,
+				  unsigned char* pixels) {
+		fz_context*		 ctx  = nullptr;
+		fz_display_list* list = nullptr;
+		{
+			std::lock_guard<std::mutex> l(mMutex);
+			const Page*					page = getPage(pageNum);
+			if (!page) return false;
+
+			if (mClones.empty()) {
+				ctx = fz_clone_context(mCtx);
+			} else {
+				ctx = mClones.back();
+				mClones.pop_back();
+			}
+			if (!ctx) return false;
+			list = fz_keep_display_list(mCtx, page->mList);
+		}
+
+		bool	   ans	  = false;
+		fz_pixmap* pixmap = nullptr;
+		fz_device* device = nullptr;
+		fz_var(pixmap);
+		fz_var(device);
+		try {
+			fz_try(ctx) {
+				pixmap = fz_new_pixmap_with_data(ctx, fz_device_rgb(ctx), w, h, nullptr, 0, w * 3, pixels);
+				fz_clear_pixmap_with_value(ctx, pixmap, 0xff);
+				device = fz_new_draw_device(ctx, fz_identity, pixmap);
+
+				// Only what falls in the tile gets drawn
+				const fz_matrix transform = fz_concat(fz_scale(scale, scale), fz_translate(-x, -y));
+				fz_run_display_list(ctx, list, device, transform, fz_make_rect(0, 0, w, h), nullptr);
+				fz_close_device(ctx, device);
+				ans = true;
+			}
+			fz_always(ctx) {
+				fz_drop_device(ctx, device);
+				fz_drop_pixmap(ctx, pixmap);
+				fz_drop_display_list(ctx, list);
+			}
+			fz_catch(ctx) {
+				DS_LOG_WARNING("PdfRes: render tile error: " << fz_caught_message(ctx));
+			}
+		} catch (std::exception const& e) {
+			DS_LOG_WARNING("Exception in PdfRes rendering tile: " << e.what());
+		}
+
+		std::lock_guard<std::mutex> l(mMutex);
+		mClones.push_back(ctx);
+		return ans;
+	}
+
+	static void lockFn(void* user, int lock) { static_cast<Document*>(user)->mLocks[lock].lock(); }
+	static void unlockFn(void* user, int lock) { static_cast<Document*>(user)->mLocks[lock].unlock(); }
+
+	std::mutex	 mMutex;
+	fz_context*	 mCtx;
+	fz_document* mDoc;
+	std::string	 mFileName;
+	int			 mPageCount;
+	/// Most recently used first
+	std::list<Page> mPages;
+	/// Contexts for the tile threads that aren't drawing right now
+	std::vector<fz_context*> mClones;
+	std::mutex				 mLocks[FZ_LOCK_MAX];
+};
+
+/* TILE QUEUE
+ * The tiles a PdfRes has asked the tile threads for.
+ ******************************************************************/
+struct PdfRes::TileQueue {
+	TileQueue()
+	  : mGeneration(0) {}
+
+	std::mutex mMutex;
+	/// Bumped when the page or zoom changes, so tiles nobody wants anymore are skipped
+	int							 mGeneration;
+	std::unordered_set<uint64_t> mPending;
+	std::vector<TileJob>		 mDone;
+};
 
 /**
  * \class ds::ui::sprite::PdfRes
@@ -274,23 +434,33 @@ namespace ds::pdf {
 ci::Surface8uRef PdfRes::renderPage(const std::string& path) {
 	ci::Surface8uRef s;
 
-	Examine	  examine;
-	Load	  load;
-	const int page_num = 1;
-	if (!load.run(examine, path, page_num)) return s;
-	if (examine.mWidth < 1 || examine.mHeight < 1) return s;
+	Document document;
+	if (!document.open(path)) return s;
+
+	const int	page_num = 1;
+	const Page* page	 = document.getPage(page_num);
+	if (!page) return s;
 
 	Pixels pixels;
-	pixels.setSize(examine.mWidth, examine.mHeight);
+	pixels.setSize(page->mSize.x, page->mSize.y);
 	Draw draw(pixels, 1.0f);
-	if (!load.run(draw, path, page_num)) return s;
+	if (!draw.run(*document.mCtx, *page)) return s;
 
-	return ci::Surface::create(pixels.mData, examine.mWidth, examine.mHeight, examine.mWidth * 3,
+	return ci::Surface::create(pixels.mData, page->mSize.x, page->mSize.y, page->mSize.x * 3,
 							   ci::SurfaceChannelOrder(ci::SurfaceChannelOrder::BGRA));
 }
 
-PdfRes::PdfRes(ds::GlThread& t)
-  : ds::GlThreadClient<PdfRes>(t)
+PdfRes::PdfRes(Service& service)
+  : ds::GlThreadClient<PdfRes>(service.mThread)
+  , mService(service)
+  , mTiled(false)
+  , mTileScale(1.0f)
+  , mTileLevel(0)
+  , mTilePage(0)
+  , mVisibleArea(0.0f, 0.0f, 1.0f, 1.0f)
+  , mTileBytes(0)
+  , mTileFrame(0)
+  , mTileQueue(std::make_shared<TileQueue>())
   , mPageCount(0)
   , mPixelsChanged(false)
   , mPrintedError(false) {
@@ -311,18 +481,32 @@ bool PdfRes::loadPDF(const std::string& fileName) {
 	mPrintedError = false;
 	// I'd really like to do this initial examine stuff in the
 	// worker thread, but I suspect the client is expecting this
-	// info to be valid as soon as this is called.
-	Examine examine;
-	Load	load;
-	if (load.run(examine, fileName, 1)) {
-		std::lock_guard<decltype(mMutex)> l(mMutex);
-		mFileName	   = fileName;
-		mState.mWidth  = examine.mWidth;
-		mState.mHeight = examine.mHeight;
-		mPageCount	   = examine.mPageCount;
-		return mPageCount > 0;
+	// info to be valid as soon as this is called. Only the first
+	// page's bounds are read here, the worker interprets it when
+	// it draws. The document stays open for the worker.
+	auto document = std::make_shared<Document>();
+	if (!document->open(fileName)) return false;
+
+	ci::ivec2 size(0, 0);
+	{
+		std::lock_guard<std::mutex> dl(document->mMutex);
+		size = document->getPageSize(1);
 	}
-	return false;
+	if (size.x < 1 || size.y < 1) return false;
+
+	mTiles.clear();
+	mTileCache.clear();
+	mTileIndex.clear();
+	mTileBytes = 0;
+
+	std::lock_guard<decltype(mMutex)> l(mMutex);
+	mDocument	   = document;
+	mFileName	   = fileName;
+	mState.mWidth  = size.x;
+	mState.mHeight = size.y;
+	mState.mScale  = getDrawScale(mTileScale);
+	mPageCount	   = document->mPageCount;
+	return mPageCount > 0;
 }
 
 void PdfRes::goToNextPage() {
@@ -386,10 +570,36 @@ ci::ivec2 PdfRes::getPageSize() const {
 }
 
 void PdfRes::setScale(const float theScale) {
-	if (mState.mScale == theScale) return;
+	mTileScale			  = theScale;
+	const float drawScale = getDrawScale(theScale);
+	if (mState.mScale == drawScale) return;
 
 	std::lock_guard<decltype(mMutex)> l(mMutex);
-	mState.mScale = theScale;
+	mState.mScale = drawScale;
+}
+
+float PdfRes::getDrawScale(const float theScale) const {
+	const int longest = std::max(mState.mWidth, mState.mHeight);
+	if (!mTiled || longest < 1) return theScale;
+	return std::min(theScale, static_cast<float>(mService.mTilePreviewSize) / static_cast<float>(longest));
+}
+
+void PdfRes::setTiled(const bool tiled) {
+	if (mTiled == tiled) return;
+	mTiled = tiled;
+	if (!mTiled) {
+		mTiles.clear();
+		mTileCache.clear();
+		mTileIndex.clear();
+		mTileBytes = 0;
+	}
+
+	std::lock_guard<decltype(mMutex)> l(mMutex);
+	mState.mScale = getDrawScale(mTileScale);
+}
+
+void PdfRes::setVisibleArea(const ci::Rectf& area) {
+	mVisibleArea = area;
 }
 
 bool PdfRes::update() {
@@ -428,9 +638,137 @@ bool PdfRes::update() {
 		mState.mLinks	 = mDrawState.mLinks;
 	}
 
+	// Get the pages on either side ready while nobody's looking
+	if (pixelsWereUpdated) {
+		performOnWorkerThread(&PdfRes::_prefetchPages, true);
+	}
+
+	updateTiles();
+
 	return pixelsWereUpdated;
 }
 
+void PdfRes::updateTiles() {
+	mTiles.clear();
+	if (!mTiled) return;
+	++mTileFrame;
+
+	std::vector<TileJob> done;
+	{
+		std::lock_guard<std::mutex> l(mTileQueue->mMutex);
+		done.swap(mTileQueue->mDone);
+	}
+	for (auto& job : done) {
+		if (mTileIndex.find(job.mKey) != mTileIndex.end()) continue;
+
+		auto surface = ci::Surface8u::create(job.mPixels.data(), job.mW, job.mH, job.mW * 3,
+											 ci::SurfaceChannelOrder::RGB);
+		CachedTile cached;
+		cached.mKey			  = job.mKey;
+		cached.mTile.mRect	  = job.mRect;
+		cached.mTile.mTexture = ci::gl::Texture2d::create(*surface);
+		cached.mBytes		  = static_cast<size_t>(job.mW * job.mH) * 4;
+		cached.mFrame		  = 0;
+		mTileCache.push_front(cached);
+		mTileIndex[job.mKey] = mTileCache.begin();
+		mTileBytes += cached.mBytes;
+	}
+
+	// Tiles wait for the page surface, so the whole page shows up blurry before parts of it get sharp
+	std::shared_ptr<Document> document;
+	int						  pageNum = 0;
+	ci::ivec2				  pageSize(0, 0);
+	{
+		std::lock_guard<decltype(mMutex)> l(mMutex);
+		if (mDrawState.mPageNum == mState.mPageNum) {
+			document = mDocument;
+			pageNum	 = mDrawState.mPageNum;
+			pageSize = mDrawState.mPageSize;
+		}
+	}
+
+	if (document && pageSize.x > 0 && pageSize.y > 0 && mTileScale > getDrawScale(mTileScale)) {
+		const int	level	   = static_cast<int>(ceilf(log2f(mTileScale) * TILE_LEVELS_PER_DOUBLING - 0.01f));
+		const float levelScale = powf(2.0f, static_cast<float>(level) / TILE_LEVELS_PER_DOUBLING);
+		const int	tileSize   = mService.mTileSize;
+		const int	pixelW	   = static_cast<int>(ceilf(pageSize.x * levelScale));
+		const int	pixelH	   = static_cast<int>(ceilf(pageSize.y * levelScale));
+		const int	cols	   = (pixelW + tileSize - 1) / tileSize;
+		const int	rows	   = (pixelH + tileSize - 1) / tileSize;
+
+		const ci::Rectf area = mVisibleArea.getClipBy(ci::Rectf(0.0f, 0.0f, 1.0f, 1.0f));
+		const int		col0 = std::max(0, static_cast<int>(floorf(area.x1 * pixelW / tileSize)));
+		const int		col1 = std::min(cols, static_cast<int>(ceilf(area.x2 * pixelW / tileSize)));
+		const int		row0 = std::max(0, static_cast<int>(floorf(area.y1 * pixelH / tileSize)));
+		const int		row1 = std::min(rows, static_cast<int>(ceilf(area.y2 * pixelH / tileSize)));
+
+		std::lock_guard<std::mutex> l(mTileQueue->mMutex);
+		if (level != mTileLevel || pageNum != mTilePage) {
+			mTileLevel = level;
+			mTilePage  = pageNum;
+			++mTileQueue->mGeneration;
+		}
+
+		for (int row = row0; row < row1; ++row) {
+			for (int col = col0; col < col1; ++col) {
+				const uint64_t key	 = tile_key(pageNum, level, col, row);
+				auto		   found = mTileIndex.find(key);
+				if (found != mTileIndex.end()) {
+					auto it = found->second;
+					mTileCache.splice(mTileCache.begin(), mTileCache, it);
+					it->mFrame = mTileFrame;
+					mTiles.push_back(it->mTile);
+					continue;
+				}
+				if (!mTileQueue->mPending.insert(key).second) continue;
+
+				TileJob job;
+				job.mKey		= key;
+				job.mGeneration = mTileQueue->mGeneration;
+				job.mPageNum	= pageNum;
+				job.mScale		= levelScale;
+				job.mX			= col * tileSize;
+				job.mY			= row * tileSize;
+				job.mW			= std::min(tileSize, pixelW - job.mX);
+				job.mH			= std::min(tileSize, pixelH - job.mY);
+				job.mRect		= ci::Rectf(job.mX / levelScale, job.mY / levelScale, (job.mX + job.mW) / levelScale,
+											(job.mY + job.mH) / levelScale);
+
+				auto queue = mTileQueue;
+				mService.queueTileWork([document, queue, job]() mutable {
+					{
+						std::lock_guard<std::mutex> l(queue->mMutex);
+						// The page or zoom has moved on since this was asked for
+						if (job.mGeneration != queue->mGeneration) {
+							queue->mPending.erase(job.mKey);
+							return;
+						}
+					}
+
+					job.mPixels.resize(static_cast<size_t>(job.mW * job.mH) * 3);
+					const bool drawn = document->drawTile(job.mPageNum, job.mScale, job.mX, job.mY, job.mW, job.mH,
+														  job.mPixels.data());
+
+					std::lock_guard<std::mutex> l(queue->mMutex);
+					queue->mPending.erase(job.mKey);
+					if (drawn) queue->mDone.push_back(std::move(job));
+				});
+			}
+		}
+	}
+
+	// Make room, least recently used first, but never what's on screen
+	auto it = mTileCache.end();
+	while (mTileBytes > mService.mTileCacheBytes && it != mTileCache.begin()) {
+		--it;
+		if (it->mFrame == mTileFrame) continue;
+
+		mTileBytes -= it->mBytes;
+		mTileIndex.erase(it->mKey);
+		it = mTileCache.erase(it);
+	}
+}
+
 bool PdfRes::needsUpdate() {
 	std::lock_guard<decltype(mMutex)> l(mMutex);
 	if (mPageCount < 1) return false;
@@ -439,9 +777,10 @@ bool PdfRes::needsUpdate() {
 
 void PdfRes::_redrawPage() {
 	// Pop out the pieces we need
-	bool		printedError;
-	state		drawState;
-	std::string fn;
+	bool					  printedError;
+	state					  drawState;
+	std::string				  fn;
+	std::shared_ptr<Document> document;
 	{
 		std::lock_guard<decltype(mMutex)> l(mMutex);
 
@@ -466,6 +805,7 @@ void PdfRes::_redrawPage() {
 		}
 		drawState = mState;
 		fn		  = mFileName;
+		document  = mDocument;
 		// Prevent the main thread from loading the pixels while
 		// I'll be modifying them.
 		mPixelsChanged = false;
@@ -505,15 +845,18 @@ void PdfRes::_redrawPage() {
 	}
 
 	// Render to the texture
-	Draw draw(mPixels, drawState.mScale);
-	Load load;
-
-	if (drawState.mScale < 0.0f) {
-		DS_LOG_WARNING("Something terrible happened with the drawing scale for your pdf!");
-		return;
+	const auto startTime = std::chrono::steady_clock::now();
+	Draw	   draw(mPixels, drawState.mScale);
+	bool	   wasCached = false;
+	bool	   drawn	 = false;
+	if (document) {
+		std::lock_guard<std::mutex> dl(document->mMutex);
+		if (const Page* page = document->getPage(drawState.mPageNum, &wasCached)) {
+			drawn = draw.run(*document->mCtx, *page);
+		}
 	}
 
-	if (!load.run(draw, fn, drawState.mPageNum)) {
+	if (!drawn) {
 		if (!printedError) {
 			DS_LOG_WARNING("ds::pdf::PdfRes unable to rasterize document \"" << fn << "\".");
 			std::lock_guard<decltype(mMutex)> l(mMutex);
@@ -524,6 +867,11 @@ void PdfRes::_redrawPage() {
 	drawState.mPageSize = draw.getPageSize();
 	drawState.mLinks	= draw.mLinks;
 
+	const auto drawMs =
+		std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - startTime).count();
+	DS_LOG_VERBOSE(3, "PdfRes drew page " << drawState.mPageNum << " of \"" << fn << "\" at scale " << drawState.mScale
+										  << " in " << drawMs << "ms, " << (wasCached ? "cached" : "interpreted"));
+
 	std::lock_guard<decltype(mMutex)> l(mMutex);
 	mPixelsChanged = true;
 	mDrawState	   = drawState;
@@ -531,6 +879,29 @@ void PdfRes::_redrawPage() {
 	if (mDrawFileName != fn) mDrawFileName = fn;
 }
 
+void PdfRes::_prefetchPages() {
+	std::shared_ptr<Document> document;
+	int						  pageNum	= 0;
+	int						  pageCount = 0;
+	{
+		std::lock_guard<decltype(mMutex)> l(mMutex);
+		document  = mDocument;
+		pageNum	  = mDrawState.mPageNum;
+		pageCount = mPageCount;
+	}
+	if (!document || pageCount < 2) return;
+
+	// Next page first, it's the usual way to go. These wrap around like goToNextPage() and goToPreviousPage().
+	const int neighbours[] = {pageNum < pageCount ? pageNum + 1 : 1, pageNum > 1 ? pageNum - 1 : pageCount};
+	for (const int neighbour : neighbours) {
+		// Someone's turned the page already, don't hold up drawing it
+		if (needsUpdate()) return;
+
+		std::lock_guard<std::mutex> dl(document->mMutex);
+		document->getPage(neighbour);
+	}
+}
+
 /**
  * \class ds::ui::sprite::Pdf::state
  */
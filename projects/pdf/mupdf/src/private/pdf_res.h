@@ -1,7 +1,11 @@
 #ifndef PRIVATE_PDFRES_H_
 #define PRIVATE_PDFRES_H_
 
+#include <cstdint>
+#include <list>
+#include <memory>
 #include <mutex>
+#include <unordered_map>
 
 #include <cinder/Surface.h>
 #include <cinder/gl/Texture.h>
@@ -11,6 +15,7 @@
 #include <ds/ui/sprite/pdf_link.h>
 
 namespace ds::pdf {
+class Service;
 
 /**
  * \class ds::ui::sprite::PdfRes
@@ -20,7 +25,7 @@ class PdfRes : public ds::GlThreadClient<PdfRes> {
 	// Utility to get a render of the first page of a PDF.
 	static ci::Surface8uRef renderPage(const std::string& path);
 
-	PdfRes(ds::GlThread&);
+	PdfRes(Service&);
 	// Clients should never delete this class, instead schedule it for deletion and consider it invalid.
 	void scheduleDestructor();
 
@@ -64,12 +69,42 @@ class PdfRes : public ds::GlThreadClient<PdfRes> {
 	void	  goToPreviousPage();
 	void	  setScale(const float theScale);
 
+	/// Part of the page drawn sharper than the page surface, in page units
+	struct Tile {
+		ci::Rectf		   mRect;
+		ci::gl::TextureRef mTexture;
+	};
+
+	/// In tiled mode the page surface is capped at the service's preview size, and once zoomed in past that the
+	/// visible area is drawn sharp in tiles on the service's tile threads
+	void setTiled(const bool tiled);
+	bool getTiled() const { return mTiled; }
+	/// The part of the page on screen, from 0 to 1
+	void setVisibleArea(const ci::Rectf& area);
+	/// The tiles of the visible area that are ready, to draw over the page surface
+	const std::vector<Tile>& getTiles() const { return mTiles; }
+
   protected:
 	// worker thread calls
 	void _destructor();
 	void _redrawPage();
+	/// Interprets the pages next to the one just drawn, so turning to them only costs the rasterizing
+	void _prefetchPages();
 
   private:
+	struct Document;
+	struct TileQueue;
+
+	struct CachedTile {
+		uint64_t mKey;
+		Tile	 mTile;
+		size_t	 mBytes;
+		/// The last update the tile was on screen
+		uint64_t mFrame;
+	};
+	typedef std::list<CachedTile> TileList;
+	typedef std::unordered_map<uint64_t, TileList::iterator> TileIndex;
+
 	struct state {
 		state();
 		bool operator==(const state&);
@@ -83,13 +118,29 @@ class PdfRes : public ds::GlThreadClient<PdfRes> {
 	};
 
 	bool needsUpdate();
+	/// The scale the page surface is drawn at for a scale of theScale
+	float getDrawScale(const float theScale) const;
+	/// Uploads finished tiles and asks for the missing ones on screen
+	void updateTiles();
 
+	Service&		   mService;
 	mutable std::mutex mMutex;
 
 	// MAIN THREAD
 	ci::Surface8uRef mSurface;
 	Pixels			 mSurfacePixels;
 
+	bool					   mTiled;
+	float					   mTileScale; // The scale asked for, mState has the one drawn
+	int						   mTileLevel, mTilePage;
+	ci::Rectf				   mVisibleArea;
+	std::vector<Tile>		   mTiles;
+	TileList				   mTileCache; // Most recently used first
+	TileIndex				   mTileIndex;
+	size_t					   mTileBytes;
+	uint64_t				   mTileFrame;
+	std::shared_ptr<TileQueue> mTileQueue; // Shared with the tile threads
+
 	// WORKER THREAD
 
 	// SHARED
@@ -102,6 +153,8 @@ class PdfRes : public ds::GlThreadClient<PdfRes> {
 							   // read by the worker thread, so it's safe to read it in the main without a lock.
 	state		mDrawState;	   // Store the state used to generate the current active texture
 	std::string mDrawFileName; // Store so I can avoid redrawing duplicate pages
+	// The open document, shared with the worker so it stays open between draws.
+	std::shared_ptr<Document> mDocument;
 
 	bool mPrintedError; // to prevent a ton of warnings flooding the output
 };
@@ -2,6 +2,8 @@
 
 #include "private/pdf_service.h"
 
+#include <algorithm>
+
 #include <ds/app/engine/engine.h>
 #include <ds/ui/sprite/pdf.h>
 #include <ds/util/file_meta_data.h>
@@ -9,7 +11,15 @@
 namespace ds::pdf {
 
 Service::Service(ds::Engine& engine)
-  : mEngine(engine) {
+  : mEngine(engine)
+  , mTileQuit(false) {
+	auto&		 settings  = engine.getEngineSettings();
+	const size_t megabytes = std::max(1, settings.getInt("pdf:tile_cache_megabytes", 0, 256));
+	mTiledDefault		   = settings.getBool("pdf:tiled_render", 0, false);
+	mTilePreviewSize	   = std::max(256, settings.getInt("pdf:tile_preview_size", 0, 2048));
+	mTileSize			   = std::max(64, settings.getInt("pdf:tile_size", 0, 512));
+	mTileCacheBytes		   = megabytes * 1024 * 1024;
+
 	mEngine.registerSpriteImporter(
 		"pdf", [this](ds::ui::SpriteEngine& engine) -> ds::ui::Sprite* { return new ds::ui::Pdf(mEngine); });
 
@@ -27,6 +37,7 @@ Service::Service(ds::Engine& engine)
 }
 
 Service::~Service() {
+	stopTileThreads();
 	mThread.waitForNoInput();
 }
 
@@ -34,4 +45,49 @@ void Service::start() {
 	mThread.start(false);
 }
 
+void Service::queueTileWork(const std::function<void()>& work) {
+	if (!work) return;
+
+	std::lock_guard<std::mutex> lock(mTileMutex);
+	if (mTileThreads.empty()) {
+		const int numThreads = std::max(1, mEngine.getEngineSettings().getInt("pdf:tile_threads", 0, 2));
+		for (int i = 0; i < numThreads; ++i) {
+			mTileThreads.emplace_back([this] { tileThreadFn(); });
+		}
+	}
+
+	mTileWork.push_back(work);
+	mTileCondition.notify_one();
+}
+
+void Service::tileThreadFn() {
+	while (true) {
+		std::function<void()> work;
+		{
+			std::unique_lock<std::mutex> lock(mTileMutex);
+			mTileCondition.wait(lock, [this] { return mTileQuit || !mTileWork.empty(); });
+			if (mTileQuit) break;
+
+			work = std::move(mTileWork.front());
+			mTileWork.pop_front();
+		}
+
+		work();
+	}
+}
+
+void Service::stopTileThreads() {
+	{
+		std::lock_guard<std::mutex> lock(mTileMutex);
+		mTileQuit = true;
+		mTileWork.clear();
+	}
+	mTileCondition.notify_all();
+
+	for (auto& thread : mTileThreads) {
+		if (thread.joinable()) thread.join();
+	}
+	mTileThreads.clear();
+}
+
 } // namespace ds::pdf
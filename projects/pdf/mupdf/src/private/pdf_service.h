@@ -2,6 +2,13 @@
 #ifndef PRIVATE_PDFSERVICE_H_
 #define PRIVATE_PDFSERVICE_H_
 
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
 #include <ds/app/engine/engine_service.h>
 #include <ds/thread/gl_thread.h>
 
@@ -14,7 +21,7 @@ namespace ds::pdf {
 /**
  * \class ds::pdf::PdfService
  * \brief The engine service object that provides access to the
- * PDF rendering thread.
+ * PDF rendering thread, and the threads that draw tiles of zoomed in pages.
  */
 class Service : public ds::EngineService {
   public:
@@ -23,9 +30,28 @@ class Service : public ds::EngineService {
 
 	virtual void start();
 
+	/// Run work on one of the tile threads, starting them the first time
+	void queueTileWork(const std::function<void()>& work);
+
 	ds::Engine& mEngine;
 
 	GlThread mThread;
+
+	/// Tiled rendering settings, see the pdf: engine settings
+	bool   mTiledDefault;
+	int	   mTilePreviewSize;
+	int	   mTileSize;
+	size_t mTileCacheBytes;
+
+  private:
+	void tileThreadFn();
+	void stopTileThreads();
+
+	std::vector<std::thread>		  mTileThreads;
+	std::mutex						  mTileMutex;
+	std::condition_variable			  mTileCondition;
+	std::deque<std::function<void()>> mTileWork;
+	bool							  mTileQuit;
 };
 
 } // namespace ds::pdf
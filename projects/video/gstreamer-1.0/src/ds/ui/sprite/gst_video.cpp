@@ -22,6 +22,7 @@
 #include <ds/util/float_util.h>
 
 #include "gstreamer/gstreamer_wrapper.h"
+#include "gstreamer/shared_video_source.h"
 #include "gstreamer/video_meta_cache.h"
 #include "private/gst_video_service.h"
 
@@ -29,6 +30,7 @@
 
 #include <gst/net/gstnettimeprovider.h>
 
+#include <algorithm>
 #include <mutex>
 
 #include <ds/network/network_info.h>
@@ -172,6 +174,7 @@ void GstVideo::installAsClient(ds::BlobRegistry& registry) {
 GstVideo::GstVideo(SpriteEngine& engine)
   : Sprite(engine)
   , mGstreamerWrapper(new gstwrapper::GStreamerWrapper())
+  , mSharedBranch(-1)
   , mColorType(kColorTypeTransparent)
   , mVideoSize(0, 0)
   , mCachedDuration(0)
@@ -207,11 +210,14 @@ GstVideo::GstVideo(SpriteEngine& engine)
   , mSeekTime(0)
   , mNetPort(-1)
   , mDoSyncronization(true) {
+	setWantsUpdates(true);
 	mLayoutFixedAspect = true;
 	mBlobType		   = BLOB_TYPE;
 
 	mEngineMuted = mEngine.getMute();
 
+	setZeroCopy(mEngine.getEngineSettings().getBool("video:zero_copy", 0, false));
+
 	// Prevent a race condition that could set the net clock before we get all the attributes.
 	if (mEngine.getMode() == ds::ui::SpriteEngine::CLIENT_MODE) {
 		mDoSyncronization = false;
@@ -344,6 +350,19 @@ void GstVideo::updateVideoTexture() {
 		return;
 	}
 
+	// Whichever sharing sprite updates first uploads the frame for all of them
+	if (mSharedSource) {
+		mSharedSource->update();
+		auto texture = mSharedSource->getTexture(mSharedBranch);
+		if (texture) {
+			mFrameTexture = texture;
+			mDrawable	  = true;
+		}
+		return;
+	}
+
+	mGstreamerWrapper->getFrameTiming().tick();
+
 	if (mGstreamerWrapper->hasVideo() && mGstreamerWrapper->isNewVideoFrame()) {
 
 		if (mGstreamerWrapper->getWidth() != mVideoSize.x) {
@@ -359,6 +378,7 @@ void GstVideo::updateVideoTexture() {
 				if (mFrameTexture && mFrameTexture->getWidth() > 0) {
 					mDrawable		  = true;
 					mNeedsBatchUpdate = true;
+					mGstreamerWrapper->frameUploaded();
 				}
 
 			} else {
@@ -375,7 +395,11 @@ void GstVideo::updateVideoTexture() {
 
 				unsigned char* dat = nullptr;
 
-				dat = mGstreamerWrapper->getVideo();
+				if (mZeroCopy) {
+					dat = mGstreamerWrapper->lockVideoFrame();
+				} else {
+					dat = mGstreamerWrapper->getVideo();
+				}
 
 				if (dat && mFrameTexture) {
 					if (mColorType == kColorTypeShaderTransform) {
@@ -399,7 +423,10 @@ void GstVideo::updateVideoTexture() {
 					}
 
 					mDrawable = true;
+					mGstreamerWrapper->frameUploaded();
 				}
+
+				if (mZeroCopy) mGstreamerWrapper->unlockVideoFrame();
 			}
 
 			if (mPlaySingleFrame) {
@@ -497,6 +524,25 @@ void GstVideo::setNVDecode(const bool nvDecode) {
 	mNVDecode = nvDecode;
 }
 
+void GstVideo::setZeroCopy(const bool zeroCopy) {
+	mGstreamerWrapper->setZeroCopy(zeroCopy);
+	mZeroCopy = zeroCopy;
+}
+
+gstwrapper::VideoFrameStats GstVideo::getFrameStats() {
+	if (mSharedSource) return mSharedSource->getFrameStats(mSharedBranch);
+	return mGstreamerWrapper->getFrameStats();
+}
+
+const gstwrapper::VideoFrameTiming& GstVideo::getFrameTiming() {
+	return mGstreamerWrapper->getFrameTiming();
+}
+
+void GstVideo::dumpFrameTiming(std::ostream& out, const bool withFrames) {
+	out << "GstVideo " << mFilename << "\n";
+	mGstreamerWrapper->getFrameTiming().dump(out, withFrames);
+}
+
 GstVideo& GstVideo::loadVideo(const std::string& filename) {
 	const std::string _filename = (ds::Environment::expand(filename));
 
@@ -521,6 +567,73 @@ GstVideo& GstVideo::loadVideoUrl(const std::string& filename) {
 	return *this;
 }
 
+GstVideo& GstVideo::loadSharedVideo(const std::string& filename, const ci::ivec2& maxSize) {
+	const std::string _filename = (ds::Environment::expand(filename));
+
+	if (_filename.empty()) {
+		DS_LOG_WARNING_M("GstVideo::loadSharedVideo received a blank filename. Cancelling load.", GSTREAMER_LOG);
+		return *this;
+	}
+
+	unloadVideo(true);
+	mStreaming = false;
+
+	VideoMetaCache::Type type(VideoMetaCache::ERROR_TYPE);
+	int					 videoWidth	 = 0;
+	int					 videoHeight = 0;
+	std::string			 colorSpace;
+	CACHE.getValues(_filename, type, videoWidth, videoHeight, mCachedDuration, colorSpace);
+
+	mFilename		  = _filename;
+	mPortableFilename = filename;
+	markAsDirty(mPathDirty);
+
+	if (type == VideoMetaCache::AUDIO_ONLY_TYPE || videoWidth < 1 || videoHeight < 1) {
+		DS_LOG_WARNING_M("GstVideo::loadSharedVideo() no video to share in " << _filename, GSTREAMER_LOG);
+		if (mErrorFn) mErrorFn("Did not load a shared video because there was no video in the file.");
+		return *this;
+	}
+
+	mVideoSize.x = videoWidth;
+	mVideoSize.y = videoHeight;
+	Sprite::setSizeAll(static_cast<float>(videoWidth), static_cast<float>(videoHeight), mDepth);
+
+	if (!thisInstancePlayable()) {
+		setStatus(Status::STATUS_PLAYING);
+		mServerOnlyMode = true;
+		return *this;
+	}
+	mServerOnlyMode = false;
+
+	auto& videoService = mEngine.getService<ds::gstreamer::GstVideoService>("gst_video");
+	mSharedSource	   = videoService.acquireSharedSource(_filename);
+	if (!mSharedSource) {
+		if (mErrorFn) mErrorFn("Could not start a shared video for " + _filename);
+		return *this;
+	}
+
+	// Fit inside maxSize, keeping the aspect and even sizes for the scaler
+	int branchWidth	 = 0;
+	int branchHeight = 0;
+	if (maxSize.x > 0 && maxSize.y > 0 && (maxSize.x < videoWidth || maxSize.y < videoHeight)) {
+		const float scale = std::min(static_cast<float>(maxSize.x) / static_cast<float>(videoWidth),
+									 static_cast<float>(maxSize.y) / static_cast<float>(videoHeight));
+		branchWidth		  = std::max(2, static_cast<int>(static_cast<float>(videoWidth) * scale) & ~1);
+		branchHeight	  = std::max(2, static_cast<int>(static_cast<float>(videoHeight) * scale) & ~1);
+	}
+	mSharedBranch = mSharedSource->getBranch(branchWidth, branchHeight);
+
+	mColorType = ColorType::kColorTypeTransparent;
+	setBaseShader(Environment::getAppFolder("data/shaders"), "base");
+	mNeedsBatchUpdate = true;
+	mDrawable		  = false;
+
+	DS_LOG_INFO_M("GstVideo::loadSharedVideo() " << _filename << " at " << branchWidth << "x" << branchHeight,
+				  GSTREAMER_LOG);
+	setStatus(Status::STATUS_PLAYING);
+	return *this;
+}
+
 GstVideo& GstVideo::setResourceId(const ds::Resource::Id& resourceId) {
 	try {
 		ds::Resource res;
@@ -595,6 +708,8 @@ void GstVideo::doLoadVideo(const std::string& filename, const std::string& porta
 		}
 	}
 
+	// A video loaded the usual way gets a player of its own
+	mSharedSource.reset();
 	mStreaming = false;
 
 	// This allows apps to only load videos on certain client instances
@@ -741,6 +856,7 @@ void GstVideo::startStream(const std::string& streamingPipeline, const float vid
 
 	setBaseShader(Environment::getAppFolder("data/shaders"), "base");
 
+	mSharedSource.reset();
 	mDrawable		  = false;
 	mStreaming		  = true;
 	mFilename		  = streamingPipeline;
@@ -823,6 +939,7 @@ void GstVideo::parseLaunch(const std::string& fullPipeline, const int videoWidth
 		}
 	}
 
+	mSharedSource.reset();
 	mStreaming		  = false;
 	mNeedsBatchUpdate = true;
 	mDrawable		  = false;
@@ -1041,6 +1158,9 @@ void GstVideo::setStatus(const int code) {
 	mStatus.mCode  = code;
 	mStatusChanged = true;
 
+	// Waiting while paused or loading isn't a repeated frame
+	mGstreamerWrapper->getFrameTiming().breakContinuity();
+
 	markAsDirty(mStatusDirty);
 }
 
@@ -1075,6 +1195,8 @@ void GstVideo::setStreamingLatency(const uint64_t latencyNs) {
 void GstVideo::unloadVideo(const bool clearFrame) {
 	mGstreamerWrapper->stop();
 	mGstreamerWrapper->close();
+	mSharedSource.reset();
+	mSharedBranch = -1;
 	mFilename.clear();
 
 	if (clearFrame) {
@@ -8,10 +8,16 @@
 
 #include <Poco/Timestamp.h>
 
+#include <memory>
+#include <ostream>
+
 #include "gstreamer/gstreamer_audio_device.h"
 
 namespace gstwrapper {
 class GStreamerWrapper;
+struct VideoFrameStats;
+class VideoFrameTiming;
+class SharedVideoSource;
 }
 
 namespace ds::ui {
@@ -78,6 +84,22 @@ class GstVideo : public Sprite {
 	void setNVDecode(const bool nvDecode);
 	bool isNVDecode() { return mNVDecode; }
 
+	/// If true, decoded frames are uploaded straight from GStreamer's buffers instead of being copied into a buffer
+	/// of our own on the streaming thread first. Frames the sprite didn't get to before the next one decoded are
+	/// dropped. Doesn't apply to OpenGL mode, and getRawVideoData() isn't updated in this mode.
+	/// Default is the video:zero_copy engine setting. Must be set before loading the video
+	void setZeroCopy(const bool zeroCopy);
+	bool isZeroCopy() { return mZeroCopy; }
+
+	/// Counts of decoded, uploaded, dropped and late frames and copied bytes since the video was loaded
+	gstwrapper::VideoFrameStats getFrameStats();
+
+	/// When each frame shown was decoded, presented, uploaded and shown, with histograms of decode to display latency,
+	/// drops and repeats. Pauses and status changes don't count as repeats
+	const gstwrapper::VideoFrameTiming& getFrameTiming();
+	/// Writes the frame timing histograms, and with withFrames a csv line for each recent frame
+	void dumpFrameTiming(std::ostream& out, const bool withFrames = false);
+
 	// Loads a video from a file path.
 	GstVideo& loadVideo(const std::string& filename);
 	// Loads a video from a url.
@@ -87,6 +109,13 @@ class GstVideo : public Sprite {
 	// Loads a vodeo from a ds::Resource
 	virtual void setResource(const ds::Resource& resource) override;
 
+	/// Shows a video file from a decoder shared with every other GstVideo showing it shared, instead of opening a
+	/// player of its own, so the same loop in several places only decodes once. Shared videos loop, have no audio and
+	/// ignore play, pause and seek. The frames are scaled down on the streaming thread to fit maxSize, 0 x 0 is the
+	/// video's own size, and the sprite keeps the video's size either way. Clients load the video the usual way
+	GstVideo& loadSharedVideo(const std::string& filename, const ci::ivec2& maxSize = ci::ivec2(0, 0));
+	bool	  getIsShared() const { return mSharedSource != nullptr; }
+
 	/// If video streaming fails, will automatically try to reconnect (default=true)
 	void setAutoRestartStream(bool autoRestart);
 
@@ -268,6 +297,9 @@ class GstVideo : public Sprite {
 
 	gstwrapper::GStreamerWrapper* mGstreamerWrapper;
 
+	std::shared_ptr<gstwrapper::SharedVideoSource> mSharedSource;
+	int											   mSharedBranch;
+
   private:
 	// filename is the absolute path to the file.
 	// portable_filename is the CMS-relative path, so apps installed under different
@@ -284,6 +316,7 @@ class GstVideo : public Sprite {
 
 	bool	  mOpenGlMode = false;
 	bool	  mNVDecode	  = false;
+	bool	  mZeroCopy	  = false;
 	ColorType mColorType;
 
 	ci::gl::TextureRef mFrameTexture;
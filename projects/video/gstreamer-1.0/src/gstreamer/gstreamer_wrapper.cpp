@@ -30,6 +30,8 @@ GStreamerWrapper::GStreamerWrapper()
   , mFileIsOpen(false)
   , mVideoBuffer(NULL)
   , mVideoBufferSize(0)
+  , mZeroCopy(false)
+  , mMappedBuffer(NULL)
   , mGstVideoSink(NULL)
   , mStartPlaying(true)
   , mCustomPipeline(false)
@@ -101,6 +103,14 @@ void GStreamerWrapper::resetProperties() {
 	mSyncedMode			= false;
 	mStreamNeedsRestart = false;
 	mStreamingLatency	= 200000000;
+	mFramesDecoded		= 0;
+	mFramesUploaded		= 0;
+	mFramesDropped		= 0;
+	mFramesLate			= 0;
+	mBytesCopied		= 0;
+	mNewFrameInfo		= VideoFrameInfo();
+	mShownFrameInfo		= VideoFrameInfo();
+	mFrameTiming.reset();
 }
 
 void GStreamerWrapper::parseFilename(const std::string& theFile) {
@@ -958,6 +968,9 @@ void GStreamerWrapper::close() {
 		mGstPanorama  = NULL;
 		mGstBus		  = NULL;
 
+		unlockVideoFrame();
+		mVideoSamples.clear();
+
 		delete[] mVideoBuffer;
 		mVideoBuffer = NULL;
 
@@ -1201,8 +1214,67 @@ void GStreamerWrapper::setNVDecode(const bool nvDecode) {
 	mNVDecode = nvDecode;
 }
 
+void GStreamerWrapper::setZeroCopy(const bool zeroCopy) {
+	mZeroCopy = zeroCopy;
+}
+
+unsigned char* GStreamerWrapper::lockVideoFrame() {
+	if (!mZeroCopy || mGlMode) return nullptr;
+
+	// Whatever was mapped last time goes back to the decoder first
+	unlockVideoFrame();
+
+	GstSample* sample = mVideoSamples.acquire(&mShownFrameInfo);
+	if (!sample) return nullptr;
+	mIsNewVideoFrame = false;
+
+	GstBuffer* buff = gst_sample_get_buffer(sample);
+	if (!buff || !gst_buffer_map(buff, &mMappedInfo, GST_MAP_READ)) {
+		mVideoSamples.release();
+		return nullptr;
+	}
+
+	// sanity check on buffer size, in case something weird happened.
+	if (mMappedInfo.size < mVideoBufferSize) {
+		DS_LOG_WARNING("Unexpected buffer size returned!");
+		gst_buffer_unmap(buff, &mMappedInfo);
+		mVideoSamples.release();
+		return nullptr;
+	}
+
+	mMappedBuffer = buff;
+	mFramesUploaded++;
+	return mMappedInfo.data;
+}
+
+void GStreamerWrapper::unlockVideoFrame() {
+	if (!mMappedBuffer) return;
+
+	gst_buffer_unmap(mMappedBuffer, &mMappedInfo);
+	mMappedBuffer = NULL;
+	mVideoSamples.release();
+}
+
+VideoFrameStats GStreamerWrapper::getFrameStats() const {
+	VideoFrameStats stats;
+	stats.mFramesDecoded  = mFramesDecoded;
+	stats.mFramesUploaded = mFramesUploaded;
+	stats.mFramesDropped  = mFramesDropped;
+	stats.mFramesLate	  = mFramesLate;
+	stats.mBytesCopied	  = mBytesCopied;
+	return stats;
+}
+
+void GStreamerWrapper::frameUploaded() {
+	mFrameTiming.frameShown(mShownFrameInfo);
+}
+
 unsigned char* GStreamerWrapper::getVideo() {
 	std::lock_guard<std::mutex> lock(mVideoMutex);
+	if (mIsNewVideoFrame) {
+		mFramesUploaded++;
+		mShownFrameInfo = mNewFrameInfo;
+	}
 	mIsNewVideoFrame = false;
 	return mVideoBuffer;
 }
@@ -1212,6 +1284,7 @@ ci::gl::Texture2dRef GStreamerWrapper::getVideoTexture() {
 		{
 			std::lock_guard<std::mutex> guard(mVideoMutex);
 			std::swap(mCurrentBuffer, mNewBuffer);
+			mShownFrameInfo = mNewFrameInfo;
 		}
 
 		GLint	   id  = 0;
@@ -1806,12 +1879,20 @@ GstFlowReturn GStreamerWrapper::onNewBufferFromAudioSource(GstAppSink* appsink,
 	return GST_FLOW_OK;
 }
 
-void GStreamerWrapper::handleVideoBuffer(GstSample* videoSinkSample) {
+void GStreamerWrapper::handleVideoBuffer(GstSample* videoSinkSample, const VideoFrameInfo& info) {
 	std::lock_guard<std::mutex> lock(mVideoMutex);
 
 	if (mGlMode) {
 		mNewBuffer =
 			std::shared_ptr<GstBuffer>(gst_buffer_ref(gst_sample_get_buffer(videoSinkSample)), &gst_buffer_unref);
+		mNewFrameInfo = info;
+		if (!mPendingSeek) mIsNewVideoFrame = true;
+		return;
+	}
+
+	// Hand the sample itself to the main thread, which maps it for the texture upload
+	if (mZeroCopy) {
+		if (!mVideoSamples.publish(videoSinkSample, info)) mFramesDropped++;
 		if (!mPendingSeek) mIsNewVideoFrame = true;
 		return;
 	}
@@ -1820,11 +1901,11 @@ void GStreamerWrapper::handleVideoBuffer(GstSample* videoSinkSample) {
 
 	if (!mVideoBuffer) return;
 
-	GstVideoInfo info;
+	GstVideoInfo capsInfo;
 	GstCaps*	 currentCaps = gst_sample_get_caps(videoSinkSample);
-	gboolean	 success	 = gst_video_info_from_caps(&info, currentCaps);
-	if (success && (info.width != mWidth || info.height != mHeight)) {
-		DS_LOG_WARNING("RUH ROH! " << mWidth << " " << info.width);
+	gboolean	 success	 = gst_video_info_from_caps(&capsInfo, currentCaps);
+	if (success && (capsInfo.width != mWidth || capsInfo.height != mHeight)) {
+		DS_LOG_WARNING("RUH ROH! " << mWidth << " " << capsInfo.width);
 	}
 
 	GstBuffer* buff = gst_sample_get_buffer(videoSinkSample);
@@ -1850,18 +1931,57 @@ void GStreamerWrapper::handleVideoBuffer(GstSample* videoSinkSample) {
 
 	if (!errored) {
 		memcpy((unsigned char*)mVideoBuffer, map.data, videoBufferSize);
-		gst_buffer_unmap(buff, &map);
+		mBytesCopied += videoBufferSize;
+		mNewFrameInfo = info;
 
+		// The main thread never got to the last one
+		if (mIsNewVideoFrame) mFramesDropped++;
 		if (!mPendingSeek) mIsNewVideoFrame = true;
 	}
+
+	gst_buffer_unmap(buff, &map);
+}
+
+VideoFrameInfo GStreamerWrapper::getFrameInfo(GstSample* videoSinkSample, const uint64_t sequence) {
+	VideoFrameInfo info;
+	info.mSequence	 = sequence;
+	info.mDecodeTime = g_get_monotonic_time();
+
+	GstBuffer*	buff	= gst_sample_get_buffer(videoSinkSample);
+	GstSegment* segment = gst_sample_get_segment(videoSinkSample);
+	if (buff && segment && GST_BUFFER_PTS_IS_VALID(buff)) {
+		const guint64 runningTime = gst_segment_to_running_time(segment, GST_FORMAT_TIME, GST_BUFFER_PTS(buff));
+		if (GST_CLOCK_TIME_IS_VALID(runningTime)) info.mPresentationTime = static_cast<int64_t>(runningTime);
+	}
+	return info;
+}
+
+bool GStreamerWrapper::isSampleLate(GstSample* videoSinkSample, const VideoFrameInfo& info) {
+	GstBuffer* buff = gst_sample_get_buffer(videoSinkSample);
+	if (!mGstPipeline || !buff || info.mPresentationTime < 0) return false;
+
+	guint64 presentTime = static_cast<guint64>(info.mPresentationTime);
+	if (GST_BUFFER_DURATION_IS_VALID(buff)) presentTime += GST_BUFFER_DURATION(buff);
+
+	GstClock* clock = gst_element_get_clock(mGstPipeline);
+	if (!clock) return false;
+	const guint64 now = gst_clock_get_time(clock);
+	gst_object_unref(clock);
+
+	const guint64 baseTime = gst_element_get_base_time(mGstPipeline);
+	return now > baseTime && now - baseTime > presentTime;
 }
 
 void GStreamerWrapper::newVideoSinkPrerollCallback(GstSample* videoSinkSample) {
-	handleVideoBuffer(videoSinkSample);
+	// The preroll frame comes out of the sink again as the first buffer, so it doesn't get a sequence of its own
+	handleVideoBuffer(videoSinkSample, getFrameInfo(videoSinkSample, mFramesDecoded));
 }
 
 void GStreamerWrapper::newVideoSinkBufferCallback(GstSample* videoSinkSample) {
-	handleVideoBuffer(videoSinkSample);
+	const VideoFrameInfo info = getFrameInfo(videoSinkSample, ++mFramesDecoded);
+	if (isSampleLate(videoSinkSample, info)) mFramesLate++;
+
+	handleVideoBuffer(videoSinkSample, info);
 	mIsNewVideoFrame = true;
 }
 
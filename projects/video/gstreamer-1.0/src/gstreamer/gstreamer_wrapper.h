@@ -15,6 +15,8 @@ struct EGLImageTargetTexture2D {};
 #include <gst/gl/gl.h>
 
 #include "gstreamer_audio_device.h"
+#include "video_frame_timing.h"
+#include "video_sample_buffer.h"
 
 #include <atomic>
 #include <functional>
@@ -49,6 +51,26 @@ audio stream but no video streams
 */
 enum ContentType { NONE, VIDEO_AND_AUDIO, VIDEO, AUDIO };
 
+/*
+struct VideoFrameStats
+
+Counts of what happened to a player's video frames since its media was opened
+*/
+struct VideoFrameStats {
+	VideoFrameStats()
+	  : mFramesDecoded(0)
+	  , mFramesUploaded(0)
+	  , mFramesDropped(0)
+	  , mFramesLate(0)
+	  , mBytesCopied(0) {}
+
+	uint64_t mFramesDecoded;  ///<  Frames that came out of the video sink
+	uint64_t mFramesUploaded; ///<  Frames handed to the main thread for upload
+	uint64_t mFramesDropped;  ///<  Frames replaced by a newer one before the main thread got to them
+	uint64_t mFramesLate;	  ///<  Frames that came out of the sink after their presentation time
+	uint64_t mBytesCopied;	  ///<  Bytes copied into the video buffer on the streaming thread
+};
+
 /*
 class GStreamerWrapper
 
@@ -264,6 +286,34 @@ class GStreamerWrapper {
 	*/
 	void setNVDecode(const bool nvDecode);
 
+	/*
+	Zero copy mode hands decoded frames to the main thread without copying them into the video buffer. The newest
+	samples are held in a triple buffer and mapped for the upload with lockVideoFrame(), and the buffer from getVideo()
+	isn't updated. Not for OpenGL mode. Must be set before loading the video
+	*/
+	void setZeroCopy(const bool zeroCopy);
+	bool getZeroCopy() const { return mZeroCopy; }
+
+	/*
+	Zero copy mode only - maps the newest decoded frame and returns its pixels, or NULL if there isn't a new one.
+	The pixels are read only, and good until unlockVideoFrame(), which hands the frame back to the decoder
+	*/
+	unsigned char* lockVideoFrame();
+	void		   unlockVideoFrame();
+
+	/*
+	Returns the counts of decoded, uploaded, dropped and late frames and copied bytes since the media was opened
+	*/
+	VideoFrameStats getFrameStats() const;
+
+	/*
+	Frame pacing for this player. Call tick() on it once per app update, and frameUploaded() after each new frame from
+	getVideo(), lockVideoFrame() or getVideoTexture() is on its texture
+	*/
+	VideoFrameTiming&		getFrameTiming() { return mFrameTiming; }
+	const VideoFrameTiming& getFrameTiming() const { return mFrameTiming; }
+	void					frameUploaded();
+
 	/*
 	Returns an unsigned char pointer containing the pixel data for the currently decoded frame.
 	Returns NULL if there is either no video stream in the media file, no media file has been opened or something
@@ -603,7 +653,11 @@ class GStreamerWrapper {
 	static GstFlowReturn onNewBufferFromAudioSource(GstAppSink* appsink, void* listener);
 
 	/// internal buffer handling
-	void handleVideoBuffer(GstSample* videoSinkSample);
+	void handleVideoBuffer(GstSample* videoSinkSample, const VideoFrameInfo& info);
+	/// Stamps a sample as it comes out of the sink
+	VideoFrameInfo getFrameInfo(GstSample* videoSinkSample, const uint64_t sequence);
+	/// If the sample came out of the sink after its presentation time
+	bool isSampleLate(GstSample* videoSinkSample, const VideoFrameInfo& info);
 	/*
 	Non-static method that is called inside "onNewPrerollFromVideoSource()" in order to handle
 	member variables that are non-static. Here the unsigned char array with the pixel data is actually filled
@@ -677,9 +731,12 @@ class GStreamerWrapper {
 	bool mGlMode;	///<  If we're using GStreamer's openGL capabilities, outputs a texture instead of a buffer
 	bool mNVDecode; ///<  Uses NVidia CUDA to decode videos, support is limited
 
-	std::shared_ptr<GstBuffer> mCurrentBuffer; ///<  For GL Mode
-	std::shared_ptr<GstBuffer> mNewBuffer;	   ///<  For GL Mode
-	ci::gl::Texture2dRef	   mVideoTexture;  ///<  For GL Mode
+	std::shared_ptr<GstBuffer> mCurrentBuffer;	///<  For GL Mode
+	std::shared_ptr<GstBuffer> mNewBuffer;		///<  For GL Mode
+	ci::gl::Texture2dRef	   mVideoTexture;	///<  For GL Mode
+	VideoFrameInfo			   mNewFrameInfo;	///<  The frame in mVideoBuffer or mNewBuffer
+	VideoFrameInfo			   mShownFrameInfo;	///<  The frame last handed to the main thread
+	VideoFrameTiming		   mFrameTiming;	///<  Main thread only
 
 	std::function<void(GStreamerWrapper*)>	mVideoCompleteCallback;
 	std::function<void(const std::string&)> mErrorMessageCallback;
@@ -724,6 +781,16 @@ class GStreamerWrapper {
 	unsigned char* mVideoBuffer;	 ///<  Stores the video pixels
 	size_t		   mVideoBufferSize; ///<  Number of bytes in mVideoBuffer
 
+	bool				  mZeroCopy;	   ///<  Hand samples to the main thread instead of copying them
+	VideoSampleBuffer	  mVideoSamples;   ///<  For zero copy mode
+	GstBuffer*			  mMappedBuffer;   ///<  The buffer mapped by lockVideoFrame(), for zero copy mode
+	GstMapInfo			  mMappedInfo;	   ///<  For zero copy mode
+	std::atomic<uint64_t> mFramesDecoded;  ///<  See VideoFrameStats
+	std::atomic<uint64_t> mFramesUploaded; ///<  See VideoFrameStats
+	std::atomic<uint64_t> mFramesDropped;  ///<  See VideoFrameStats
+	std::atomic<uint64_t> mFramesLate;	   ///<  See VideoFrameStats
+	std::atomic<uint64_t> mBytesCopied;	   ///<  See VideoFrameStats
+
 	GstElement*			mGstVideoSink; ///<  Video sink that contains the raw video buffer. Gathered from the pipeline
 	GstAppSinkCallbacks mGstVideoSinkCallbacks; ///<  Stores references to the callback methods for video preroll, new
 												///<  video buffer and video eos
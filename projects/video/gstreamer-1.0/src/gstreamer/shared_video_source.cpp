@@ -0,0 +1,238 @@
+#include "stdafx.h"
+
+#include "shared_video_source.h"
+
+#include <cstring>
+#include <sstream>
+
+#include <gst/video/video.h>
+
+#include "ds/debug/logger.h"
+
+namespace gstwrapper {
+
+SharedVideoSource::SharedVideoSource(const std::string& filename)
+  : mFilename(filename)
+  , mPipeline(nullptr)
+  , mTee(nullptr)
+  , mBus(nullptr) {}
+
+SharedVideoSource::~SharedVideoSource() {
+	if (mPipeline) {
+		// Waits for the streaming threads, so no callback runs past this
+		gst_element_set_state(mPipeline, GST_STATE_NULL);
+
+		for (auto it = mBranches.begin(); it != mBranches.end(); ++it) {
+			if ((*it)->mTeePad) {
+				gst_element_release_request_pad(mTee, (*it)->mTeePad);
+				gst_object_unref((*it)->mTeePad);
+			}
+		}
+
+		if (mTee) gst_object_unref(mTee);
+		gst_object_unref(mPipeline);
+	}
+
+	if (mBus) gst_object_unref(mBus);
+}
+
+bool SharedVideoSource::open() {
+	if (mPipeline) return true;
+
+	std::string uri = mFilename;
+	if (uri.find("://") == std::string::npos) {
+		GError* error	= nullptr;
+		gchar*	fileUri = gst_filename_to_uri(mFilename.c_str(), &error);
+		if (!fileUri) {
+			DS_LOG_WARNING("SharedVideoSource couldn't make a uri for " << mFilename << ": "
+																		<< (error ? error->message : ""));
+			if (error) g_error_free(error);
+			return false;
+		}
+		uri = fileUri;
+		g_free(fileUri);
+	}
+
+	// Only the video stream is decoded, and converted once before the tee
+	std::stringstream description;
+	description << "uridecodebin uri=\"" << uri << "\" expose-all-streams=false caps=video/x-raw"
+				<< " ! videoconvert ! video/x-raw,format=BGRA ! tee name=tee allow-not-linked=true";
+
+	GError* error = nullptr;
+	mPipeline	  = gst_parse_launch(description.str().c_str(), &error);
+	if (error) {
+		DS_LOG_WARNING("SharedVideoSource couldn't build a pipeline for " << mFilename << ": " << error->message);
+		g_error_free(error);
+		if (mPipeline) gst_object_unref(mPipeline);
+		mPipeline = nullptr;
+		return false;
+	}
+
+	mTee = gst_bin_get_by_name(GST_BIN(mPipeline), "tee");
+	mBus = gst_pipeline_get_bus(GST_PIPELINE(mPipeline));
+
+	if (gst_element_set_state(mPipeline, GST_STATE_PLAYING) == GST_STATE_CHANGE_FAILURE) {
+		DS_LOG_WARNING("SharedVideoSource couldn't play " << mFilename);
+		return false;
+	}
+
+	DS_LOG_VERBOSE(2, "SharedVideoSource opened " << mFilename);
+	return true;
+}
+
+int SharedVideoSource::getBranch(const int width, const int height) {
+	for (size_t i = 0; i < mBranches.size(); ++i) {
+		if (mBranches[i]->mWidth == width && mBranches[i]->mHeight == height) return static_cast<int>(i);
+	}
+
+	if (!mPipeline || !mTee) return -1;
+
+	std::unique_ptr<Branch> branch(new Branch(width, height));
+	if (!addBranch(*branch)) return -1;
+
+	mBranches.push_back(std::move(branch));
+	return static_cast<int>(mBranches.size() - 1);
+}
+
+bool SharedVideoSource::addBranch(Branch& branch) {
+	std::stringstream description;
+	description << "queue leaky=downstream max-size-buffers=2 ! videoscale ! video/x-raw,format=BGRA";
+	if (branch.mWidth > 0 && branch.mHeight > 0) {
+		description << ",width=" << branch.mWidth << ",height=" << branch.mHeight << ",pixel-aspect-ratio=1/1";
+	}
+	description << " ! appsink name=sink max-buffers=1 drop=true sync=true";
+
+	GError* error = nullptr;
+	branch.mBin	  = gst_parse_bin_from_description(description.str().c_str(), TRUE, &error);
+	if (error) {
+		DS_LOG_WARNING("SharedVideoSource couldn't build a branch for " << mFilename << ": " << error->message);
+		g_error_free(error);
+		if (branch.mBin) gst_object_unref(branch.mBin);
+		branch.mBin = nullptr;
+		return false;
+	}
+
+	GstElement*			appsink = gst_bin_get_by_name(GST_BIN(branch.mBin), "sink");
+	GstAppSinkCallbacks callbacks;
+	memset(&callbacks, 0, sizeof(callbacks));
+	callbacks.new_sample = &SharedVideoSource::onNewSample;
+	gst_app_sink_set_callbacks(GST_APP_SINK(appsink), &callbacks, &branch, NULL);
+	gst_object_unref(appsink);
+
+	// The pipeline owns the bin from here on
+	gst_bin_add(GST_BIN(mPipeline), branch.mBin);
+
+	GstPad* sinkPad = gst_element_get_static_pad(branch.mBin, "sink");
+	branch.mTeePad	= gst_element_get_request_pad(mTee, "src_%u");
+
+	const bool linked = branch.mTeePad && sinkPad && GST_PAD_LINK_SUCCESSFUL(gst_pad_link(branch.mTeePad, sinkPad));
+	if (sinkPad) gst_object_unref(sinkPad);
+
+	if (!linked) {
+		DS_LOG_WARNING("SharedVideoSource couldn't link a branch for " << mFilename);
+		// The branch is going away, so its appsink can't stay in the pipeline pointing at it
+		if (branch.mTeePad) {
+			gst_element_release_request_pad(mTee, branch.mTeePad);
+			gst_object_unref(branch.mTeePad);
+			branch.mTeePad = nullptr;
+		}
+		gst_bin_remove(GST_BIN(mPipeline), branch.mBin);
+		branch.mBin = nullptr;
+		return false;
+	}
+
+	gst_element_sync_state_with_parent(branch.mBin);
+	return true;
+}
+
+GstFlowReturn SharedVideoSource::onNewSample(GstAppSink* appsink, void* data) {
+	Branch*	   branch = static_cast<Branch*>(data);
+	GstSample* sample = gst_app_sink_pull_sample(appsink);
+	if (!sample) return GST_FLOW_OK;
+
+	branch->mFramesDecoded++;
+	if (!branch->mSamples.publish(sample)) branch->mFramesDropped++;
+	gst_sample_unref(sample);
+	return GST_FLOW_OK;
+}
+
+void SharedVideoSource::update() {
+	handleMessages();
+
+	for (auto it = mBranches.begin(); it != mBranches.end(); ++it) {
+		uploadFrame(**it);
+	}
+}
+
+void SharedVideoSource::uploadFrame(Branch& branch) {
+	GstSample* sample = branch.mSamples.acquire();
+	if (!sample) return;
+
+	GstBuffer*	 buff = gst_sample_get_buffer(sample);
+	GstCaps*	 caps = gst_sample_get_caps(sample);
+	GstVideoInfo info;
+	GstMapInfo	 map;
+	if (buff && caps && gst_video_info_from_caps(&info, caps) && gst_buffer_map(buff, &map, GST_MAP_READ)) {
+		const int width	 = GST_VIDEO_INFO_WIDTH(&info);
+		const int height = GST_VIDEO_INFO_HEIGHT(&info);
+		if (!branch.mTexture || branch.mTexture->getWidth() != width || branch.mTexture->getHeight() != height) {
+			branch.mTexture = ci::gl::Texture::create(width, height, ci::gl::Texture::Format());
+		}
+
+		ci::Surface surface(map.data, width, height, GST_VIDEO_INFO_PLANE_STRIDE(&info, 0),
+							ci::SurfaceChannelOrder::BGRA);
+		branch.mTexture->update(surface);
+		branch.mFramesUploaded++;
+
+		gst_buffer_unmap(buff, &map);
+	}
+
+	branch.mSamples.release();
+}
+
+void SharedVideoSource::handleMessages() {
+	if (!mBus) return;
+
+	while (GstMessage* message = gst_bus_pop(mBus)) {
+		switch (GST_MESSAGE_TYPE(message)) {
+		case GST_MESSAGE_EOS:
+			if (!gst_element_seek_simple(mPipeline, GST_FORMAT_TIME,
+										 (GstSeekFlags)(GST_SEEK_FLAG_FLUSH | GST_SEEK_FLAG_KEY_UNIT), 0)) {
+				DS_LOG_WARNING("SharedVideoSource couldn't loop " << mFilename);
+			}
+			break;
+
+		case GST_MESSAGE_ERROR: {
+			GError* err	  = nullptr;
+			gchar*	debug = nullptr;
+			gst_message_parse_error(message, &err, &debug);
+			DS_LOG_WARNING("SharedVideoSource error in " << mFilename << ": " << (err ? err->message : ""));
+			if (err) g_error_free(err);
+			g_free(debug);
+		} break;
+
+		default:
+			break;
+		}
+
+		gst_message_unref(message);
+	}
+}
+
+ci::gl::TextureRef SharedVideoSource::getTexture(const int branch) const {
+	if (branch < 0 || branch >= static_cast<int>(mBranches.size())) return nullptr;
+	return mBranches[branch]->mTexture;
+}
+
+VideoFrameStats SharedVideoSource::getFrameStats(const int branch) const {
+	VideoFrameStats stats;
+	if (branch < 0 || branch >= static_cast<int>(mBranches.size())) return stats;
+
+	const Branch& b		  = *mBranches[branch];
+	stats.mFramesDecoded  = b.mFramesDecoded;
+	stats.mFramesUploaded = b.mFramesUploaded;
+	stats.mFramesDropped  = b.mFramesDropped;
+	return stats;
+}
+
+} // namespace gstwrapper
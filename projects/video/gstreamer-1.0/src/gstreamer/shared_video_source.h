@@ -0,0 +1,102 @@
+#pragma once
+#ifndef DS_PROJECTS_VIDEO_GSTREAMER_SHAREDVIDEOSOURCE_H_
+#define DS_PROJECTS_VIDEO_GSTREAMER_SHAREDVIDEOSOURCE_H_
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <cinder/gl/Texture.h>
+#include <gst/app/gstappsink.h>
+#include <gst/gst.h>
+
+#include "gstreamer_wrapper.h"
+#include "video_sample_buffer.h"
+
+namespace gstwrapper {
+
+/*
+class SharedVideoSource
+
+Decodes one video file once for any number of viewers. The decoded frames go through a tee to a branch for each size
+the viewers asked for, so a thumbnail scales down on the streaming thread instead of every viewer uploading the full
+frame. Each branch keeps its newest frame in a texture that all its viewers draw.
+The source loops, plays while anyone holds it and stops when the last reference goes away. It has no audio and no
+playback controls. Main thread only, get one from GstVideoService::acquireSharedSource()
+*/
+class SharedVideoSource {
+  public:
+	SharedVideoSource(const std::string& filename);
+	~SharedVideoSource();
+
+	/*
+	Starts decoding. Returns false and logs if the pipeline couldn't be built
+	*/
+	bool open();
+
+	const std::string& getFilename() const { return mFilename; }
+
+	/*
+	Returns the index of the branch decoding at width x height, adding one if there isn't one yet. A size of 0 x 0
+	is the video's own size
+	*/
+	int getBranch(const int width, const int height);
+
+	/*
+	Uploads the newest frame of each branch and loops the video at its end. Every viewer calls this each update, only
+	the first call with new frames does any work
+	*/
+	void update();
+
+	/*
+	The texture with the newest frame of a branch, NULL until the first frame arrives
+	*/
+	ci::gl::TextureRef getTexture(const int branch) const;
+
+	/*
+	Counts of decoded, uploaded and dropped frames for a branch
+	*/
+	VideoFrameStats getFrameStats(const int branch) const;
+
+  private:
+	SharedVideoSource(const SharedVideoSource&);
+	SharedVideoSource& operator=(const SharedVideoSource&);
+
+	struct Branch {
+		Branch(const int width, const int height)
+		  : mWidth(width)
+		  , mHeight(height)
+		  , mBin(nullptr)
+		  , mTeePad(nullptr)
+		  , mFramesDecoded(0)
+		  , mFramesUploaded(0)
+		  , mFramesDropped(0) {}
+
+		const int			  mWidth;
+		const int			  mHeight;
+		GstElement*			  mBin;
+		GstPad*				  mTeePad;
+		VideoSampleBuffer	  mSamples;
+		ci::gl::TextureRef	  mTexture;
+		std::atomic<uint64_t> mFramesDecoded;
+		uint64_t			  mFramesUploaded;
+		std::atomic<uint64_t> mFramesDropped;
+	};
+
+	static GstFlowReturn onNewSample(GstAppSink* appsink, void* branch);
+
+	bool addBranch(Branch& branch);
+	void uploadFrame(Branch& branch);
+	void handleMessages();
+
+	const std::string					 mFilename;
+	GstElement*							 mPipeline;
+	GstElement*							 mTee;
+	GstBus*								 mBus;
+	std::vector<std::unique_ptr<Branch>> mBranches;
+};
+
+} // namespace gstwrapper
+
+#endif // DS_PROJECTS_VIDEO_GSTREAMER_SHAREDVIDEOSOURCE_H_
@@ -0,0 +1,158 @@
+#include "stdafx.h"
+
+#include "video_frame_timing.h"
+
+#include <algorithm>
+
+#include <glib.h>
+
+namespace gstwrapper {
+
+namespace {
+	/// Frames kept for getRecords(), a bit over 10 seconds at 60fps
+	const size_t MAX_RECORDS = 640;
+
+	std::vector<int64_t> latency_bounds() {
+		// Microseconds, in 60hz frames past the first few milliseconds
+		return {1000, 2000, 4000, 8000, 16667, 33333, 50000, 66667, 100000, 200000};
+	}
+
+	std::vector<int64_t> count_bounds() {
+		return {0, 1, 2, 3, 4, 8, 16};
+	}
+} // namespace
+
+/*
+class VideoFrameHistogram
+*/
+VideoFrameHistogram::VideoFrameHistogram(const std::string& name, const std::string& unit,
+										 const std::vector<int64_t>& bounds)
+  : mName(name)
+  , mUnit(unit)
+  , mBounds(bounds)
+  , mCounts(bounds.size() + 1, 0)
+  , mTotal(0)
+  , mSum(0)
+  , mMax(0) {}
+
+void VideoFrameHistogram::add(const int64_t value) {
+	size_t bucket = 0;
+	while (bucket < mBounds.size() && value > mBounds[bucket]) ++bucket;
+
+	++mCounts[bucket];
+	++mTotal;
+	mSum += value;
+	if (value > mMax) mMax = value;
+}
+
+void VideoFrameHistogram::clear() {
+	std::fill(mCounts.begin(), mCounts.end(), 0);
+	mTotal = 0;
+	mSum   = 0;
+	mMax   = 0;
+}
+
+double VideoFrameHistogram::getMean() const {
+	if (mTotal < 1) return 0.0;
+	return static_cast<double>(mSum) / static_cast<double>(mTotal);
+}
+
+void VideoFrameHistogram::dump(std::ostream& out) const {
+	out << mName << " (" << mUnit << "): " << mTotal << " samples, mean " << getMean() << ", max " << mMax << "\n";
+	for (size_t i = 0; i < mCounts.size(); ++i) {
+		if (i < mBounds.size()) {
+			out << "  <= " << mBounds[i];
+		} else if (!mBounds.empty()) {
+			out << "  >  " << mBounds.back();
+		}
+		out << "\t" << mCounts[i] << "\n";
+	}
+}
+
+/*
+class VideoFrameTiming
+*/
+VideoFrameTiming::VideoFrameTiming()
+  : mLatency("decode to display latency", "us", latency_bounds())
+  , mDrops("frames dropped between frames shown", "frames", count_bounds())
+  , mRepeats("updates each frame was repeated for", "updates", count_bounds())
+  , mNextRecord(0)
+  , mUpdate(0)
+  , mHasLast(false)
+  , mLastSequence(0)
+  , mLastShownIn(0) {}
+
+void VideoFrameTiming::tick() {
+	++mUpdate;
+}
+
+void VideoFrameTiming::frameShown(const VideoFrameInfo& info) {
+	VideoFrameRecord record;
+	record.mInfo		 = info;
+	record.mUploadTime	 = g_get_monotonic_time();
+	record.mShownInFrame = mUpdate;
+	record.mDropped		 = 0;
+	record.mRepeats		 = 0;
+
+	if (mHasLast) {
+		// A preroll frame shares its sequence with the frame before it
+		if (info.mSequence > mLastSequence) record.mDropped = static_cast<int>(info.mSequence - mLastSequence - 1);
+		if (mUpdate > mLastShownIn) record.mRepeats = static_cast<int>(mUpdate - mLastShownIn - 1);
+		mDrops.add(record.mDropped);
+		mRepeats.add(record.mRepeats);
+	}
+	if (info.mDecodeTime > 0) mLatency.add(record.mUploadTime - info.mDecodeTime);
+
+	if (mRecords.size() < MAX_RECORDS) {
+		mRecords.push_back(record);
+	} else {
+		mRecords[mNextRecord] = record;
+	}
+	mNextRecord = (mNextRecord + 1) % MAX_RECORDS;
+
+	mHasLast	  = true;
+	mLastSequence = info.mSequence;
+	mLastShownIn  = mUpdate;
+}
+
+void VideoFrameTiming::breakContinuity() {
+	mHasLast = false;
+}
+
+void VideoFrameTiming::reset() {
+	mLatency.clear();
+	mDrops.clear();
+	mRepeats.clear();
+	mRecords.clear();
+	mNextRecord	  = 0;
+	mUpdate		  = 0;
+	mHasLast	  = false;
+	mLastSequence = 0;
+	mLastShownIn  = 0;
+}
+
+std::vector<VideoFrameRecord> VideoFrameTiming::getRecords() const {
+	if (mRecords.size() < MAX_RECORDS) return mRecords;
+
+	std::vector<VideoFrameRecord> records(mRecords.begin() + mNextRecord, mRecords.end());
+	records.insert(records.end(), mRecords.begin(), mRecords.begin() + mNextRecord);
+	return records;
+}
+
+void VideoFrameTiming::dump(std::ostream& out, const bool withFrames) const {
+	out << "Video frame timing over " << mUpdate << " updates\n";
+	mLatency.dump(out);
+	mDrops.dump(out);
+	mRepeats.dump(out);
+
+	if (!withFrames) return;
+
+	out << "sequence,decode_us,presentation_ns,upload_us,update,dropped,repeats\n";
+	const auto records = getRecords();
+	for (auto it = records.begin(), end = records.end(); it != end; ++it) {
+		out << it->mInfo.mSequence << "," << it->mInfo.mDecodeTime << "," << it->mInfo.mPresentationTime << ","
+			<< it->mUploadTime << "," << it->mShownInFrame << "," << it->mDropped << "," << it->mRepeats << "\n";
+	}
+}
+
+} // namespace gstwrapper
@@ -0,0 +1,133 @@
+#pragma once
+#ifndef DS_PROJECTS_VIDEO_GSTREAMER_VIDEOFRAMETIMING_H_
+#define DS_PROJECTS_VIDEO_GSTREAMER_VIDEOFRAMETIMING_H_
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace gstwrapper {
+
+/*
+struct VideoFrameInfo
+
+Where a decoded frame came from. Times are from g_get_monotonic_time(), in microseconds
+*/
+struct VideoFrameInfo {
+	VideoFrameInfo()
+	  : mSequence(0)
+	  , mDecodeTime(0)
+	  , mPresentationTime(-1) {}
+
+	uint64_t mSequence;			///<  Counts up from 1 for each frame out of the video sink since the media was opened
+	int64_t	 mDecodeTime;		///<  When the frame came out of the video sink
+	int64_t	 mPresentationTime; ///<  The frame's running time in nanoseconds, or -1 if it doesn't have one
+};
+
+/*
+struct VideoFrameRecord
+
+One frame that made it onto a texture
+*/
+struct VideoFrameRecord {
+	VideoFrameInfo mInfo;
+	int64_t		   mUploadTime;	  ///<  When the texture upload finished
+	uint64_t	   mShownInFrame; ///<  The app update the frame was uploaded in, counting from 1
+	int			   mDropped;	  ///<  Frames decoded since the last one shown that were never shown
+	int			   mRepeats;	  ///<  App updates the last frame shown stayed up for after its first one
+};
+
+/*
+class VideoFrameHistogram
+
+Counts of values falling under each of a fixed set of upper bounds. The last bucket takes everything bigger
+*/
+class VideoFrameHistogram {
+  public:
+	VideoFrameHistogram(const std::string& name, const std::string& unit, const std::vector<int64_t>& bounds);
+
+	void add(const int64_t value);
+	void clear();
+
+	const std::string&			 getName() const { return mName; }
+	const std::vector<int64_t>&	 getBounds() const { return mBounds; }
+	const std::vector<uint64_t>& getCounts() const { return mCounts; }
+	uint64_t					 getTotal() const { return mTotal; }
+	int64_t						 getMax() const { return mMax; }
+	double						 getMean() const;
+
+	void dump(std::ostream&) const;
+
+  private:
+	std::string			  mName;
+	std::string			  mUnit;
+	std::vector<int64_t>  mBounds;
+	std::vector<uint64_t> mCounts;
+	uint64_t			  mTotal;
+	int64_t				  mSum;
+	int64_t				  mMax;
+};
+
+/*
+class VideoFrameTiming
+
+Frame pacing for one player. Records when each frame shown was decoded, presented and uploaded, and which app update
+showed it, and keeps histograms of decode to display latency, frames dropped between two shown frames and app updates
+a frame was repeated for. Main thread only
+*/
+class VideoFrameTiming {
+  public:
+	VideoFrameTiming();
+
+	/*
+	Once per app update, before the frame for that update is uploaded
+	*/
+	void tick();
+
+	/*
+	A frame was uploaded to the texture just now
+	*/
+	void frameShown(const VideoFrameInfo& info);
+
+	/*
+	Don't compare the next frame shown to the last one, for instance because the video paused or seeked, so the wait
+	doesn't show up as repeats
+	*/
+	void breakContinuity();
+
+	/*
+	Clears everything, for instance when new media is opened
+	*/
+	void reset();
+
+	const VideoFrameHistogram& getLatency() const { return mLatency; }
+	const VideoFrameHistogram& getDrops() const { return mDrops; }
+	const VideoFrameHistogram& getRepeats() const { return mRepeats; }
+
+	/*
+	The most recent frames shown, oldest first
+	*/
+	std::vector<VideoFrameRecord> getRecords() const;
+
+	/*
+	Writes the histograms, and with withFrames, a csv line for each of the recent frames. Meant for logs and for
+	benchmarks running a player without an app, like a videotestsrc or filesrc pipeline on a headless machine
+	*/
+	void dump(std::ostream&, const bool withFrames = false) const;
+
+  private:
+	VideoFrameHistogram			  mLatency;
+	VideoFrameHistogram			  mDrops;
+	VideoFrameHistogram			  mRepeats;
+	std::vector<VideoFrameRecord> mRecords;
+	size_t						  mNextRecord;
+	uint64_t					  mUpdate;
+	bool						  mHasLast;
+	uint64_t					  mLastSequence;
+	uint64_t					  mLastShownIn;
+};
+
+} // namespace gstwrapper
+
+#endif // DS_PROJECTS_VIDEO_GSTREAMER_VIDEOFRAMETIMING_H_
@@ -0,0 +1,56 @@
+#include "stdafx.h"
+
+#include "video_sample_buffer.h"
+
+namespace gstwrapper {
+
+VideoSampleBuffer::VideoSampleBuffer()
+  : mMiddle(1)
+  , mBack(0)
+  , mFront(2) {
+	mSlots[0] = nullptr;
+	mSlots[1] = nullptr;
+	mSlots[2] = nullptr;
+}
+
+VideoSampleBuffer::~VideoSampleBuffer() {
+	clear();
+}
+
+bool VideoSampleBuffer::publish(GstSample* sample, const VideoFrameInfo& info) {
+	// The back slot holds either a sample that was dropped, or one the main thread already moved past
+	if (mSlots[mBack]) gst_sample_unref(mSlots[mBack]);
+	mSlots[mBack] = sample ? gst_sample_ref(sample) : nullptr;
+	mInfos[mBack] = info;
+
+	const int previous = mMiddle.exchange(mBack | FRESH, std::memory_order_acq_rel);
+	mBack			   = previous & INDEX_MASK;
+	return (previous & FRESH) == 0;
+}
+
+GstSample* VideoSampleBuffer::acquire(VideoFrameInfo* info) {
+	if ((mMiddle.load(std::memory_order_acquire) & FRESH) == 0) return nullptr;
+
+	const int previous = mMiddle.exchange(mFront, std::memory_order_acq_rel);
+	mFront			   = previous & INDEX_MASK;
+	if (info) *info = mInfos[mFront];
+	return mSlots[mFront];
+}
+
+void VideoSampleBuffer::release() {
+	// Only the main thread touches the front slot
+	if (mSlots[mFront]) {
+		gst_sample_unref(mSlots[mFront]);
+		mSlots[mFront] = nullptr;
+	}
+}
+
+void VideoSampleBuffer::clear() {
+	for (int i = 0; i < 3; ++i) {
+		if (mSlots[i]) gst_sample_unref(mSlots[i]);
+		mSlots[i] = nullptr;
+	}
+	mMiddle.store(mMiddle.load() & INDEX_MASK);
+}
+
+} // namespace gstwrapper
@@ -0,0 +1,66 @@
+#pragma once
+#ifndef DS_PROJECTS_VIDEO_GSTREAMER_VIDEOSAMPLEBUFFER_H_
+#define DS_PROJECTS_VIDEO_GSTREAMER_VIDEOSAMPLEBUFFER_H_
+
+#include <atomic>
+
+#include <gst/gst.h>
+
+#include "video_frame_timing.h"
+
+namespace gstwrapper {
+
+/*
+class VideoSampleBuffer
+
+Lock free triple buffer of decoded video samples. The streaming thread publishes each new sample, and the main thread
+takes the newest one, without either of them waiting on the other or copying any pixels. A sample replaced before the
+main thread got to it is dropped.
+*/
+class VideoSampleBuffer {
+  public:
+	VideoSampleBuffer();
+	~VideoSampleBuffer();
+
+	/*
+	Streaming thread. Keeps a reference to sample, along with its info. Returns false if that replaced a sample that
+	was never taken
+	*/
+	bool publish(GstSample* sample, const VideoFrameInfo& info = VideoFrameInfo());
+
+	/*
+	Main thread. Returns the newest sample if there's one that hasn't been taken yet, otherwise NULL. The buffer keeps
+	the reference, and the sample is good until release() or the next acquire(). Fills in info if it's not NULL
+	*/
+	GstSample* acquire(VideoFrameInfo* info = nullptr);
+
+	/*
+	Main thread. Lets go of the sample from acquire(), so its memory can go back to the decoder
+	*/
+	void release();
+
+	/*
+	Drops every sample. Only call this while neither thread is using the buffer, for instance once the pipeline stopped
+	*/
+	void clear();
+
+  private:
+	VideoSampleBuffer(const VideoSampleBuffer&);
+	VideoSampleBuffer& operator=(const VideoSampleBuffer&);
+
+	static const int INDEX_MASK = 0x3;
+	static const int FRESH		= 0x4;
+
+	GstSample*	   mSlots[3];
+	VideoFrameInfo mInfos[3];
+	/// The slot between the two threads, and FRESH if it holds a sample that hasn't been taken
+	std::atomic<int> mMiddle;
+	/// The slot the streaming thread writes next
+	int mBack;
+	/// The slot the main thread reads
+	int mFront;
+};
+
+} // namespace gstwrapper
+
+#endif // DS_PROJECTS_VIDEO_GSTREAMER_VIDEOSAMPLEBUFFER_H_
@@ -10,6 +10,7 @@
 
 #include "gst/gstplugin.h"
 #include "gstreamer/gstreamer_env_check.h"
+#include "gstreamer/shared_video_source.h"
 #include <gst/gst.h>
 
 namespace ds::gstreamer {
@@ -70,6 +71,11 @@ GstVideoService::GstVideoService(ds::Engine& e)
 		"video_nvdecode", [](ds::ui::GstVideo& video, const std::string& theValue, const std::string& fileReferrer) {
 			video.setNVDecode(ds::parseBoolean(theValue));
 		});
+
+	mEngine.registerSpritePropertySetter<ds::ui::GstVideo>(
+		"video_shared_src", [](ds::ui::GstVideo& video, const std::string& theValue, const std::string& fileReferrer) {
+			video.loadSharedVideo(ds::filePathRelativeTo(fileReferrer, theValue));
+		});
 }
 
 GstVideoService::~GstVideoService() {}
@@ -82,6 +88,32 @@ const std::string& GstVideoService::getErrorMessage() {
 	return mErrorMessage;
 }
 
+std::shared_ptr<gstwrapper::SharedVideoSource> GstVideoService::acquireSharedSource(const std::string& filename) {
+	if (!mValidInstall || filename.empty()) return nullptr;
+
+	const std::string key	 = ds::getNormalizedPath(filename);
+	auto			  source = mSharedSources[key].lock();
+	if (source) return source;
+
+	// Drop the sources nobody holds anymore while we're here
+	for (auto it = mSharedSources.begin(); it != mSharedSources.end();) {
+		if (it->second.expired() && it->first != key) {
+			it = mSharedSources.erase(it);
+		} else {
+			++it;
+		}
+	}
+
+	source = std::make_shared<gstwrapper::SharedVideoSource>(filename);
+	if (!source->open()) {
+		mSharedSources.erase(key);
+		return nullptr;
+	}
+
+	mSharedSources[key] = source;
+	return source;
+}
+
 void gstLogFunction(GstDebugCategory* category, GstDebugLevel level, const gchar* file, const gchar* function,
 					gint line, GObject* object, GstDebugMessage* message, gpointer user_data) {
 	DS_LOG_VERBOSE(3, "GST_DEBUG " << level << " " << file << " " << function << " " << gst_debug_message_get(message));
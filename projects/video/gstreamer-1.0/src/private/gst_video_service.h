@@ -3,13 +3,19 @@
 #define PRIVATE_VIDEO_SERVICE
 
 #include <ds/app/engine/engine_service.h>
+#include <memory>
 #include <string>
+#include <unordered_map>
 
 
 namespace ds {
 class Engine;
 }
 
+namespace gstwrapper {
+class SharedVideoSource;
+}
+
 namespace ds::gstreamer {
 
 /**
@@ -26,10 +32,16 @@ class GstVideoService final : public ds::EngineService {
 
 	virtual void start();
 
+	/// Answers the source decoding filename for every GstVideo showing it shared, starting one if nobody holds it.
+	/// Answers null if it can't be played. The source stops when the last holder lets go of it
+	std::shared_ptr<gstwrapper::SharedVideoSource> acquireSharedSource(const std::string& filename);
+
   private:
 	bool		mValidInstall;
 	std::string mErrorMessage;
 	ds::Engine& mEngine;
+
+	std::unordered_map<std::string, std::weak_ptr<gstwrapper::SharedVideoSource>> mSharedSources;
 };
 
 } // namespace ds::gstreamer
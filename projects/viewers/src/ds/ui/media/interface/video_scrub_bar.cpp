@@ -22,6 +22,7 @@ namespace ds { namespace ui {
 	  , mLinkedVideo(nullptr)
 	  , mLinkedPdf(nullptr)
 	  , mLinkedYouTube(nullptr) {
+		setWantsUpdates(true);
 
 		// 	setTransparent(false);
 		// 	setColor(ci::Color(0.0f, 0.5f, 0.0f));
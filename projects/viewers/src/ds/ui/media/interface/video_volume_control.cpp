@@ -24,6 +24,7 @@ VideoVolumeControl::VideoVolumeControl(ds::ui::SpriteEngine& eng, const float th
   , mTheSize(theSize)
   , mButtHeight(buttHeight)
   , mOffOpacity(0.2f) {
+	setWantsUpdates(true);
 
 	setStyle(mStyle);
 }
@@ -28,6 +28,7 @@ MediaInterface::MediaInterface(ds::ui::SpriteEngine& eng, const ci::vec2& sizey,
   , mCanDisplay(true)
   , mCanLock(false)
   , mInterfaceIdleSettings(5.0f) {
+	setWantsUpdates(true);
 
 	// TODO: settings?
 	const float backOpacccy = 0.95f;
@@ -65,6 +65,7 @@ void main() {
 
 SplitAlphaVideoPlayer::SplitAlphaVideoPlayer(ds::ui::SpriteEngine& eng, const bool embedInterface)
   : ds::ui::VideoPlayer(eng, embedInterface) {
+	setWantsUpdates(true);
 	setTransparent(false);
 	try {
 		mSplitAlphaShader = ci::gl::GlslProg::create(splitvideo_vert, splitvideo_frag);
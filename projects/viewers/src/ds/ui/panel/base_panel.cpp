@@ -30,6 +30,7 @@ BasePanel::BasePanel(ds::ui::SpriteEngine& engine)
   , mRemoving(false)
   , mLayoutCallback(nullptr)
   , mPositionUpdateCallback(nullptr) {
+	setWantsUpdates(true);
 
 	mLayoutFixedAspect = true;
 
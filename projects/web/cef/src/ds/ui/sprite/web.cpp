@@ -111,6 +111,7 @@ Web::Web(ds::ui::SpriteEngine& engine, float width, float height)
   , mCanForward(false)
   , mIsFullscreen(false)
   , mCallbacksCue(nullptr) {
+	setWantsUpdates(true);
 	// Should be unnecessary, but really want to make sure that static gets initialized
 	INIT.doNothing();
 
@@ -52,6 +52,11 @@ RootList& RootList::pickColor() {
 	return *this;
 }
 
+RootList& RootList::pickIndexed() {
+	if (!mRoots.empty()) mRoots.back().mPickIndexed = true;
+	return *this;
+}
+
 RootList& RootList::perspFov(const float v) {
 	if (!mRoots.empty()) mRoots.back().mPersp.mFov = v;
 	return *this;
@@ -93,6 +98,7 @@ RootList& RootList::slave() {
 RootList::Root::Root()
   : mType(kOrtho)
   , mPick(kDefault)
+  , mPickIndexed(false)
   , mMaster(kIndependent)
   , mDebugDraw(false)
   , mSyncronize(true)
@@ -53,6 +53,8 @@ class RootList {
 	RootList& pickSelect();
 	/// Use unique colour rendering for picking.
 	RootList& pickColor();
+	/// Ortho only: skip any branch of sprites the touch point is outside of. See Sprite::getIndexedHit().
+	RootList& pickIndexed();
 
 	RootList& perspFov(const float);
 	RootList& perspPosition(const ci::vec3&);
@@ -74,6 +76,8 @@ class RootList {
 		Type mType;
 		enum Pick { kDefault, kSelect, kColor };
 		Pick mPick;
+		/// Ortho roots cache the bounds of every branch to narrow down touch picks
+		bool mPickIndexed;
 		enum Master { kIndependent, kMaster, kSlave };
 		Master			  mMaster;
 		PerspCameraParams mPersp;
@@ -23,6 +23,7 @@
 #include "ds/ui/touch/draw_touch_view.h"
 #include "ds/ui/touch/touch_event.h"
 #include "ds/util/file_meta_data.h"
+#include "ds/util/image_meta_data.h"
 
 #include <boost/algorithm/string.hpp>
 #include <cinder/Display.h>
@@ -155,6 +156,7 @@ void Engine::setupEngine() {
 	setupLogger();
 	setupFrameRate();
 	setupVerticalSync();
+	setupSkipIdleUpdates();
 	setupWindowMode();
 	setupMouseHide();
 	setupWorldSize();
@@ -343,6 +345,10 @@ void Engine::setupVerticalSync() {
 	ci::gl::enableVerticalSync(mSettings.getBool("vertical_sync"));
 }
 
+void Engine::setupSkipIdleUpdates() {
+	mSkipIdleUpdates = mSettings.getBool("update:skip_idle_sprites");
+}
+
 void Engine::setupIdleTimeout() {
 	setIdleTimeout(mSettings.getInt("idle_time"));
 
@@ -388,6 +394,12 @@ void Engine::setupResourceLocation() {
 								 ds::getNormalizedPath(mSettings.getString("resource_db")),
 								 ds::getNormalizedPath(mSettings.getString("project_path")));
 	}
+
+	if (mSettings.getBool("load_image:persist_metadata")) {
+		ImageMetaData::setPersistentCache(ds::Environment::expand("%LOCAL%/cache/image_metadata.sqlite"));
+	} else {
+		ImageMetaData::setPersistentCache("");
+	}
 }
 
 void Engine::setupRoots() {
@@ -550,6 +562,8 @@ void Engine::onAppEvent(const ds::Event& in_e) {
 				setupFrameRate();
 			} else if (e.mSettingName == "vertical_sync") {
 				setupVerticalSync();
+			} else if (e.mSettingName == "update:skip_idle_sprites") {
+				setupSkipIdleUpdates();
 			} else if (e.mSettingName == "idle_time") {
 				setupIdleTimeout();
 			} else if (e.mSettingName == "platform:mute") {
@@ -961,9 +975,11 @@ void Engine::updateClient() {
 
 	mAutoUpdateClient.update(mUpdateParams);
 
+	mSpritesUpdating = 0;
 	for (auto it = mRoots.begin(), end = mRoots.end(); it != end; ++it) {
 		(*it)->updateClient(mUpdateParams);
 	}
+	mSpritesUpdated = mSpritesUpdating;
 }
 
 void Engine::updateServer() {
@@ -1014,9 +1030,11 @@ void Engine::updateServer() {
 
 	mAutoUpdateServer.update(mUpdateParams);
 
+	mSpritesUpdating = 0;
 	for (auto it = mRoots.begin(), end = mRoots.end(); it != end; ++it) {
 		(*it)->updateServer(mUpdateParams);
 	}
+	mSpritesUpdated = mSpritesUpdating;
 }
 
 void Engine::markCameraDirty() {
@@ -1142,11 +1160,7 @@ void Engine::drawServer() {
 }
 
 ds::sprite_id_t Engine::nextSpriteId() {
-	static ds::sprite_id_t ID = 0;
-	++ID;
-	// Skip negative values.
-	if (ID <= EMPTY_SPRITE_ID) ID = EMPTY_SPRITE_ID + 1;
-	return ID;
+	return mSprites.allocate();
 }
 
 void Engine::registerSprite(ds::ui::Sprite& s) {
@@ -1155,7 +1169,7 @@ void Engine::registerSprite(ds::ui::Sprite& s) {
 		assert(false);
 		return;
 	}
-	mSprites[s.getId()] = &s;
+	mSprites.insert(s.getId(), &s);
 }
 
 void Engine::unregisterSprite(ds::ui::Sprite& s) {
@@ -1165,15 +1179,11 @@ void Engine::unregisterSprite(ds::ui::Sprite& s) {
 		assert(false);
 		return;
 	}
-	auto it = mSprites.find(s.getId());
-	if (it != mSprites.end()) mSprites.erase(it);
+	mSprites.erase(s.getId());
 }
 
 ds::ui::Sprite* Engine::findSprite(const ds::sprite_id_t id) {
-	if (mSprites.empty()) return nullptr;
-	auto it = mSprites.find(id);
-	if (it == mSprites.end()) return nullptr;
-	return it->second;
+	return mSprites.find(id);
 }
 
 void Engine::spriteDeleted(const ds::sprite_id_t&) {
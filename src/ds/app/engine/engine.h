@@ -11,6 +11,7 @@
 #include "ds/app/app_defs.h"
 #include "ds/app/auto_update_list.h"
 #include "ds/app/blob_registry.h"
+#include "ds/app/engine/engine_sprite_table.h"
 #include "ds/app/engine/engine_settings.h"
 #include "ds/app/engine/engine_touch_queue.h"
 #include "ds/app/event_client.h"
@@ -219,6 +220,7 @@ class Engine : public ui::SpriteEngine {
 	bool getAutoHideMouse() const { return mAutoHideMouse; }
 
 	ds::ui::Sprite* getHit(const ci::vec3& point) override;
+	size_t			getSpriteCount() const override { return mSprites.size(); }
 
 	ui::TouchManager& getTouchManager() { return mTouchManager; }
 	virtual void	  clearFingers(const std::vector<int>& fingers) override;
@@ -293,9 +295,9 @@ class Engine : public ui::SpriteEngine {
 
 	static const int NumberOfNetworkThreads;
 
-	ds::BlobRegistry									 mBlobRegistry;
-	std::unordered_map<ds::sprite_id_t, ds::ui::Sprite*> mSprites;
-	int													 mTuioPort;
+	ds::BlobRegistry  mBlobRegistry;
+	EngineSpriteTable mSprites;
+	int				  mTuioPort;
 
 	ds::ui::TouchMode::Enum mTouchMode;
 
@@ -314,6 +316,7 @@ class Engine : public ui::SpriteEngine {
 	void setupMouseHide();
 	void setupFrameRate();
 	void setupVerticalSync();
+	void setupSkipIdleUpdates();
 	void setupIdleTimeout();
 	void setupMute();
 	void setupResourceLocation();
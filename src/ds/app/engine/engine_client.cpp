@@ -7,6 +7,7 @@
 #include "ds/app/engine/engine_io_defs.h"
 #include "ds/debug/debug_defines.h"
 #include "ds/debug/logger.h"
+#include "ds/query/sql_connection_pool.h"
 #include "ds/ui/sprite/image.h"
 #include "ds/util/string_util.h"
 #include "snappy.h"
@@ -41,6 +42,7 @@ char EngineClient::getClientStatusBlob() {
 EngineClient::EngineClient(ds::App& app, ds::EngineSettings& settings, ds::EngineData& ed, const ds::RootList& roots)
   : Engine(app, settings, ed, roots, CLIENT_MODE)
   , mServerFrame(-1)
+  , mNeedsKeyframe(false)
   , mIoInfo(*this)
   , mSender(mSendConnection, false)
   , mReceiver(mReceiveConnection, true)
@@ -57,6 +59,8 @@ EngineClient::EngineClient(ds::App& app, ds::EngineSettings& settings, ds::Engin
 	CLIENT_STATUS_BLOB = mBlobRegistry.add([this](BlobReader& r) { receiveClientStatus(r.mDataBuffer); });
 	CLIENT_INPUT_BLOB  = mBlobRegistry.add([this](BlobReader& r) { receiveClientInput(r.mDataBuffer); });
 	mReceiver.setHeaderAndCommandIds(HEADER_BLOB, COMMAND_BLOB);
+	mReceiver.setDeleteSpriteId(DELETE_SPRITE_BLOB);
+	mReceiver.setCoalesceFrames(settings.getBool("server:coalesce_frames", 0, false));
 
 	try {
 		if (settings.getBool("server:connect", 0, true)) {
@@ -69,6 +73,10 @@ EngineClient::EngineClient(ds::App& app, ds::EngineSettings& settings, ds::Engin
 		DS_LOG_ERROR_M("EngineClient::EngineClient() initializing UDP: " << e.what(), ENGINE_LOG);
 	}
 
+	if (settings.getBool("server:receive_thread", 0, true)) {
+		mReceiver.startThread();
+	}
+
 	setState(mClientStartedState);
 }
 
@@ -89,15 +97,19 @@ ds::sprite_id_t EngineClient::nextSpriteId() {
 
 void EngineClient::update() {
 	mWorkManager.update();
+	ds::query::SqlConnectionPool::closeIdle();
 	updateClient();
 	mComputerInfo->update();
 
 	if (!mConnectionRenewed && (mReceiver.hasLostConnection() || !mSendConnection.initialized())) {
 		// This can happen because the network connection drops, so
 		// refresh it, and let the world now I'm ready again.
+		const bool threaded = mReceiver.isThreaded();
+		if (threaded) mReceiver.stopThread();
 		mReceiveConnection.renew();
 		mSendConnection.renew();
 		mReceiver.clearLostConnection();
+		if (threaded) mReceiver.startThread();
 
 		if (mReceiveConnection.initialized() && mSendConnection.initialized()) {
 			mConnectionRenewed = true;
@@ -153,6 +165,7 @@ void EngineClient::draw() {
 }
 
 void EngineClient::stopServices() {
+	mReceiver.stopThread();
 	Engine::stopServices();
 	mWorkManager.stopManager();
 }
@@ -165,7 +178,16 @@ int EngineClient::getBytesSent() {
 	return mSendConnection.getSentBytes();
 }
 
+int EngineClient::getBytesCopiedPerFrame() {
+	return mReceiver.getBytesCopiedPerFrame();
+}
+
+int EngineClient::getFramesCoalesced() {
+	return mReceiver.getFramesCoalesced();
+}
+
 void EngineClient::receiveHeader(ds::DataBuffer& data) {
+	const int32_t previousFrame = mServerFrame;
 	if (data.canRead<int32_t>()) {
 		mServerFrame = data.read<int32_t>();
 	} else {
@@ -173,12 +195,35 @@ void EngineClient::receiveHeader(ds::DataBuffer& data) {
 						 "issue, packets lost, etc.",
 						 ds::IO_LOG);
 	}
-	// Terminator
-	if (data.canRead<char>()) {
-		data.read<char>();
-	} else {
+
+	// Optional delta replication attributes, then the terminator
+	int32_t baselineFrame = -1;
+	bool	hasBaseline	  = false;
+	bool	keyframe	  = false;
+	char	att			  = 0;
+	while (data.canRead<char>() && (att = data.read<char>()) != ds::TERMINATOR_CHAR) {
+		if (att == ATT_BASELINE_FRAME && data.canRead<int32_t>()) {
+			baselineFrame = data.read<int32_t>();
+			hasBaseline	  = true;
+		} else if (att == ATT_KEYFRAME) {
+			keyframe = true;
+		} else {
+			DS_LOG_WARNING_M("EngineClient::receiveHeader() unknown header attribute " << (int)att, ds::IO_LOG);
+			return;
+		}
+	}
+	if (att != ds::TERMINATOR_CHAR) {
 		DS_LOG_WARNING_M("EngineClient::receiveHeader() No terminator found for header!", ds::IO_LOG);
 	}
+
+	if (keyframe) {
+		mNeedsKeyframe = false;
+	} else if (hasBaseline && previousFrame >= 0 && previousFrame < baselineFrame && !mNeedsKeyframe) {
+		// Everything between my last frame and the baseline is gone for good
+		DS_LOG_INFO_M("Missed delta frames " << previousFrame << " to " << baselineFrame << ", requesting a keyframe",
+					  ds::IO_LOG);
+		mNeedsKeyframe = true;
+	}
 }
 
 void EngineClient::receiveCommand(ds::DataBuffer& data) {
@@ -211,14 +256,10 @@ void EngineClient::receiveDeleteSprite(ds::DataBuffer& data) {
 		if (data.canRead<sprite_id_t>()) {
 			const sprite_id_t id = data.read<sprite_id_t>();
 
-			if (!mSprites.empty()) {
-				auto f = mSprites.find(id);
-				if (f != mSprites.end()) {
-					// Once I delete this item, mSprites will have been updated,
-					// with f->second and all children removed, so do not reference f again.
-					if (f->second) f->second->release();
-				}
-			}
+			// Once I delete this item, mSprites will have been updated,
+			// with it and all children removed, so do not reference it again.
+			ds::ui::Sprite* s = mSprites.find(id);
+			if (s) s->release();
 		} else {
 			break;
 		}
@@ -356,7 +397,8 @@ EngineClient::RunningState::RunningState() {}
 
 void EngineClient::RunningState::begin(EngineClient& c) {
 	DS_LOG_INFO_M("RunningState", ds::IO_LOG);
-	c.mServerFrame = -1;
+	c.mServerFrame	 = -1;
+	c.mNeedsKeyframe = false;
 }
 
 void EngineClient::RunningState::update(EngineClient& e) {
@@ -368,6 +410,9 @@ void EngineClient::RunningState::update(EngineClient& e) {
 	buf.add(e.mSessionId);
 	buf.add(ATT_FRAME);
 	buf.add(e.mServerFrame);
+	if (e.mNeedsKeyframe) {
+		buf.add(CMD_CLIENT_REQUEST_KEYFRAME);
+	}
 	buf.add(ds::TERMINATOR_CHAR);
 
 	const size_t count(e.getRootCount());
@@ -33,9 +33,14 @@ class EngineClient : public Engine {
 
 	virtual int getBytesRecieved();
 	virtual int getBytesSent();
+	virtual int getBytesCopiedPerFrame();
+	virtual int getFramesCoalesced();
 
 	/// The most recent frame received from the server.
 	int32_t mServerFrame;
+	/// Delta replication: a frame arrived relative to a baseline I never received,
+	/// so ask the server to send every attribute again.
+	bool mNeedsKeyframe;
 
   private:
 	void receiveHeader(ds::DataBuffer&);
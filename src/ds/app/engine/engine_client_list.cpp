@@ -76,6 +76,17 @@ void EngineClientList::compare(const int32_t server_frame) {
 	}
 }
 
+int32_t EngineClientList::getAcknowledgedFrame(const int32_t server_frame) const {
+	int32_t acked = server_frame - 1;
+	for (auto it = mClients.begin(), end = mClients.end(); it != end; ++it) {
+		// A frame from the future was echoed from before the server restarted its frame count
+		const int32_t cf = (it->mServerSentFrame > server_frame) ? -1 : it->mServerSentFrame;
+		if ((server_frame - cf) > mDisconnectionLag) continue;
+		if (cf < acked) acked = cf;
+	}
+	return acked;
+}
+
 /**
  * \class State
  */
@@ -47,6 +47,10 @@ class EngineClientList {
 
 	void compare(const int32_t server_frame);
 
+	/// The newest frame every connected client has echoed back, or server_frame - 1 if there are no clients.
+	/// Clients that have lagged long enough to be considered disconnected are ignored.
+	int32_t getAcknowledgedFrame(const int32_t server_frame) const;
+
   private:
 	std::vector<State> mClients;
 
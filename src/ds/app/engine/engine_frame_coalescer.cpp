@@ -0,0 +1,187 @@
+#include "stdafx.h"
+
+#include "ds/app/engine/engine_frame_coalescer.h"
+
+#include <cstring>
+
+#include "ds/app/engine/engine_io_defs.h"
+#include "ds/ui/sprite/sprite.h"
+
+namespace ds {
+
+namespace {
+	template <typename T>
+	bool read_value(const char*& pos, const char* end, T& t) {
+		if (static_cast<size_t>(end - pos) < sizeof(T)) return false;
+		std::memcpy(&t, pos, sizeof(T));
+		pos += sizeof(T);
+		return true;
+	}
+} // namespace
+
+/**
+ * \class EngineFrameCoalescer
+ */
+EngineFrameCoalescer::EngineFrameCoalescer()
+  : mHeaderId(0)
+  , mCommandId(0)
+  , mDeleteSpriteId(0)
+  , mBlobCount(0) {}
+
+void EngineFrameCoalescer::setBlobIds(const char header, const char command, const char deleteSprite) {
+	mHeaderId		= header;
+	mCommandId		= command;
+	mDeleteSpriteId = deleteSprite;
+}
+
+bool EngineFrameCoalescer::coalesce(const std::vector<const std::string*>& frames, std::string& out) {
+	mHeaders.clear();
+	mOpen.clear();
+	mBlobCount = 0;
+
+	for (auto it = frames.begin(), end = frames.end(); it != end; ++it) {
+		if (!(*it) || !parseFrame(**it)) return false;
+	}
+
+	write(out);
+	return true;
+}
+
+bool EngineFrameCoalescer::parseFrame(const std::string& frame) {
+	const char* pos = frame.data();
+	const char* end = pos + frame.size();
+	while (pos < end) {
+		const char* start = pos;
+		const char	token = *pos++;
+		if (token == mHeaderId) {
+			if (!parseHeader(pos, end)) return false;
+			mHeaders.push_back(Slice(start, pos - start));
+		} else if (token == mDeleteSpriteId) {
+			if (!parseDelete(pos, end)) return false;
+			pushBlob(token).mRaw = Slice(start, pos - start);
+		} else if (token == mCommandId || token <= 0) {
+			// Commands can change the state of the whole client
+			return false;
+		} else if (!parseSprite(token, pos, end)) {
+			return false;
+		}
+	}
+	return true;
+}
+
+bool EngineFrameCoalescer::parseHeader(const char*& pos, const char* end) {
+	int32_t frame = 0;
+	if (!read_value(pos, end, frame)) return false;
+
+	char att = 0;
+	while (read_value(pos, end, att)) {
+		if (att == ds::TERMINATOR_CHAR) return true;
+
+		if (att == ATT_BASELINE_FRAME) {
+			int32_t baseline = 0;
+			if (!read_value(pos, end, baseline)) return false;
+		} else if (att != ATT_KEYFRAME) {
+			return false;
+		}
+	}
+	return false;
+}
+
+bool EngineFrameCoalescer::parseDelete(const char*& pos, const char* end) {
+	size_t count = 0;
+	if (!read_value(pos, end, count)) return false;
+	if (count > static_cast<size_t>(end - pos) / sizeof(ds::sprite_id_t)) return false;
+
+	for (size_t k = 0; k < count; ++k) {
+		ds::sprite_id_t id = 0;
+		read_value(pos, end, id);
+		// Anything sent for this id from now on is a new sprite
+		mOpen.erase(id);
+	}
+
+	char terminator = 0;
+	return read_value(pos, end, terminator) && terminator == ds::TERMINATOR_CHAR;
+}
+
+bool EngineFrameCoalescer::parseSprite(const char token, const char*& pos, const char* end) {
+	char			att = 0;
+	ds::sprite_id_t id	= 0;
+	if (!read_value(pos, end, att) || att != ds::ui::SPRITE_ID_ATTRIBUTE) return false;
+	if (!read_value(pos, end, id)) return false;
+
+	mScratch.clear();
+	bool hierarchy = false;
+	while (true) {
+		if (!read_value(pos, end, att)) return false;
+		if (att == ds::TERMINATOR_CHAR) break;
+
+		const int size = ds::ui::Sprite::getAttributeValueSize(att, pos, static_cast<size_t>(end - pos));
+		if (size < 0) return false;
+
+		mScratch.push_back(std::make_pair(att, Slice(pos, static_cast<size_t>(size))));
+		pos += size;
+		if (ds::ui::Sprite::isHierarchyAttribute(att)) hierarchy = true;
+	}
+
+	// A new parent or child order has to be applied where it was sent, since the sprites it refers to
+	// might not exist any earlier. Everything else can take the place of the value it replaces.
+	auto open = mOpen.find(id);
+	if (!hierarchy && open != mOpen.end() && mBlobs[open->second].mToken == token) {
+		auto& atts = mBlobs[open->second].mAttributes;
+		for (auto it = mScratch.begin(), end = mScratch.end(); it != end; ++it) {
+			auto found = atts.begin();
+			while (found != atts.end() && found->first != it->first) {
+				++found;
+			}
+			if (found != atts.end()) {
+				found->second = it->second;
+			} else {
+				atts.push_back(*it);
+			}
+		}
+		return true;
+	}
+
+	Blob& blob = pushBlob(token);
+	blob.mId   = id;
+	blob.mAttributes.assign(mScratch.begin(), mScratch.end());
+	mOpen[id] = mBlobCount - 1;
+	return true;
+}
+
+EngineFrameCoalescer::Blob& EngineFrameCoalescer::pushBlob(const char token) {
+	if (mBlobCount >= mBlobs.size()) mBlobs.emplace_back();
+
+	Blob& blob = mBlobs[mBlobCount++];
+	blob.mToken = token;
+	blob.mId	= ds::EMPTY_SPRITE_ID;
+	blob.mRaw	= Slice();
+	blob.mAttributes.clear();
+	return blob;
+}
+
+void EngineFrameCoalescer::write(std::string& out) const {
+	out.clear();
+	for (auto it = mHeaders.begin(), end = mHeaders.end(); it != end; ++it) {
+		out.append(it->mData, it->mSize);
+	}
+
+	for (size_t k = 0; k < mBlobCount; ++k) {
+		const Blob& blob = mBlobs[k];
+		if (blob.mToken == mDeleteSpriteId) {
+			out.append(blob.mRaw.mData, blob.mRaw.mSize);
+			continue;
+		}
+
+		out.push_back(blob.mToken);
+		out.push_back(ds::ui::SPRITE_ID_ATTRIBUTE);
+		out.append(reinterpret_cast<const char*>(&blob.mId), sizeof(blob.mId));
+		for (auto it = blob.mAttributes.begin(), end = blob.mAttributes.end(); it != end; ++it) {
+			out.push_back(it->first);
+			out.append(it->second.mData, it->second.mSize);
+		}
+		out.push_back(ds::TERMINATOR_CHAR);
+	}
+}
+
+} // namespace ds
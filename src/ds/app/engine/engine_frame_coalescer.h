@@ -0,0 +1,76 @@
+#pragma once
+#ifndef DS_APP_ENGINE_ENGINEFRAMECOALESCER_H_
+#define DS_APP_ENGINE_ENGINEFRAMECOALESCER_H_
+
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "ds/app/app_defs.h"
+
+namespace ds {
+
+/**
+ * \class EngineFrameCoalescer
+ * \brief Used by a client that fell behind the server. Merges the frames waiting to be handled
+ * into a single frame, so each sprite applies only the newest value of each attribute instead
+ * of replaying every stale one.
+ * Sprite blobs are merged into the sprite's previous blob unless they change the hierarchy
+ * (a new parent or child order), and a deletion ends the deleted sprite's blob, so creates and
+ * deletes happen in the order they were sent. Headers are kept in order ahead of everything else.
+ * Frames with commands or subclass attributes can't be taken apart safely, so they aren't merged.
+ */
+class EngineFrameCoalescer {
+  public:
+	EngineFrameCoalescer();
+
+	void setBlobIds(const char header, const char command, const char deleteSprite);
+
+	/// Merge frames, oldest first, into out. Answers false if any frame can't be merged,
+	/// in which case out is garbage and the frames should be handled one at a time.
+	bool coalesce(const std::vector<const std::string*>& frames, std::string& out);
+
+  private:
+	struct Slice {
+		Slice()
+		  : mData(nullptr)
+		  , mSize(0) {}
+		Slice(const char* data, const size_t size)
+		  : mData(data)
+		  , mSize(size) {}
+
+		const char* mData;
+		size_t		mSize;
+	};
+
+	struct Blob {
+		char			mToken;
+		ds::sprite_id_t mId;
+		/// Deletions are copied through whole
+		Slice mRaw;
+		/// Sprite attribute ids and values, in the order they first appeared
+		std::vector<std::pair<char, Slice>> mAttributes;
+	};
+
+	bool  parseFrame(const std::string&);
+	bool  parseHeader(const char*& pos, const char* end);
+	bool  parseDelete(const char*& pos, const char* end);
+	bool  parseSprite(const char token, const char*& pos, const char* end);
+	Blob& pushBlob(const char token);
+	void  write(std::string& out) const;
+
+	char mHeaderId, mCommandId, mDeleteSpriteId;
+
+	std::vector<Slice> mHeaders;
+	/// Blobs are reused between calls so their attribute lists keep their allocations
+	std::vector<Blob> mBlobs;
+	size_t			  mBlobCount;
+	/// The blob each sprite's later attributes can still be merged into
+	std::unordered_map<ds::sprite_id_t, size_t> mOpen;
+	std::vector<std::pair<char, Slice>>			mScratch;
+};
+
+} // namespace ds
+
+#endif // DS_APP_ENGINE_ENGINEFRAMECOALESCER_H_
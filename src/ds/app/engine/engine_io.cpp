@@ -9,10 +9,18 @@
 #include "snappy.h"
 #include <cinder/Rand.h>
 
+#include <algorithm>
+#include <chrono>
+
 #include "ds/network/packet_chunker.h"
 
 namespace ds {
 
+namespace {
+	/// How long the receive thread waits on the socket at a time, which is as long as stopping it can take
+	const int RECEIVE_WAIT_MS = 50;
+} // namespace
+
 /**
  * \class EngineSender
  */
@@ -69,15 +77,86 @@ EngineReceiver::EngineReceiver(ds::NetConnection& con, const bool useChunker)
   : mConnection(con)
   , mHeaderId(0)
   , mCommandId(0)
+  , mDeleteSpriteId(0)
   , mHeaderAndCommandOnly(false)
   , mNoDataCount(0)
-  , mUseChunker(useChunker) {
+  , mFrameRing(4)
+  , mFrameRingHead(0)
+  , mFrameRingCount(0)
+  , mUseChunker(useChunker)
+  , mBytesCopied(0)
+  , mFramesHandled(0)
+  , mCoalesce(false)
+  , mCoalesceTried(false)
+  , mFramesCoalesced(0)
+  , mThreadRunning(false)
+  , mThreadInvalidChunk(false)
+  , mDecodedFrames(64)
+  , mRecycledFrames(64) {
 	setHeaderAndCommandOnly();
 }
 
+EngineReceiver::~EngineReceiver() {
+	stopThread();
+}
+
+void EngineReceiver::startThread() {
+	if (mThread) return;
+
+	mThreadRunning = true;
+	mThread.reset(new std::thread([this]() { threadLoop(); }));
+}
+
+void EngineReceiver::stopThread() {
+	if (!mThread) return;
+
+	mThreadRunning = false;
+	if (mThread->joinable()) mThread->join();
+	mThread.reset();
+
+	// Anything decoded but not collected is stale after a restart
+	std::string frame;
+	while (mDecodedFrames.pop(frame)) {
+	}
+	mThreadInvalidChunk = false;
+}
+
+void EngineReceiver::threadLoop() {
+	std::string frame;
+	while (mThreadRunning) {
+		bool received = false;
+
+		const bool valid = readConnection([this, &frame, &received](const char* data, size_t size) {
+			received = true;
+			mRecycledFrames.pop(frame);
+			if (!snappy::Uncompress(data, size, &frame)) return;
+
+			// If the main thread falls this far behind, wait for it rather than dropping frames
+			while (!mDecodedFrames.push(std::move(frame))) {
+				if (!mThreadRunning) return;
+				std::this_thread::sleep_for(std::chrono::milliseconds(1));
+			}
+		});
+		if (!valid) mThreadInvalidChunk = true;
+
+		// Sleep on the socket until the next packet, waking now and then to see if it's time to stop
+		if (!received) mConnection.waitForData(RECEIVE_WAIT_MS);
+	}
+}
+
 void EngineReceiver::setHeaderAndCommandIds(const char header, const char command) {
 	mHeaderId  = header;
 	mCommandId = command;
+	mCoalescer.setBlobIds(mHeaderId, mCommandId, mDeleteSpriteId);
+}
+
+void EngineReceiver::setDeleteSpriteId(const char id) {
+	mDeleteSpriteId = id;
+	mCoalescer.setBlobIds(mHeaderId, mCommandId, mDeleteSpriteId);
+}
+
+void EngineReceiver::setCoalesceFrames(const bool b) {
+	mCoalesce = b;
 }
 
 void EngineReceiver::setHeaderAndCommandOnly(const bool b) {
@@ -88,35 +167,55 @@ ds::DataBuffer& EngineReceiver::getData() {
 	return mCurrentDataBuffer;
 }
 
-bool EngineReceiver::receiveBlob(const bool strict) {
-	std::string recvBuffer;
+bool EngineReceiver::readConnection(const std::function<void(const char*, size_t)>& decode) {
+	const char* recvData = nullptr;
+	int			recvSize = 0;
 
 	if (mUseChunker) {
-		while (mConnection.recvMessage(recvBuffer)) {
-			mDechunker.addChunk(recvBuffer);
+		while ((recvSize = mConnection.recvMessage(recvData)) > 0) {
+			mDechunker.addChunk(recvData, static_cast<unsigned>(recvSize));
+			mBytesCopied += recvSize;
 		}
 
 		while (mDechunker.getAvailable() > 0) {
-			std::string outBuf;
-			bool		validy = mDechunker.getNextGroup(outBuf);
-
-			if (!validy) {
-				DS_LOG_WARNING_M("EngineReceiver: Invalid chunk received. Expect a new world frame shortly.",
-								 ds::IO_LOG);
-				return false;
-			}
-
-			snappy::Uncompress(outBuf.c_str(), outBuf.size(), &mCompressionBufferRead);
-			mReceiveBuffers.push_back(mCompressionBufferRead);
+			if (!mDechunker.getNextGroup(mChunkBuffer)) return false;
+			decode(mChunkBuffer.c_str(), mChunkBuffer.size());
 		}
 	} else {
-		while (mConnection.recvMessage(recvBuffer)) {
-			snappy::Uncompress(recvBuffer.c_str(), recvBuffer.size(), &mCompressionBufferRead);
-			mReceiveBuffers.push_back(mCompressionBufferRead);
+		while ((recvSize = mConnection.recvMessage(recvData)) > 0) {
+			decode(recvData, recvSize);
 		}
 	}
+	return true;
+}
+
+bool EngineReceiver::receiveBlob(const bool strict) {
+	// The current buffer may be viewing a ring slot that's about to be reused
+	mCurrentDataBuffer.clear();
+	mCoalesceTried = false;
+
+	bool valid = true;
+	if (mThread) {
+		// Swap decoded frames into the ring, and send the buffers they replace back to be reused
+		std::string decoded;
+		while (mDecodedFrames.pop(decoded)) {
+			pushFrame().swap(decoded);
+			mRecycledFrames.push(std::move(decoded));
+		}
+		valid = !mThreadInvalidChunk.exchange(false);
+	} else {
+		valid = readConnection([this](const char* data, size_t size) {
+			std::string& frame = pushFrame();
+			if (!snappy::Uncompress(data, size, &frame)) --mFrameRingCount;
+		});
+	}
 
-	if (mReceiveBuffers.empty()) {
+	if (!valid) {
+		DS_LOG_WARNING_M("EngineReceiver: Invalid chunk received. Expect a new world frame shortly.", ds::IO_LOG);
+		return false;
+	}
+
+	if (mFrameRingCount < 1) {
 		++mNoDataCount;
 		if (strict) {
 			return false;
@@ -127,7 +226,7 @@ bool EngineReceiver::receiveBlob(const bool strict) {
 }
 
 bool EngineReceiver::handleBlob(ds::BlobRegistry& registry, ds::BlobReader& reader, bool& morePacketsAvailable) {
-	if (mReceiveBuffers.empty()) {
+	if (mFrameRingCount < 1) {
 		++mNoDataCount;
 		morePacketsAvailable = false;
 		return false;
@@ -135,12 +234,19 @@ bool EngineReceiver::handleBlob(ds::BlobRegistry& registry, ds::BlobReader& read
 
 	mNoDataCount = 0;
 
-	mCurrentDataBuffer.clear();
-	mCurrentDataBuffer.addRaw(mReceiveBuffers.front().c_str(),
-							  static_cast<unsigned int>(mReceiveBuffers.front().size()));
-	mReceiveBuffers.erase(mReceiveBuffers.begin());
+	// Only try once per receive, the frames left over after a failure would most likely fail again
+	const bool coalesced =
+		mCoalesce && !mCoalesceTried && !mHeaderAndCommandOnly && mFrameRingCount > 1 && coalesceFrames();
+	if (!coalesced) {
+		// The slot stays untouched until the next receiveBlob(), so read it in place
+		const std::string& frame = mFrameRing[mFrameRingHead];
+		mCurrentDataBuffer.setReadView(frame.data(), static_cast<unsigned int>(frame.size()));
+		mFrameRingHead = (mFrameRingHead + 1) % mFrameRing.size();
+		--mFrameRingCount;
+		++mFramesHandled;
+	}
 
-	morePacketsAvailable = !mReceiveBuffers.empty();
+	morePacketsAvailable = mFrameRingCount > 0;
 
 	const char	 size		 = static_cast<char>(registry.mReader.size());
 	while (mCurrentDataBuffer.canRead<char>()) {
@@ -170,5 +276,48 @@ void EngineReceiver::clearLostConnection() {
 	mNoDataCount = 0;
 }
 
+int EngineReceiver::getBytesCopiedPerFrame() {
+	const int copied   = mBytesCopied.exchange(0);
+	const int perFrame = (mFramesHandled > 0) ? copied / mFramesHandled : copied;
+	mFramesHandled	   = 0;
+	return perFrame;
+}
+
+bool EngineReceiver::coalesceFrames() {
+	mCoalesceTried = true;
+	mCoalesceFrames.clear();
+	for (size_t k = 0; k < mFrameRingCount; ++k) {
+		mCoalesceFrames.push_back(&mFrameRing[(mFrameRingHead + k) % mFrameRing.size()]);
+	}
+
+	if (!mCoalescer.coalesce(mCoalesceFrames, mCoalescedFrame)) {
+		DS_LOG_VERBOSE(3, "EngineReceiver: " << mFrameRingCount << " waiting frames can't be merged, handling each");
+		return false;
+	}
+
+	DS_LOG_VERBOSE(3, "EngineReceiver: merged " << mFrameRingCount << " waiting frames");
+	mBytesCopied += static_cast<int>(mCoalescedFrame.size());
+	mFramesCoalesced += static_cast<int>(mFrameRingCount) - 1;
+	mFramesHandled += static_cast<int>(mFrameRingCount);
+	mFrameRingHead	= (mFrameRingHead + mFrameRingCount) % mFrameRing.size();
+	mFrameRingCount = 0;
+
+	mCurrentDataBuffer.setReadView(mCoalescedFrame.data(), static_cast<unsigned int>(mCoalescedFrame.size()));
+	return true;
+}
+
+std::string& EngineReceiver::pushFrame() {
+	if (mFrameRingCount == mFrameRing.size()) {
+		// Unroll the ring so the new slot goes at the end, after the oldest waiting frame
+		std::rotate(mFrameRing.begin(), mFrameRing.begin() + mFrameRingHead, mFrameRing.end());
+		mFrameRingHead = 0;
+		mFrameRing.emplace_back();
+	}
+
+	std::string& slot = mFrameRing[(mFrameRingHead + mFrameRingCount) % mFrameRing.size()];
+	++mFrameRingCount;
+	return slot;
+}
+
 
 } // namespace ds
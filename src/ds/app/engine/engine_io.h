@@ -2,10 +2,17 @@
 #ifndef DS_APP_ENGINE_ENGINEIO_H_
 #define DS_APP_ENGINE_ENGINEIO_H_
 
+#include "ds/app/engine/engine_frame_coalescer.h"
 #include "ds/data/data_buffer.h"
 #include "ds/network/net_connection.h"
 #include "ds/network/packet_chunker.h"
 #include "ds/query/recycle_array.h"
+#include "ds/thread/spsc_queue.h"
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <thread>
 
 /**
  * Hide the busy work of sending information between the server and client.
@@ -53,6 +60,14 @@ class EngineSender {
 class EngineReceiver {
   public:
 	EngineReceiver(ds::NetConnection&, const bool useChunker);
+	~EngineReceiver();
+
+	/// Move the socket reads, dechunking and decompression onto a dedicated thread.
+	/// Decoded frames are handed over through a lock-free queue, so receiveBlob() only
+	/// collects them. Stop the thread before renewing the connection.
+	void startThread();
+	void stopThread();
+	bool isThreaded() const { return mThread != nullptr; }
 
 	/// A bit of a hack -- every state can be set to listen
 	/// only for the header and command, or everything. This
@@ -60,6 +75,12 @@ class EngineReceiver {
 	/// when I'm not ready.
 	void setHeaderAndCommandIds(const char header, const char command);
 	void setHeaderAndCommandOnly(const bool = false);
+	/// Only needed for coalescing
+	void setDeleteSpriteId(const char);
+
+	/// When more than one frame is waiting, merge them all and handle the result as a single frame.
+	/// See EngineFrameCoalescer. Falls back to handling them one at a time if they can't be merged.
+	void setCoalesceFrames(const bool);
 
 	ds::DataBuffer& getData();
 	/// Convenience for clients with a blob reader, automatically
@@ -70,14 +91,29 @@ class EngineReceiver {
 	bool hasLostConnection() const;
 	void clearLostConnection();
 
+	/// For status: the average number of payload bytes copied per handled frame since the last call.
+	/// Decompression isn't counted, only straight copies (currently just chunk reassembly).
+	int getBytesCopiedPerFrame();
+	/// For status: the total number of frames that were merged into a later frame instead of being handled
+	int getFramesCoalesced() const { return mFramesCoalesced; }
+
   private:
+	/// Answer an empty frame slot at the back of the ring, growing it if every slot is waiting to be handled
+	std::string& pushFrame();
+	/// Pull everything off the connection and hand each decompressed frame to decode.
+	/// Answer false if an invalid chunk group was received.
+	bool readConnection(const std::function<void(const char*, size_t)>& decode);
+	void threadLoop();
+	/// Merge every waiting frame into mCoalescedFrame and read from it. Answer false if they can't be merged.
+	bool coalesceFrames();
+
 	ds::DataBuffer	   mCurrentDataBuffer;
 	ds::NetConnection& mConnection;
-	std::string		   mCompressionBufferRead;
-	std::string		   mCompressionBufferWrite;
+	/// Reassembled (but still compressed) chunk groups are decoded here
+	std::string mChunkBuffer;
 	/// The header and command blob IDs, used for filtering. The header
 	/// and command are always processed, but anything else depends on the state
-	char mHeaderId, mCommandId;
+	char mHeaderId, mCommandId, mDeleteSpriteId;
 	bool mHeaderAndCommandOnly;
 
 	/// Track when I try to receive but don't have any data. If this happens
@@ -86,10 +122,31 @@ class EngineReceiver {
 
 	/// Keep track of all the packets we receive.
 	/// This is in case we're running slower than the server,
-	/// in which case we can run through and update all the buffers at once and catch up
-	std::vector<std::string> mReceiveBuffers;
+	/// in which case we can run through and update all the buffers at once and catch up.
+	/// Frames are decompressed straight into a ring of slots that keep their allocations,
+	/// and mCurrentDataBuffer reads from the slot in place.
+	std::vector<std::string> mFrameRing;
+	size_t					 mFrameRingHead;
+	size_t					 mFrameRingCount;
 	ds::net::DeChunker		 mDechunker;
 	bool					 mUseChunker;
+
+	std::atomic<int> mBytesCopied;
+	int				 mFramesHandled;
+
+	EngineFrameCoalescer			mCoalescer;
+	std::vector<const std::string*> mCoalesceFrames;
+	std::string						mCoalescedFrame;
+	bool							mCoalesce;
+	bool							mCoalesceTried;
+	int								mFramesCoalesced;
+
+	/// Receive thread. Decoded frames go out, and handled frame buffers come back to be reused.
+	std::unique_ptr<std::thread> mThread;
+	std::atomic<bool>			 mThreadRunning;
+	std::atomic<bool>			 mThreadInvalidChunk;
+	ds::SpscQueue<std::string>	 mDecodedFrames;
+	ds::SpscQueue<std::string>	 mRecycledFrames;
 };
 
 } // namespace ds
@@ -20,17 +20,20 @@
 
 namespace ds {
 
-const char CMD_SERVER_SEND_WORLD	= 1;
-const char CMD_CLIENT_STARTED_REPLY = 2;
-const char CMD_CLIENT_STARTED		= 3;
-const char CMD_CLIENT_REQUEST_WORLD = 4;
-const char CMD_CLIENT_RUNNING		= 5;
-
-const char ATT_CLIENT	  = 1;
-const char ATT_GLOBAL_ID  = 2;
-const char ATT_SESSION_ID = 3;
-const char ATT_FRAME	  = 4;
-const char ATT_ROOTS	  = 5;
+const char CMD_SERVER_SEND_WORLD	   = 1;
+const char CMD_CLIENT_STARTED_REPLY	   = 2;
+const char CMD_CLIENT_STARTED		   = 3;
+const char CMD_CLIENT_REQUEST_WORLD	   = 4;
+const char CMD_CLIENT_RUNNING		   = 5;
+const char CMD_CLIENT_REQUEST_KEYFRAME = 6;
+
+const char ATT_CLIENT		  = 1;
+const char ATT_GLOBAL_ID	  = 2;
+const char ATT_SESSION_ID	  = 3;
+const char ATT_FRAME		  = 4;
+const char ATT_ROOTS		  = 5;
+const char ATT_BASELINE_FRAME = 6;
+const char ATT_KEYFRAME		  = 7;
 
 /**
  * \class EngineIoInfo
@@ -21,12 +21,17 @@ extern const char CMD_CLIENT_REQUEST_WORLD; // The client is requesting the enti
 
 extern const char CMD_CLIENT_RUNNING; // A general heartbeat from the client.
 
+extern const char CMD_CLIENT_REQUEST_KEYFRAME; // The client missed frames older than the delta baseline,
+											   /// and needs every attribute of the world resent in place.
+
 // ATTRIBUTES
-extern const char ATT_CLIENT;	  // Header for a client, which might have: ATT_GLOBAL_ID, ATT_SESSION_ID
-extern const char ATT_GLOBAL_ID;  // A string, which is a GUID
-extern const char ATT_SESSION_ID; // An int32, which is a client-unique ID
-extern const char ATT_FRAME;	  // A frame number
-extern const char ATT_ROOTS;	  // A list of the roots being sent from the server
+extern const char ATT_CLIENT;		  // Header for a client, which might have: ATT_GLOBAL_ID, ATT_SESSION_ID
+extern const char ATT_GLOBAL_ID;	  // A string, which is a GUID
+extern const char ATT_SESSION_ID;	  // An int32, which is a client-unique ID
+extern const char ATT_FRAME;		  // A frame number
+extern const char ATT_ROOTS;		  // A list of the roots being sent from the server
+extern const char ATT_BASELINE_FRAME; // Header: delta frames contain every change after this frame
+extern const char ATT_KEYFRAME;		  // Header: this frame contains every attribute of every sprite
 
 /**
  * \class EngineIoInfo
@@ -0,0 +1,95 @@
+#include "stdafx.h"
+
+#include "ds/app/engine/engine_replication.h"
+
+#include <algorithm>
+
+namespace ds {
+
+/**
+ * \class EngineReplicationHistory
+ */
+EngineReplicationHistory::EngineReplicationHistory()
+  : mBaselineFrame(-1)
+  , mMaxHistory(60) {}
+
+void EngineReplicationHistory::setMaxHistory(const int frames) {
+	mMaxHistory = static_cast<size_t>(std::max(frames, 1));
+}
+
+void EngineReplicationHistory::reset() {
+	mFrames.clear();
+	mPending.clear();
+	mPendingDeleted.clear();
+	mBaselineFrame = -1;
+}
+
+bool EngineReplicationHistory::beginFrame(const int32_t frame, const int32_t baselineFrame) {
+	bool dropped  = false;
+	bool overflow = false;
+
+	// Frames every client has acknowledged don't need to be sent again
+	if (baselineFrame > mBaselineFrame) mBaselineFrame = baselineFrame;
+	while (!mFrames.empty() && mFrames.front().mFrame <= mBaselineFrame) {
+		mFrames.pop_front();
+		dropped = true;
+	}
+
+	// A client that stops acknowledging can't hold the rest of them hostage. Drop the oldest
+	// attributes and let a keyframe cover them, but keep deletions around until they're acknowledged,
+	// since a keyframe can't tell a client a sprite is gone.
+	std::vector<ds::sprite_id_t> carriedDeletes;
+	while (!mFrames.empty() && mFrames.size() >= mMaxHistory) {
+		auto& oldest = mFrames.front();
+		carriedDeletes.insert(carriedDeletes.end(), oldest.mDeleted.begin(), oldest.mDeleted.end());
+		// The history no longer covers this frame, so a client that's behind it has to see a gap and ask for a keyframe
+		mBaselineFrame = std::max(mBaselineFrame, oldest.mFrame);
+		mFrames.pop_front();
+		dropped	 = true;
+		overflow = true;
+	}
+
+	mFrames.push_back(Frame(frame));
+	if (!carriedDeletes.empty()) {
+		auto& front = mFrames.front().mDeleted;
+		front.insert(front.begin(), carriedDeletes.begin(), carriedDeletes.end());
+	}
+
+	if (dropped) rebuildPending();
+
+	return !overflow;
+}
+
+ds::BitMask EngineReplicationHistory::getPending(const ds::sprite_id_t id) const {
+	auto found = mPending.find(id);
+	if (found == mPending.end()) return ds::BitMask::newEmpty();
+	return found->second;
+}
+
+void EngineReplicationHistory::record(const ds::sprite_id_t id, const ds::BitMask& dirty) {
+	if (dirty.isEmpty() || mFrames.empty()) return;
+
+	mFrames.back().mSprites[id] |= dirty;
+	mPending[id] |= dirty;
+}
+
+void EngineReplicationHistory::recordDeleted(const std::vector<ds::sprite_id_t>& ids) {
+	if (ids.empty() || mFrames.empty()) return;
+
+	auto& deleted = mFrames.back().mDeleted;
+	deleted.insert(deleted.end(), ids.begin(), ids.end());
+	mPendingDeleted.insert(mPendingDeleted.end(), ids.begin(), ids.end());
+}
+
+void EngineReplicationHistory::rebuildPending() {
+	mPending.clear();
+	mPendingDeleted.clear();
+	for (const auto& frame : mFrames) {
+		for (const auto& it : frame.mSprites) {
+			mPending[it.first] |= it.second;
+		}
+		mPendingDeleted.insert(mPendingDeleted.end(), frame.mDeleted.begin(), frame.mDeleted.end());
+	}
+}
+
+} // namespace ds
@@ -0,0 +1,72 @@
+#pragma once
+#ifndef DS_APP_ENGINE_ENGINEREPLICATION_H_
+#define DS_APP_ENGINE_ENGINEREPLICATION_H_
+
+#include <deque>
+#include <unordered_map>
+#include <vector>
+
+#include "ds/app/app_defs.h"
+#include "ds/util/bit_mask.h"
+
+namespace ds {
+
+/**
+ * \class EngineReplicationHistory
+ * \brief Used by the server in delta replication mode. Remembers which attributes each
+ * sprite has sent since the baseline (the newest frame every client has acknowledged),
+ * so every frame carries all changes since the baseline. A dropped packet is then repaired
+ * by the next frame, instead of forcing the whole world to be resent.
+ */
+class EngineReplicationHistory {
+  public:
+	EngineReplicationHistory();
+
+	/// How many unacknowledged frames to keep before giving up and asking for a keyframe
+	void	setMaxHistory(const int frames);
+	int32_t getBaselineFrame() const { return mBaselineFrame; }
+
+	/// Forget everything, such as when the whole world is sent to every client.
+	void reset();
+
+	/// Start recording frame. Anything at or before the baseline has been received by every client and is dropped.
+	/// Answers false if the history overflowed, in which case a keyframe should be sent this frame. The baseline then
+	/// moves up to the newest frame dropped, so clients behind it see the gap and ask for a keyframe themselves.
+	bool beginFrame(const int32_t frame, const int32_t baselineFrame);
+
+	/// The attributes this sprite has sent after the baseline frame
+	ds::BitMask getPending(const ds::sprite_id_t) const;
+	/// Record the attributes this sprite is sending in the current frame
+	void record(const ds::sprite_id_t, const ds::BitMask&);
+
+	/// Record sprites deleted in the current frame
+	void recordDeleted(const std::vector<ds::sprite_id_t>&);
+	/// All sprites deleted after the baseline frame
+	const std::vector<ds::sprite_id_t>& getPendingDeleted() const { return mPendingDeleted; }
+
+	/// Number of frames currently waiting to be acknowledged
+	size_t getFrameCount() const { return mFrames.size(); }
+
+  private:
+	void rebuildPending();
+
+	struct Frame {
+		Frame(const int32_t frame)
+		  : mFrame(frame) {}
+
+		int32_t											mFrame;
+		std::unordered_map<ds::sprite_id_t, ds::BitMask> mSprites;
+		std::vector<ds::sprite_id_t>					mDeleted;
+	};
+
+	std::deque<Frame>								 mFrames;
+	/// Union of every frame in mFrames, so lookups during a write are a single hash
+	std::unordered_map<ds::sprite_id_t, ds::BitMask> mPending;
+	std::vector<ds::sprite_id_t>					 mPendingDeleted;
+	int32_t											 mBaselineFrame;
+	size_t											 mMaxHistory;
+};
+
+} // namespace ds
+
+#endif // DS_APP_ENGINE_ENGINEREPLICATION_H_
@@ -35,7 +35,8 @@ OrthRoot::OrthRoot(Engine& e, const RootList::Root& r, const sprite_id_t id)
   , mSrcRect(0.0f, 0.0f, -1.0f, -1.0f)
   , mDstRect(0.0f, 0.0f, -1.0f, -1.0f)
   , mNearPlane(-1.0f)
-  , mFarPlane(1.0f) {
+  , mFarPlane(1.0f)
+  , mPickIndexed(r.mPickIndexed || e.getEngineSettings().getBool("touch:pick_index")) {
 	mSprite->setSecondBeforeIdle(mEngine.getEngineSettings().getDouble("idle_time"));
 }
 
@@ -99,6 +100,7 @@ void OrthRoot::drawServer(const DrawParams& p) {
 }
 
 ui::Sprite* OrthRoot::getHit(const ci::vec3& point) {
+	if (mPickIndexed) return mSprite->getIndexedHit(point);
 	return mSprite->getHit(point);
 }
 
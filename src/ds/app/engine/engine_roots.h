@@ -109,6 +109,9 @@ class OrthRoot : public EngineRoot {
 	/// The drawing distance near and far, default = -1 and 1
 	float mNearPlane;
 	float mFarPlane;
+
+	/// Pick with Sprite::getIndexedHit()
+	bool mPickIndexed;
 };
 
 /**
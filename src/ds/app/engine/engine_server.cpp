@@ -8,6 +8,7 @@
 #include "ds/content/content_wrangler.h"
 #include "ds/debug/computer_info.h"
 #include "ds/debug/logger.h"
+#include "ds/query/sql_connection_pool.h"
 #include "ds/util/string_util.h"
 #include <ds/app/engine/engine_io_defs.h>
 
@@ -40,8 +41,13 @@ AbstractEngineServer::AbstractEngineServer(ds::App& app, ds::EngineSettings& set
   , mReceiver(mReceiveConnection, false)
   , mBlobReader(mReceiver.getData(), *this)
   , mContentWrangler(nullptr)
+  , mDeltaReplication(settings.getBool("server:delta_replication", 0, false))
+  , mKeyframeInterval(settings.getInt("server:keyframe_interval", 0, 300))
   , mState(nullptr) {
 
+	mReplicationHistory.setMaxHistory(settings.getInt("server:delta_history", 0, 60));
+	mWorldWriter.setThreadCount(settings.getInt("server:write_threads", 0, 0));
+
 	// NOTE:  Must be EXACTLY the same items as in EngineClient, in same order,
 	// so that the BLOB ids match.
 	HEADER_BLOB		   = mBlobRegistry.add([this](BlobReader& r) { receiveHeader(r.mDataBuffer); });
@@ -91,6 +97,7 @@ void AbstractEngineServer::setup(ds::App& app) {
 void AbstractEngineServer::update() {
 	mComputerInfo->update();
 	mWorkManager.update();
+	ds::query::SqlConnectionPool::closeIdle();
 	updateServer();
 
 	mState->update(*this);
@@ -117,6 +124,10 @@ int AbstractEngineServer::getBytesSent() {
 	return mSendConnection.getSentBytes();
 }
 
+int AbstractEngineServer::getBytesCopiedPerFrame() {
+	return mReceiver.getBytesCopiedPerFrame();
+}
+
 void AbstractEngineServer::receiveHeader(ds::DataBuffer& data) {
 	char id;
 	while (data.canRead<char>() && (id = data.read<char>()) != ds::TERMINATOR_CHAR) {
@@ -135,6 +146,9 @@ void AbstractEngineServer::receiveCommand(ds::DataBuffer& data) {
 		} else if (cmd == CMD_CLIENT_REQUEST_WORLD) {
 			DS_LOG_INFO_M("CMD_CLIENT_REQUEST_WORLD", ds::IO_LOG);
 			setState(mSendWorldState);
+		} else if (cmd == CMD_CLIENT_REQUEST_KEYFRAME) {
+			DS_LOG_INFO_M("CMD_CLIENT_REQUEST_KEYFRAME", ds::IO_LOG);
+			mRunningState.requestKeyframe();
 		} else if (cmd == CMD_SERVER_SEND_WORLD) {
 			DS_LOG_INFO_M("CMD_SERVER_SEND_WORLD", ds::IO_LOG);
 			DS_LOG_ERROR_M("Multiple servers: This app is running in server mode, but has received a command sent from "
@@ -256,6 +270,19 @@ void AbstractEngineServer::onClientRunningCommand(ds::DataBuffer& data) {
 	mClients.reportingIn(session_id, frame);
 }
 
+void AbstractEngineServer::writeWorld(ds::DataBuffer& data, const bool all) {
+	mWorldRoots.clear();
+	const size_t numRoots = getRootCount();
+	for (size_t i = 0; i < numRoots; i++) {
+		if (!getRootBuilder(i).mSyncronize) continue;
+		ds::ui::Sprite& rooty = getRootSprite(i);
+		if (all) rooty.markTreeAsDirty();
+		mWorldRoots.push_back(&rooty);
+	}
+
+	mWorldWriter.write(mWorldRoots, data);
+}
+
 void AbstractEngineServer::setState(State& s) {
 	if (&s == mState) return;
 
@@ -289,19 +316,36 @@ void AbstractEngineServer::State::addHeader(ds::DataBuffer& data, const int fram
 	data.add(ds::TERMINATOR_CHAR);
 }
 
+void AbstractEngineServer::State::addHeader(ds::DataBuffer& data, const int frame, const int32_t baselineFrame,
+											const bool keyframe) {
+	data.add(HEADER_BLOB);
+
+	data.add(frame);
+	data.add(ATT_BASELINE_FRAME);
+	data.add(baselineFrame);
+	if (keyframe) data.add(ATT_KEYFRAME);
+	data.add(ds::TERMINATOR_CHAR);
+}
+
 /**
  * EngineServer::RunningState
  */
 EngineServer::RunningState::RunningState()
-  : mFrame(0) {
+  : mFrame(0)
+  , mLastKeyframe(0)
+  , mKeyframeRequested(false) {
 	mDeletedSprites.reserve(128);
 }
 
 void EngineServer::RunningState::begin(AbstractEngineServer& engine) {
 	DS_LOG_INFO_M("RunningState", ds::IO_LOG);
 	engine.getNotifier().notify(ds::app::EngineStateEvent(ds::app::EngineStateEvent::ENGINE_STATE_CLIENT_RUNNING));
-	mFrame = 0;
+	mFrame			   = 0;
+	mLastKeyframe	   = 0;
+	mKeyframeRequested = false;
 	mDeletedSprites.clear();
+	// Every client just received the whole world, so there's nothing older to repair
+	engine.mReplicationHistory.reset();
 }
 
 void EngineServer::RunningState::update(AbstractEngineServer& engine) {
@@ -313,22 +357,18 @@ void EngineServer::RunningState::update(AbstractEngineServer& engine) {
 	}
 
 	// Send data to clients
-	{
+	if (engine.mDeltaReplication) {
+		EngineSender::AutoSend send(engine.mSender);
+		writeDeltaFrame(engine, send.mData);
+	} else {
 		EngineSender::AutoSend send(engine.mSender);
 		// Always send the header
 		addHeader(send.mData, mFrame);
 
-		const size_t numRoots = engine.getRootCount();
-		for (int i = 0; i < numRoots; i++) {
-			if (!engine.getRootBuilder(i).mSyncronize) continue;
-			ds::ui::Sprite& rooty = engine.getRootSprite(i);
-			if (rooty.isDirty()) {
-				rooty.writeTo(send.mData);
-			}
-		}
+		engine.writeWorld(send.mData, false);
 
 		if (!mDeletedSprites.empty()) {
-			addDeletedSprites(send.mData);
+			addDeletedSprites(send.mData, mDeletedSprites);
 			mDeletedSprites.clear();
 		}
 	}
@@ -362,17 +402,52 @@ void EngineServer::RunningState::spriteDeleted(const ds::sprite_id_t& id) {
 	} catch (std::exception const&) {}
 }
 
-void EngineServer::RunningState::addDeletedSprites(ds::DataBuffer& data) const {
-	if (mDeletedSprites.empty()) return;
+void EngineServer::RunningState::requestKeyframe() {
+	mKeyframeRequested = true;
+}
+
+void EngineServer::RunningState::addDeletedSprites(ds::DataBuffer& data, const std::vector<sprite_id_t>& ids) const {
+	if (ids.empty()) return;
 
 	data.add(DELETE_SPRITE_BLOB);
-	data.add(mDeletedSprites.size());
-	for (auto it = mDeletedSprites.begin(), end = mDeletedSprites.end(); it != end; ++it) {
+	data.add(ids.size());
+	for (auto it = ids.begin(), end = ids.end(); it != end; ++it) {
 		data.add(*it);
 	}
 	data.add(ds::TERMINATOR_CHAR);
 }
 
+void EngineServer::RunningState::writeDeltaFrame(AbstractEngineServer& engine, ds::DataBuffer& data) {
+	EngineReplicationHistory& history  = engine.mReplicationHistory;
+	const int32_t			  baseline = engine.mClients.getAcknowledgedFrame(mFrame);
+
+	bool keyframe = mKeyframeRequested;
+	if (!history.beginFrame(mFrame, baseline)) {
+		DS_LOG_VERBOSE(1, "Delta replication history overflowed, sending a keyframe");
+		keyframe = true;
+	}
+	if (engine.mKeyframeInterval > 0 && mFrame - mLastKeyframe >= engine.mKeyframeInterval) {
+		keyframe = true;
+	}
+	if (keyframe) {
+		mLastKeyframe	   = mFrame;
+		mKeyframeRequested = false;
+	}
+
+	addHeader(data, mFrame, history.getBaselineFrame(), keyframe);
+
+	const size_t numRoots = engine.getRootCount();
+	for (size_t i = 0; i < numRoots; i++) {
+		if (!engine.getRootBuilder(i).mSyncronize) continue;
+		engine.getRootSprite(i).writeDeltaTo(data, history, keyframe);
+	}
+
+	// Deletions are resent until every client has acknowledged them; deleting a missing sprite is harmless.
+	history.recordDeleted(mDeletedSprites);
+	mDeletedSprites.clear();
+	addDeletedSprites(data, history.getPendingDeleted());
+}
+
 /**
  * EngineServer::ClientStartedReplyState
  */
@@ -462,13 +537,7 @@ void EngineServer::SendWorldState::update(AbstractEngineServer& engine) {
 		send.mData.add(CMD_SERVER_SEND_WORLD);
 		send.mData.add(ds::TERMINATOR_CHAR);
 
-		const size_t numRoots = engine.getRootCount();
-		for (size_t i = 0; i < numRoots; i++) {
-			if (!engine.getRootBuilder(i).mSyncronize) continue;
-			ds::ui::Sprite& rooty = engine.getRootSprite(i);
-			rooty.markTreeAsDirty();
-			rooty.writeTo(send.mData);
-		}
+		engine.writeWorld(send.mData, true);
 	}
 
 	engine.setState(engine.mRunningState);
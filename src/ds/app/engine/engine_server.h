@@ -6,6 +6,8 @@
 #include "ds/app/engine/engine.h"
 #include "ds/app/engine/engine_client_list.h"
 #include "ds/app/engine/engine_io.h"
+#include "ds/app/engine/engine_replication.h"
+#include "ds/app/engine/engine_world_writer.h"
 #include "ds/network/udp_connection.h"
 
 namespace ds {
@@ -36,6 +38,8 @@ class AbstractEngineServer : public Engine {
 
 	virtual int getBytesRecieved();
 	virtual int getBytesSent();
+	virtual int getBytesCopiedPerFrame();
+	virtual int getFramesCoalesced() { return 0; }
 
   private:
 	void receiveHeader(ds::DataBuffer&);
@@ -59,6 +63,17 @@ class AbstractEngineServer : public Engine {
 	ds::BlobReader	  mBlobReader;
 	ContentWrangler*  mContentWrangler;
 
+	/// Delta replication: every frame resends all changes since the newest frame
+	/// every client has acknowledged, with periodic keyframes of the whole world.
+	bool					 mDeltaReplication;
+	int32_t					 mKeyframeInterval;
+	EngineReplicationHistory mReplicationHistory;
+
+	/// Writes full (non-delta) frames, optionally on a pool of threads
+	EngineWorldWriter			 mWorldWriter;
+	std::vector<ds::ui::Sprite*> mWorldRoots;
+	void						 writeWorld(ds::DataBuffer&, const bool all);
+
 	/// STATES
 	class State {
 	  public:
@@ -69,6 +84,8 @@ class AbstractEngineServer : public Engine {
 
 	  protected:
 		void addHeader(ds::DataBuffer&, const int frame);
+		/// Delta replication header, which also tells the clients what the frame is relative to.
+		void addHeader(ds::DataBuffer&, const int frame, const int32_t baselineFrame, const bool keyframe);
 	};
 
 	/* Default state: Gathers all changes in the app and sends them out each frame.
@@ -80,12 +97,18 @@ class AbstractEngineServer : public Engine {
 		virtual void update(AbstractEngineServer&);
 		virtual void spriteDeleted(const ds::sprite_id_t&);
 
+		/// A client has missed frames older than the delta baseline, send everything next frame.
+		void requestKeyframe();
+
 		std::vector<sprite_id_t> mDeletedSprites;
 
 	  private:
-		void addDeletedSprites(ds::DataBuffer&) const;
+		void addDeletedSprites(ds::DataBuffer&, const std::vector<sprite_id_t>&) const;
+		void writeDeltaFrame(AbstractEngineServer&, ds::DataBuffer&);
 
 		int32_t mFrame;
+		int32_t mLastKeyframe;
+		bool	mKeyframeRequested;
 	};
 
 	/* This state is used to send a client started reply.
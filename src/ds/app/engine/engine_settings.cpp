@@ -174,6 +174,29 @@ void EngineSettings::setDefaults() {
 		"server:listen_port", 0, ds::cfg::SETTING_TYPE_INT,
 		"The listen port of the server (which is what the client sends on). Match these between server and client.",
 		"1038", "1", "99999");
+	getSetting("server:receive_thread", 0, ds::cfg::SETTING_TYPE_BOOL,
+			   "Clients receive, reassemble and decompress world frames on a dedicated thread, so the main thread "
+			   "only applies them.",
+			   "true");
+	getSetting("server:coalesce_frames", 0, ds::cfg::SETTING_TYPE_BOOL,
+			   "When a client falls behind, it merges the waiting world frames and applies only the newest value of "
+			   "each sprite attribute, instead of replaying every frame. Only read by clients.",
+			   "false");
+	getSetting("server:delta_replication", 0, ds::cfg::SETTING_TYPE_BOOL,
+			   "Each frame the server resends every change since the last frame all clients acknowledged, so a lost "
+			   "packet is repaired on the next frame instead of resending the whole world. Only read by the server.",
+			   "false");
+	getSetting("server:keyframe_interval", 0, ds::cfg::SETTING_TYPE_INT,
+			   "With delta replication, how many frames between keyframes that resend every sprite attribute. 0 only "
+			   "sends keyframes when a client falls too far behind.",
+			   "300", "0", "100000");
+	getSetting("server:delta_history", 0, ds::cfg::SETTING_TYPE_INT,
+			   "With delta replication, how many unacknowledged frames to keep before sending a keyframe instead.", "60",
+			   "1", "10000");
+	getSetting("server:write_threads", 0, ds::cfg::SETTING_TYPE_INT,
+			   "Extra threads the server uses to write big branches of the world in parallel. 0 writes on the main "
+			   "thread. Not used with delta replication. Only read by the server.",
+			   "0", "0", "64");
 	getSetting("platform:architecture", 0, ds::cfg::SETTING_TYPE_STRING,
 			   "If this is a server (world engine), a client (render engine) or both (world + render). clientserver is "
 			   "an EngineClientServer, which both displays content and can control other instances. standalone does "
@@ -185,6 +208,21 @@ void EngineSettings::setDefaults() {
 			   "If the xml importer should cache xml content or reload from disk each time", "true");
 	getSetting("xml_importer:target", 0, ds::cfg::SETTING_TYPE_STRING,
 			   "target for xml importer target properties to match", "default");
+	getSetting("pdf:tiled_render", 0, ds::cfg::SETTING_TYPE_BOOL,
+			   "Pdf sprites zoomed in past pdf:tile_preview_size draw the whole page at that size first, then the part "
+			   "on screen sharp in tiles on the tile threads",
+			   "false");
+	getSetting("pdf:tile_preview_size", 0, ds::cfg::SETTING_TYPE_INT,
+			   "Longest side in pixels of the whole page drawn by tiled pdf sprites", "2048", "256", "12000");
+	getSetting("pdf:tile_size", 0, ds::cfg::SETTING_TYPE_INT, "Width and height in pixels of pdf tiles", "512", "64",
+			   "4096");
+	getSetting("pdf:tile_cache_megabytes", 0, ds::cfg::SETTING_TYPE_INT,
+			   "How much texture memory each tiled pdf sprite can keep in tiles", "256", "1", "8192");
+	getSetting("pdf:tile_threads", 0, ds::cfg::SETTING_TYPE_INT, "Number of threads to spawn for drawing pdf tiles",
+			   "2", "1", "16");
+	getSetting("video:zero_copy", 0, ds::cfg::SETTING_TYPE_BOOL,
+			   "Video sprites upload frames straight from the decoder's buffers instead of copying each one first",
+			   "false");
 
 	getSetting("WINDOW SETTINGS", 0, ds::cfg::SETTING_TYPE_SECTION_HEADER, "");
 	getSetting("span_all_displays", 0, ds::cfg::SETTING_TYPE_BOOL,
@@ -220,6 +258,10 @@ void EngineSettings::setDefaults() {
 			   "Attempts to align frame rate with the refresh rate of the monitor. Note that this could be overriden "
 			   "by the graphic card",
 			   "true");
+	getSetting("update:skip_idle_sprites", 0, ds::cfg::SETTING_TYPE_BOOL,
+			   "Only update branches of sprites that contain a sprite that asked for updates. Sprites that do work in "
+			   "onUpdateServer() or onUpdateClient() need to call setWantsUpdates(true) to keep getting them.",
+			   "false");
 	getSetting("auto_hide_mouse", 0, ds::cfg::SETTING_TYPE_BOOL,
 			   "True=automatically hide the mouse when mouse hasn't been moved, false=use hide_mouse setting", "true");
 	getSetting("hide_mouse", 0, ds::cfg::SETTING_TYPE_BOOL, "False=cursor visible, true=no visible cursor.", "false");
@@ -240,8 +282,26 @@ void EngineSettings::setDefaults() {
 			   "True will keep all images in GPU memory until the app exits. False only caches the images loaded with "
 			   "the cache flag",
 			   "false");
+	getSetting("load_image:persist_metadata", 0, ds::cfg::SETTING_TYPE_BOOL,
+			   "Keep image sizes in %LOCAL%/cache/image_metadata.sqlite, so the next run doesn't have to read every "
+			   "image's header again. Entries are checked against the file's modified time before they're used.",
+			   "true");
 	getSetting("font_scale", 0, ds::cfg::SETTING_TYPE_FLOAT, "text sprites with scale font values by this amount",
 			   "1.3333333333333", "0.001", "1000.0");
+	getSetting("text:async_render", 0, ds::cfg::SETTING_TYPE_BOOL,
+			   "Lay out and render text sprites on the text threads, so changing text doesn't hold up the frame. Text "
+			   "sprites keep showing their previous text until the new one is ready.",
+			   "false");
+	getSetting("text:render_threads", 0, ds::cfg::SETTING_TYPE_INT, "Number of threads to spawn for async text", "1",
+			   "1", "16");
+	getSetting("text:cache", 0, ds::cfg::SETTING_TYPE_BOOL,
+			   "Share rendered text between text sprites with the same text and style, and keep it around for a while "
+			   "after it's gone from the screen",
+			   "true");
+	getSetting("text:cache_megabytes", 0, ds::cfg::SETTING_TYPE_INT,
+			   "How much texture memory unused text can take up in the text cache", "64", "0", "4096");
+	getSetting("text:cache_entries", 0, ds::cfg::SETTING_TYPE_INT, "How many texts the text cache can hold", "4096",
+			   "0", "1000000");
 
 	getSetting("TOUCH SETTINGS", 0, ds::cfg::SETTING_TYPE_SECTION_HEADER, "");
 	getSetting("touch:mode", 0, ds::cfg::SETTING_TYPE_STRING,
@@ -262,6 +322,10 @@ void EngineSettings::setDefaults() {
 	getSetting("touch:filter_rect", 0, ds::cfg::SETTING_TYPE_RECT,
 			   "Any touches started outside this rect will be ignored, in world space. Set to 0, 0, 0, 0 to ignore.",
 			   "0, 0, 0, 0");
+	getSetting("touch:pick_index", 0, ds::cfg::SETTING_TYPE_BOOL,
+			   "Ortho roots cache the bounds of every branch of sprites, and skip the branches a touch is outside of. "
+			   "Same as RootList::pickIndexed() for every root.",
+			   "false");
 	getSetting("touch:debug", 0, ds::cfg::SETTING_TYPE_BOOL, "Draw circles around touch points ", "true");
 	getSetting("touch:debug_circle_radius", 0, ds::cfg::SETTING_TYPE_FLOAT, "Visual settings for touch debug circles.",
 			   "15", "1", "100");
@@ -310,6 +374,15 @@ void EngineSettings::setDefaults() {
 			   "%APP%/data/model/content_model.xml");
 	getSetting("content:use_wrangler", 0, ds::cfg::SETTING_TYPE_BOOL,
 			   " If ContentWrangler should be used to automatically grab data", "false");
+	getSetting("content:query_threads", 0, ds::cfg::SETTING_TYPE_INT,
+			   "Extra threads ContentWrangler uses to read the tables in the data model at the same time. 0 reads them "
+			   "one after another.",
+			   "3", "0", "64");
+	getSetting("content:incremental", 0, ds::cfg::SETTING_TYPE_BOOL,
+			   "When the content changes, patch the changed rows into the content that's already loaded instead of "
+			   "replacing all of it, and list what changed in the ContentUpdatedEvent. No event is sent if nothing "
+			   "changed.",
+			   "false");
 	getSetting("auto_refresh_app", 0, ds::cfg::SETTING_TYPE_BOOL,
 			   "Listen to directory changes and auto soft-restart the app.", "false");
 	getSetting("auto_refresh_directories", 0, ds::cfg::SETTING_TYPE_STRING,
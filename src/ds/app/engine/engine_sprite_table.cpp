@@ -0,0 +1,124 @@
+#include "stdafx.h"
+
+#include "ds/app/engine/engine_sprite_table.h"
+
+#include <cstdint>
+
+#include "ds/debug/logger.h"
+
+namespace ds {
+
+namespace {
+	const int	   SLOT_BITS	  = 20;
+	const uint32_t SLOT_MASK	  = (1u << SLOT_BITS) - 1;
+	const uint32_t GENERATION_MAX = 0x7fffffffu >> SLOT_BITS;
+	/// The low bits hold the slot index + 1, so an id is never 0
+	const size_t MAX_SLOTS = SLOT_MASK;
+	const size_t MIN_FREE  = 1024;
+
+	ds::sprite_id_t make_id(const int slot, const uint32_t generation) {
+		return static_cast<ds::sprite_id_t>((generation << SLOT_BITS) | static_cast<uint32_t>(slot + 1));
+	}
+} // namespace
+
+/**
+ * \class EngineSpriteTable
+ */
+EngineSpriteTable::EngineSpriteTable()
+  : mCount(0) {}
+
+int EngineSpriteTable::slotIndex(const ds::sprite_id_t id) {
+	if (id <= ds::EMPTY_SPRITE_ID) return -1;
+	const uint32_t low = static_cast<uint32_t>(id) & SLOT_MASK;
+	if (low == 0) return -1;
+	return static_cast<int>(low) - 1;
+}
+
+ds::sprite_id_t EngineSpriteTable::allocate() {
+	int slot = -1;
+	if (mFree.size() >= MIN_FREE || mSlots.size() >= MAX_SLOTS) {
+		while (!mFree.empty() && slot < 0) {
+			const int index = mFree.front();
+			mFree.pop_front();
+			// A client could have inserted a server's id here in the meantime
+			if (!mSlots[index].mInUse) slot = index;
+		}
+	}
+
+	uint32_t generation = 0;
+	if (slot >= 0) {
+		generation = (static_cast<uint32_t>(mSlots[slot].mId) >> SLOT_BITS) + 1;
+		if (generation > GENERATION_MAX) generation = 0;
+	} else if (mSlots.size() < MAX_SLOTS) {
+		slot = static_cast<int>(mSlots.size());
+		mSlots.emplace_back();
+	} else {
+		DS_LOG_ERROR_M("EngineSpriteTable::allocate() out of sprite ids", ds::ENGINE_LOG);
+		return ds::EMPTY_SPRITE_ID;
+	}
+
+	Slot& s		 = mSlots[slot];
+	s.mId		 = make_id(slot, generation);
+	s.mSprite	 = nullptr;
+	s.mInUse	 = true;
+	s.mAllocated = true;
+	return s.mId;
+}
+
+void EngineSpriteTable::insert(const ds::sprite_id_t id, ds::ui::Sprite* sprite) {
+	if (!sprite) return;
+
+	const int index = slotIndex(id);
+	if (index >= 0) {
+		// Clients insert whatever ids the server sends, so the table grows to fit them
+		if (static_cast<size_t>(index) >= mSlots.size()) mSlots.resize(index + 1);
+
+		Slot& s = mSlots[index];
+		if (!s.mInUse || s.mId == id) {
+			if (!mOverflow.empty() && mOverflow.erase(id) > 0) --mCount;
+			if (!s.mSprite) ++mCount;
+			if (s.mId != id) s.mAllocated = false;
+			s.mId	  = id;
+			s.mSprite = sprite;
+			s.mInUse  = true;
+			return;
+		}
+	}
+
+	ds::ui::Sprite*& found = mOverflow[id];
+	if (!found) ++mCount;
+	found = sprite;
+}
+
+void EngineSpriteTable::erase(const ds::sprite_id_t id) {
+	const int index = slotIndex(id);
+	if (index >= 0 && static_cast<size_t>(index) < mSlots.size()) {
+		Slot& s = mSlots[index];
+		if (s.mInUse && s.mId == id) {
+			if (s.mSprite) --mCount;
+			s.mSprite = nullptr;
+			s.mInUse  = false;
+			// Only slots I handed out get handed out again
+			if (s.mAllocated) mFree.push_back(index);
+			s.mAllocated = false;
+			return;
+		}
+	}
+
+	if (!mOverflow.empty() && mOverflow.erase(id) > 0) --mCount;
+}
+
+ds::ui::Sprite* EngineSpriteTable::find(const ds::sprite_id_t id) const {
+	const int index = slotIndex(id);
+	if (index >= 0 && static_cast<size_t>(index) < mSlots.size()) {
+		const Slot& s = mSlots[index];
+		if (s.mInUse && s.mId == id) return s.mSprite;
+	}
+
+	if (mOverflow.empty()) return nullptr;
+	auto it = mOverflow.find(id);
+	if (it == mOverflow.end()) return nullptr;
+	return it->second;
+}
+
+} // namespace ds
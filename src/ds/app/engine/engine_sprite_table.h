@@ -0,0 +1,69 @@
+#pragma once
+#ifndef DS_APP_ENGINE_ENGINESPRITETABLE_H_
+#define DS_APP_ENGINE_ENGINESPRITETABLE_H_
+
+#include <deque>
+#include <unordered_map>
+#include <vector>
+
+#include "ds/app/app_defs.h"
+
+namespace ds {
+namespace ui {
+	class Sprite;
+}
+
+/**
+ * \class EngineSpriteTable
+ * \brief The engine's sprite id lookup. Ids handed out by allocate() are a slot index in the low
+ * bits and a generation in the high bits, so a lookup is an array index plus a compare, and an id
+ * that outlives its sprite never finds the sprite that reused the slot.
+ * Ids are still just positive ints on the wire. Anything that doesn't fit a free slot (ids from a
+ * server that counts up, roots, a slot still held by a sprite a client hasn't deleted yet) goes
+ * into an overflow map instead, so any id works.
+ */
+class EngineSpriteTable {
+  public:
+	EngineSpriteTable();
+
+	/// A new id, which stays reserved until it's inserted and then erased
+	ds::sprite_id_t allocate();
+
+	void			insert(const ds::sprite_id_t, ds::ui::Sprite*);
+	void			erase(const ds::sprite_id_t);
+	ds::ui::Sprite* find(const ds::sprite_id_t) const;
+
+	size_t size() const { return mCount; }
+	bool   empty() const { return mCount == 0; }
+
+  private:
+	struct Slot {
+		Slot()
+		  : mId(ds::EMPTY_SPRITE_ID)
+		  , mSprite(nullptr)
+		  , mInUse(false)
+		  , mAllocated(false) {}
+
+		/// Kept after the slot is freed, so the next id can bump its generation
+		ds::sprite_id_t mId;
+		ds::ui::Sprite* mSprite;
+		bool			mInUse;
+		/// Handed out by allocate(), rather than inserted with an id from somewhere else
+		bool mAllocated;
+	};
+
+	/// Answer the slot for id, or -1 if it can't have one
+	static int slotIndex(const ds::sprite_id_t);
+
+	std::vector<Slot> mSlots;
+	/// Freed slots are reused oldest first, and only once enough have piled up, so a client
+	/// has usually deleted a sprite before a new one shows up with its slot.
+	std::deque<int> mFree;
+
+	std::unordered_map<ds::sprite_id_t, ds::ui::Sprite*> mOverflow;
+	size_t												 mCount;
+};
+
+} // namespace ds
+
+#endif // DS_APP_ENGINE_ENGINESPRITETABLE_H_
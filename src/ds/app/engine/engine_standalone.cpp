@@ -6,6 +6,7 @@
 #include "ds/content/content_wrangler.h"
 #include "ds/debug/computer_info.h"
 #include "ds/debug/logger.h"
+#include "ds/query/sql_connection_pool.h"
 
 using namespace ci;
 using namespace ci::app;
@@ -51,6 +52,7 @@ void EngineStandalone::setup(ds::App& app) {
 
 void EngineStandalone::update() {
 	mWorkManager.update();
+	ds::query::SqlConnectionPool::closeIdle();
 	mComputerInfo->update();
 	updateServer();
 }
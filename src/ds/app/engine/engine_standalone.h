@@ -30,6 +30,8 @@ class EngineStandalone : public Engine {
 
 	virtual int getBytesRecieved() { return 0; }
 	virtual int getBytesSent() { return 0; }
+	virtual int getBytesCopiedPerFrame() { return 0; }
+	virtual int getFramesCoalesced() { return 0; }
 
   private:
 	virtual void handleMouseTouchBegin(const ci::app::MouseEvent&, int id);
@@ -0,0 +1,148 @@
+#include "stdafx.h"
+
+#include "ds/app/engine/engine_world_writer.h"
+
+#include "ds/ui/sprite/sprite.h"
+
+namespace ds {
+
+namespace {
+	/// Roots and their children are written on the calling thread, grandchildren and below are tasks
+	const int SPLIT_DEPTH = 2;
+	/// No point waking the threads for less than this
+	const size_t MIN_TASKS = 2;
+} // namespace
+
+/**
+ * \class EngineWorldWriter
+ */
+EngineWorldWriter::EngineWorldWriter()
+  : mSegmentCount(0)
+  , mNextTask(0)
+  , mTasksDone(0)
+  , mOpen(false)
+  , mStop(false)
+  , mBatch(0)
+  , mBusy(0) {}
+
+EngineWorldWriter::~EngineWorldWriter() {
+	stopThreads();
+}
+
+void EngineWorldWriter::setThreadCount(const int count) {
+	if (count == getThreadCount()) return;
+
+	stopThreads();
+	for (int i = 0; i < count; ++i) {
+		mThreads.emplace_back([this] { threadLoop(); });
+	}
+}
+
+void EngineWorldWriter::stopThreads() {
+	if (mThreads.empty()) return;
+
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		mStop = true;
+	}
+	mStart.notify_all();
+	for (auto it = mThreads.begin(), end = mThreads.end(); it != end; ++it) {
+		it->join();
+	}
+	mThreads.clear();
+	mStop = false;
+}
+
+void EngineWorldWriter::write(const std::vector<ds::ui::Sprite*>& roots, ds::DataBuffer& data) {
+	mSegmentCount = 0;
+	mTasks.clear();
+	for (auto it = roots.begin(), end = roots.end(); it != end; ++it) {
+		if (*it) split(**it, 0);
+	}
+
+	mNextTask  = 0;
+	mTasksDone = 0;
+	if (mThreads.empty() || mTasks.size() < MIN_TASKS) {
+		runTasks();
+	} else {
+		{
+			std::lock_guard<std::mutex> lock(mMutex);
+			mOpen = true;
+			++mBatch;
+		}
+		mStart.notify_all();
+
+		runTasks();
+
+		std::unique_lock<std::mutex> lock(mMutex);
+		mFinished.wait(lock, [this] { return mTasksDone >= mTasks.size() && mBusy == 0; });
+		mOpen = false;
+	}
+
+	for (size_t i = 0; i < mSegmentCount; ++i) {
+		data.addBuffer(*mSegments[i]);
+	}
+}
+
+void EngineWorldWriter::split(ds::ui::Sprite& sprite, const int depth) {
+	if (depth >= SPLIT_DEPTH) {
+		nextSegment();
+		mTasks.push_back(Task(&sprite, mSegmentCount - 1));
+		return;
+	}
+
+	// Nothing below me has changed
+	if (!sprite.writeSelfTo(nextSegment())) return;
+
+	const std::vector<ds::ui::Sprite*> children = sprite.getChildren();
+	for (auto it = children.begin(), end = children.end(); it != end; ++it) {
+		split(**it, depth + 1);
+	}
+}
+
+ds::DataBuffer& EngineWorldWriter::nextSegment() {
+	if (mSegmentCount >= mSegments.size()) mSegments.push_back(std::make_unique<ds::DataBuffer>());
+
+	ds::DataBuffer& segment = *mSegments[mSegmentCount++];
+	segment.clear();
+	return segment;
+}
+
+void EngineWorldWriter::runTasks() {
+	const size_t count = mTasks.size();
+	while (true) {
+		const size_t index = mNextTask++;
+		if (index >= count) return;
+
+		const Task& task = mTasks[index];
+		task.mSprite->writeTo(*mSegments[task.mSegment]);
+		if (++mTasksDone == count) {
+			// Take the lock so the notify can't slip in between the caller's check and its wait
+			std::lock_guard<std::mutex> lock(mMutex);
+			mFinished.notify_all();
+		}
+	}
+}
+
+void EngineWorldWriter::threadLoop() {
+	unsigned batch = 0;
+	while (true) {
+		{
+			std::unique_lock<std::mutex> lock(mMutex);
+			mStart.wait(lock, [this, batch] { return mStop || (mOpen && mBatch != batch); });
+			if (mStop) return;
+			batch = mBatch;
+			++mBusy;
+		}
+
+		runTasks();
+
+		{
+			std::lock_guard<std::mutex> lock(mMutex);
+			--mBusy;
+		}
+		mFinished.notify_all();
+	}
+}
+
+} // namespace ds
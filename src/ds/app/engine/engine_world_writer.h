@@ -0,0 +1,80 @@
+#pragma once
+#ifndef DS_APP_ENGINE_ENGINEWORLDWRITER_H_
+#define DS_APP_ENGINE_ENGINEWORLDWRITER_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "ds/data/data_buffer.h"
+
+namespace ds {
+namespace ui {
+	class Sprite;
+}
+
+/**
+ * \class EngineWorldWriter
+ * \brief Writes the dirty sprites of the world for the server, with the big branches written on a pool of
+ * threads. The top of each root is written on the calling thread, and everything below it is split into
+ * branches that are each written into their own buffer. The buffers are appended in tree order, so the
+ * result is exactly what Sprite::writeTo() on each root would write.
+ * Sprites must not be changed on another thread while this runs, and their writeAttributesTo() can't touch
+ * anything shared with other sprites.
+ */
+class EngineWorldWriter {
+  public:
+	EngineWorldWriter();
+	~EngineWorldWriter();
+
+	/// Threads that write alongside the calling thread. 0 writes everything on the calling thread.
+	void setThreadCount(const int);
+	int	 getThreadCount() const { return static_cast<int>(mThreads.size()); }
+
+	/// Same as calling writeTo() on each root in order
+	void write(const std::vector<ds::ui::Sprite*>& roots, ds::DataBuffer&);
+
+  private:
+	EngineWorldWriter(const EngineWorldWriter&);
+	EngineWorldWriter& operator=(const EngineWorldWriter&);
+
+	struct Task {
+		Task(ds::ui::Sprite* s, const size_t segment)
+		  : mSprite(s)
+		  , mSegment(segment) {}
+
+		ds::ui::Sprite* mSprite;
+		size_t			mSegment;
+	};
+
+	/// Write the top levels of the tree now, and leave the branches below them as tasks
+	void			split(ds::ui::Sprite&, const int depth);
+	ds::DataBuffer& nextSegment();
+	void			runTasks();
+	void			threadLoop();
+	void			stopThreads();
+
+	/// Everything written, in order. Kept between frames so the buffers keep their size.
+	std::vector<std::unique_ptr<ds::DataBuffer>> mSegments;
+	size_t										 mSegmentCount;
+	std::vector<Task>							 mTasks;
+	std::atomic<size_t>							 mNextTask;
+	std::atomic<size_t>							 mTasksDone;
+
+	std::vector<std::thread> mThreads;
+	std::mutex				 mMutex;
+	std::condition_variable	 mStart;
+	std::condition_variable	 mFinished;
+	/// Threads only pick up tasks while a batch is open, so the next batch can be set up without a lock
+	bool	 mOpen;
+	bool	 mStop;
+	unsigned mBatch;
+	int		 mBusy;
+};
+
+} // namespace ds
+
+#endif // DS_APP_ENGINE_ENGINEWORLDWRITER_H_
@@ -36,6 +36,17 @@ namespace {
 
 	static const int SETTINGS_INCREMENT = 200;
 
+	/// Bits for the types a Setting has cached
+	enum CachedType {
+		CACHED_BOOL	  = 1 << 0,
+		CACHED_INT	  = 1 << 1,
+		CACHED_FLOAT  = 1 << 2,
+		CACHED_DOUBLE = 1 << 3,
+		CACHED_VECTOR = 1 << 4,
+		CACHED_RECT	  = 1 << 5,
+		CACHED_COLOR  = 1 << 6
+	};
+
 	static std::vector<std::string> SETTING_TYPES;
 
 	void initialize_types() {
@@ -59,6 +70,7 @@ namespace {
 
 	static void
 	merge_settings(std::vector<std::pair<std::string, std::vector<ds::cfg::Settings::Setting>>>&	   dst,
+				   std::unordered_map<std::string, size_t>&											   dstIndices,
 				   const std::vector<std::pair<std::string, std::vector<ds::cfg::Settings::Setting>>>& src) {
 
 		int highestReadIndex = 0;
@@ -73,58 +85,57 @@ namespace {
 
 		for (auto sit : src) {
 			bool found = false;
-			for (auto& dit : dst) {
-				if (dit.first == sit.first) {
-
-					int thisReadIndex = 0;
-					for (int i = 0; i < sit.second.size(); i++) {
-						if (i < dit.second.size()) {
-							bool sourceEmpty  = dit.second[i].mSource.empty();
-							bool valueChanged = dit.second[i].mRawValue != sit.second[i].mRawValue;
-							bool isChange	  = sourceEmpty || valueChanged;
-
-							if (isChange) {
-								if (!sourceEmpty) {
-									int readIndex			 = dit.second[i].mReadIndex;
-									sit.second[i].mReadIndex = readIndex;
-									if (readIndex > thisReadIndex) thisReadIndex = readIndex;
-								}
-
-								if (sit.second[i].mComment.empty() && !dit.second[i].mComment.empty()) {
-									sit.second[i].mComment = dit.second[i].mComment;
-								}
-								if (sit.second[i].mType == "unknown") {
-									sit.second[i].mType = dit.second[i].mType;
-								}
-								if (sit.second[i].mDefault.empty()) {
-									sit.second[i].mDefault = dit.second[i].mDefault;
-								}
-								if (sit.second[i].mMinValue.empty()) {
-									sit.second[i].mMinValue = dit.second[i].mMinValue;
-								}
-								if (sit.second[i].mMaxValue.empty()) {
-									sit.second[i].mMaxValue = dit.second[i].mMaxValue;
-								}
-								if (sit.second[i].mPossibleValues.empty()) {
-									sit.second[i].mPossibleValues = dit.second[i].mPossibleValues;
-								}
-
-								dit.second[i] = sit.second[i];
+			auto findy = dstIndices.find(sit.first);
+			if (findy != dstIndices.end()) {
+				auto& dit = dst[findy->second];
+
+				int thisReadIndex = 0;
+				for (int i = 0; i < sit.second.size(); i++) {
+					if (i < dit.second.size()) {
+						bool sourceEmpty  = dit.second[i].mSource.empty();
+						bool valueChanged = dit.second[i].mRawValue != sit.second[i].mRawValue;
+						bool isChange	  = sourceEmpty || valueChanged;
+
+						if (isChange) {
+							if (!sourceEmpty) {
+								int readIndex			 = dit.second[i].mReadIndex;
+								sit.second[i].mReadIndex = readIndex;
+								if (readIndex > thisReadIndex) thisReadIndex = readIndex;
 							}
 
-						} else {
-							dit.second.emplace_back(sit.second[i]);
-							if (thisReadIndex > 0) {
-								dit.second.back().mReadIndex = thisReadIndex;
-								thisReadIndex += 1;
+							if (sit.second[i].mComment.empty() && !dit.second[i].mComment.empty()) {
+								sit.second[i].mComment = dit.second[i].mComment;
+							}
+							if (sit.second[i].mType == "unknown") {
+								sit.second[i].mType = dit.second[i].mType;
+							}
+							if (sit.second[i].mDefault.empty()) {
+								sit.second[i].mDefault = dit.second[i].mDefault;
+							}
+							if (sit.second[i].mMinValue.empty()) {
+								sit.second[i].mMinValue = dit.second[i].mMinValue;
+							}
+							if (sit.second[i].mMaxValue.empty()) {
+								sit.second[i].mMaxValue = dit.second[i].mMaxValue;
 							}
+							if (sit.second[i].mPossibleValues.empty()) {
+								sit.second[i].mPossibleValues = dit.second[i].mPossibleValues;
+							}
+
+							dit.second[i] = sit.second[i];
+						}
+
+					} else {
+						dit.second.emplace_back(sit.second[i]);
+						if (thisReadIndex > 0) {
+							dit.second.back().mReadIndex = thisReadIndex;
+							thisReadIndex += 1;
 						}
 					}
+				}
 
 
-					found = true;
-					break;
-				}
+				found = true;
 			}
 
 			if (!found) {
@@ -133,6 +144,7 @@ namespace {
 					highestReadIndex += SETTINGS_INCREMENT;
 				}
 
+				dstIndices.emplace(sit.first, dst.size());
 				dst.emplace_back(sit);
 			}
 		}
@@ -140,28 +152,52 @@ namespace {
 
 } // namespace
 
+bool Settings::Setting::isCached(const unsigned int type) const {
+	if (mCache.mParsedValue != mRawValue) {
+		mCache.mParsedValue = mRawValue;
+		mCache.mTypes		= 0;
+	}
+
+	if ((mCache.mTypes & type) != 0) return true;
+	mCache.mTypes |= type;
+	return false;
+}
+
 bool Settings::Setting::getBool() const {
-	return parseBoolean(mRawValue);
+	std::lock_guard<std::mutex> lock(mCache.mMutex);
+	if (!isCached(CACHED_BOOL)) mCache.mBool = parseBoolean(mRawValue);
+	return mCache.mBool;
 }
 
 int Settings::Setting::getInt() const {
-	return ds::string_to_int(mRawValue);
+	std::lock_guard<std::mutex> lock(mCache.mMutex);
+	if (!isCached(CACHED_INT)) mCache.mInt = ds::string_to_int(mRawValue);
+	return mCache.mInt;
 }
 
 float Settings::Setting::getFloat() const {
-	return ds::string_to_float(mRawValue);
+	std::lock_guard<std::mutex> lock(mCache.mMutex);
+	if (!isCached(CACHED_FLOAT)) mCache.mFloat = ds::string_to_float(mRawValue);
+	return mCache.mFloat;
 }
 
 double Settings::Setting::getDouble() const {
-	return ds::string_to_double(mRawValue);
+	std::lock_guard<std::mutex> lock(mCache.mMutex);
+	if (!isCached(CACHED_DOUBLE)) mCache.mDouble = ds::string_to_double(mRawValue);
+	return mCache.mDouble;
 }
 
 const ci::Color Settings::Setting::getColor(ds::ui::SpriteEngine& eng) const {
-	return ds::parseColor(mRawValue, eng);
+	return ci::Color(getColorA(eng));
 }
 
 const ci::ColorA Settings::Setting::getColorA(ds::ui::SpriteEngine& eng) const {
-	return ds::parseColor(mRawValue, eng);
+	// Named colors can be changed in the engine at any time, so only hex values are kept
+	if (mRawValue.empty() || mRawValue[0] != '#') return ds::parseColor(mRawValue, eng);
+
+	std::lock_guard<std::mutex> lock(mCache.mMutex);
+	if (!isCached(CACHED_COLOR)) mCache.mColor = ds::parseColor(mRawValue, eng);
+	return mCache.mColor;
 }
 
 const std::string& Settings::Setting::getString() const {
@@ -173,15 +209,19 @@ const std::wstring Settings::Setting::getWString() const {
 }
 
 const ci::vec2 Settings::Setting::getVec2() const {
-	return ci::vec2(parseVector(mRawValue));
+	return ci::vec2(getVec3());
 }
 
 const ci::vec3 Settings::Setting::getVec3() const {
-	return parseVector(mRawValue);
+	std::lock_guard<std::mutex> lock(mCache.mMutex);
+	if (!isCached(CACHED_VECTOR)) mCache.mVec = parseVector(mRawValue);
+	return mCache.mVec;
 }
 
 const cinder::Rectf Settings::Setting::getRect() const {
-	return parseRect(mRawValue);
+	std::lock_guard<std::mutex> lock(mCache.mMutex);
+	if (!isCached(CACHED_RECT)) mCache.mRect = parseRect(mRawValue);
+	return mCache.mRect;
 }
 
 std::vector<std::string> Settings::Setting::getPossibleValues() const {
@@ -192,15 +232,13 @@ std::vector<std::string> Settings::Setting::getPossibleValues() const {
 void Settings::Setting::replaceSettingVariablesAndExpressions() {
 
 	auto		testValue = mRawValue;
-	std::string value	  = ds::cfg::SettingsVariables::replaceVariables(testValue);
-	value				  = ds::cfg::SettingsVariables::parseAllExpressions(value);
+	std::string value	  = ds::cfg::SettingsVariables::replaceVariablesAndExpressions(testValue);
 	if (value != mRawValue) {
 		// save the originalRawValue
 		mOriginalValue = mRawValue;
 		mRawValue	   = value;
 	} else if (!mOriginalValue.empty()) {
-		std::string value = ds::cfg::SettingsVariables::replaceVariables(mOriginalValue);
-		value			  = ds::cfg::SettingsVariables::parseAllExpressions(value);
+		std::string value = ds::cfg::SettingsVariables::replaceVariablesAndExpressions(mOriginalValue);
 		mRawValue		  = value;
 	}
 }
@@ -210,8 +248,43 @@ Settings::Settings()
 	initialize_types();
 }
 
+/**
+ * \class Settings::Handle
+ */
+Settings::Handle::Handle()
+  : mSettings(nullptr)
+  , mIndex(0)
+  , mSlot(0)
+  , mSlotIndex(0) {}
+
+Settings::Handle::Handle(Settings& settings, const std::string& name, const int index,
+						 const std::string& defaultRawValue)
+  : mSettings(&settings)
+  , mName(name)
+  , mIndex(index)
+  , mDefault(defaultRawValue)
+  , mSlot(0)
+  , mSlotIndex(0) {
+	mSettings->findOrCreateSetting(mName, mIndex, mDefault, mSlot, mSlotIndex);
+}
+
+Settings::Setting& Settings::Handle::get() {
+	if (!mSettings) {
+		static Setting EMPTY;
+		EMPTY = Setting();
+		return EMPTY;
+	}
+
+	// Clearing or replacing the settings can leave something else, or nothing, where the setting was
+	auto& all = mSettings->mSettings;
+	if (mSlot < all.size() && mSlotIndex < all[mSlot].second.size() && all[mSlot].first == mName) {
+		return all[mSlot].second[mSlotIndex];
+	}
+	return mSettings->findOrCreateSetting(mName, mIndex, mDefault, mSlot, mSlotIndex);
+}
+
 void Settings::mergeSettings(const Settings& mergeIn) {
-	merge_settings(mSettings, mergeIn.mSettings);
+	merge_settings(mSettings, mSettingIndices, mergeIn.mSettings);
 }
 
 void Settings::readFrom(const std::string& filename, const bool append) {
@@ -223,7 +296,7 @@ void Settings::readFrom(const std::string& filename, const bool append) {
 	Settings s;
 	s.directReadFrom(filename, false);
 
-	merge_settings(mSettings, s.mSettings);
+	merge_settings(mSettings, mSettingIndices, s.mSettings);
 }
 
 void Settings::readFrom(ci::XmlTree& tree, const std::string& filename, const bool append,
@@ -236,7 +309,7 @@ void Settings::readFrom(ci::XmlTree& tree, const std::string& filename, const bo
 	Settings s;
 	s.directReadFromXml(tree, filename, false, engPtr);
 
-	merge_settings(mSettings, s.mSettings);
+	merge_settings(mSettings, mSettingIndices, s.mSettings);
 }
 
 void Settings::directReadFrom(const std::string& filename, const bool clearAll) {
@@ -312,7 +385,7 @@ void Settings::directReadFromXml(ci::XmlTree& tree, const std::string& reference
 		} else {
 			std::vector<Setting> newSettingVec;
 			newSettingVec.push_back(theSetting);
-			mSettings.emplace_back(std::pair<std::string, std::vector<Setting>>(theName, newSettingVec));
+			appendSettings(theName, newSettingVec);
 		}
 	}
 }
@@ -382,6 +455,7 @@ bool Settings::empty() const {
 
 void Settings::clear() {
 	mSettings.clear();
+	mSettingIndices.clear();
 }
 
 
@@ -391,6 +465,7 @@ const bool Settings::getBool(const std::string& name, const int index) {
 
 const bool Settings::getBool(const std::string& name, const int index, const bool defaultValue) {
 	/// std::to_string was converting bool to int and returning 1 or 0
+	if (auto setting = findSetting(name, index)) return setting->getBool();
 	std::string defaultString = "false";
 	if (defaultValue) defaultString = "true";
 	return getSetting(name, index, defaultString).getBool();
@@ -401,6 +476,7 @@ const int Settings::getInt(const std::string& name, const int index) {
 }
 
 const int Settings::getInt(const std::string& name, const int index, const int defaultValue) {
+	if (auto setting = findSetting(name, index)) return setting->getInt();
 	return getSetting(name, index, std::to_string(defaultValue)).getInt();
 }
 
@@ -409,6 +485,7 @@ const float Settings::getFloat(const std::string& name, const int index) {
 }
 
 const float Settings::getFloat(const std::string& name, const int index, const float defaultValue) {
+	if (auto setting = findSetting(name, index)) return setting->getFloat();
 	return getSetting(name, index, std::to_string(defaultValue)).getFloat();
 }
 
@@ -417,6 +494,7 @@ const double Settings::getDouble(const std::string& name, const int index) {
 }
 
 const double Settings::getDouble(const std::string& name, const int index, const double defaultValue) {
+	if (auto setting = findSetting(name, index)) return setting->getDouble();
 	return getSetting(name, index, std::to_string(defaultValue)).getDouble();
 }
 
@@ -426,6 +504,7 @@ const ci::Color Settings::getColor(ds::ui::SpriteEngine& engine, const std::stri
 
 const ci::Color Settings::getColor(ds::ui::SpriteEngine& engine, const std::string& name, const int index,
 								   const ci::Color& defaultValue) {
+	if (auto setting = findSetting(name, index)) return setting->getColor(engine);
 	return getSetting(name, index, ds::unparseColor(defaultValue)).getColor(engine);
 }
 
@@ -435,6 +514,7 @@ const ci::ColorA Settings::getColorA(ds::ui::SpriteEngine& engine, const std::st
 
 const ci::ColorA Settings::getColorA(ds::ui::SpriteEngine& engine, const std::string& name, const int index,
 									 const ci::ColorA& defaultValue) {
+	if (auto setting = findSetting(name, index)) return setting->getColorA(engine);
 	return getSetting(name, index, ds::unparseColor(defaultValue)).getColorA(engine);
 }
 
@@ -451,6 +531,7 @@ const std::wstring Settings::getWString(const std::string& name, const int index
 }
 
 const std::wstring Settings::getWString(const std::string& name, const int index, const std::wstring& defaultValue) {
+	if (auto setting = findSetting(name, index)) return setting->getWString();
 	return getSetting(name, index, ds::utf8_from_wstr(defaultValue)).getWString();
 }
 
@@ -459,6 +540,7 @@ const ci::vec2 Settings::getVec2(const std::string& name, const int index) {
 }
 
 const ci::vec2 Settings::getVec2(const std::string& name, const int index, const ci::vec2& defaultValue) {
+	if (auto setting = findSetting(name, index)) return setting->getVec2();
 	return getSetting(name, index, ds::unparseVector(defaultValue)).getVec2();
 }
 
@@ -467,6 +549,7 @@ const ci::vec3 Settings::getVec3(const std::string& name, const int index) {
 }
 
 const ci::vec3 Settings::getVec3(const std::string& name, const int index, const ci::vec3& defaultValue) {
+	if (auto setting = findSetting(name, index)) return setting->getVec3();
 	return getSetting(name, index, ds::unparseVector(defaultValue)).getVec3();
 }
 
@@ -475,6 +558,7 @@ const cinder::Rectf Settings::getRect(const std::string& name, const int index)
 }
 
 const cinder::Rectf Settings::getRect(const std::string& name, const int index, const ci::Rectf& defaultValue) {
+	if (auto setting = findSetting(name, index)) return setting->getRect();
 	return getSetting(name, index, ds::unparseRect(defaultValue)).getRect();
 }
 
@@ -508,27 +592,36 @@ std::vector<ds::cfg::Settings::Setting>& Settings::getReadSortedSettings() {
 }
 
 bool Settings::hasSetting(const std::string& name) const {
-	for (auto it : mSettings) {
-		if (it.first == name) return true;
-	}
-
-	return false;
+	return mSettingIndices.find(name) != mSettingIndices.end();
 }
 
 size_t Settings::countSetting(const std::string& name) const {
-	for (auto it : mSettings) {
-		if (it.first == name) return it.second.size();
-	}
+	auto findy = mSettingIndices.find(name);
+	if (findy == mSettingIndices.end()) return 0;
 
-	return 0;
+	return mSettings[findy->second].second.size();
 }
 
 int Settings::getSettingIndex(const std::string& name) const {
-	for (int i = 0; i < mSettings.size(); i++) {
-		if (mSettings[i].first == name) return i;
-	}
+	auto findy = mSettingIndices.find(name);
+	if (findy == mSettingIndices.end()) return -1;
+
+	return static_cast<int>(findy->second);
+}
+
+void Settings::appendSettings(const std::string& name, const std::vector<Setting>& settings) {
+	// Like the old linear search, a name always finds its first entry
+	mSettingIndices.emplace(name, mSettings.size());
+	mSettings.emplace_back(std::pair<std::string, std::vector<Setting>>(name, settings));
+}
+
+ds::cfg::Settings::Setting* Settings::findSetting(const std::string& name, const int index) {
+	auto findy = mSettingIndices.find(name);
+	if (findy == mSettingIndices.end() || index < 0) return nullptr;
 
-	return -1;
+	auto& theVec = mSettings[findy->second].second;
+	if (index >= theVec.size()) return nullptr;
+	return &theVec[index];
 }
 
 void Settings::forEachSetting(const std::function<void(Setting&)>& func, const std::string& typeFilter /*= ""*/) {
@@ -545,10 +638,19 @@ ds::cfg::Settings::Setting& Settings::getSetting(const std::string& name, const
 
 ds::cfg::Settings::Setting& Settings::getSetting(const std::string& name, const int index,
 												 const std::string& defaultRawValue) {
+	size_t slot = 0, slotIndex = 0;
+	return findOrCreateSetting(name, index, defaultRawValue, slot, slotIndex);
+}
+
+ds::cfg::Settings::Setting& Settings::findOrCreateSetting(const std::string& name, const int index,
+														  const std::string& defaultRawValue, size_t& slot,
+														  size_t& slotIndex) {
 	auto settingIndex = getSettingIndex(name);
 
 	if (settingIndex > -1 && index > -1 && !mSettings[settingIndex].second.empty() &&
 		index < mSettings[settingIndex].second.size()) {
+		slot	  = settingIndex;
+		slotIndex = index;
 		return mSettings[settingIndex].second[index];
 	}
 
@@ -559,8 +661,10 @@ ds::cfg::Settings::Setting& Settings::getSetting(const std::string& name, const
 	settings.back().mRawValue  = defaultRawValue;
 	settings.back().mReadIndex = mReadIndex;
 	mReadIndex += SETTINGS_INCREMENT;
-	mSettings.emplace_back(std::pair<std::string, std::vector<Setting>>(name, settings));
+	appendSettings(name, settings);
 
+	slot	  = mSettings.size() - 1;
+	slotIndex = 0;
 	return mSettings.back().second.back();
 }
 
@@ -580,6 +684,10 @@ ds::cfg::Settings::Setting& Settings::getSetting(const std::string& name, const
 	return theSetting;
 }
 
+Settings::Handle Settings::getHandle(const std::string& name, const int index, const std::string& defaultRawValue) {
+	return Handle(*this, name, index, defaultRawValue);
+}
+
 void Settings::addSetting(const Setting& newSetting) {
 	auto settingIndex = getSettingIndex(newSetting.mName);
 
@@ -588,8 +696,7 @@ void Settings::addSetting(const Setting& newSetting) {
 	} else {
 		std::vector<Setting> theSettings;
 		theSettings.push_back(newSetting);
-		auto hintInsert = mSettings.end();
-		mSettings.insert(hintInsert, std::pair<std::string, std::vector<Setting>>(newSetting.mName, theSettings));
+		appendSettings(newSetting.mName, theSettings);
 	}
 }
 
@@ -1,6 +1,8 @@
 #pragma once
 
 #include <map>
+#include <mutex>
+#include <unordered_map>
 #include <vector>
 
 #include <cinder/Color.h>
@@ -51,7 +53,8 @@ class Settings {
 		  : mType(SETTING_TYPE_UNKNOWN)
 		  , mReadIndex(-1){};
 
-		/// Type conversion happens at read time for all getters
+		/// Type conversion happens the first time a value is read as a type, and is redone only after mRawValue
+		/// changes. The getters can be called from any thread, as long as nothing is writing mRawValue meanwhile
 		bool   getBool() const;
 		int	   getInt() const;
 		float  getFloat() const;
@@ -107,7 +110,81 @@ class Settings {
 
 		/// an id that's auto-assigned to this setting to determine overall sort order
 		unsigned int mReadIndex;
+
+	  private:
+		/// Values converted from mParsedValue, the raw value when they were converted. mRawValue can be written
+		/// directly from anywhere, so they're dropped as soon as it doesn't match.
+		struct Cache {
+			Cache()
+			  : mTypes(0)
+			  , mBool(false)
+			  , mInt(0)
+			  , mFloat(0.0f)
+			  , mDouble(0.0) {}
+
+			/// The mutex can't be copied, so a copy starts empty and converts again the first time it's read
+			Cache(const Cache&)
+			  : Cache() {}
+			Cache& operator=(const Cache&) {
+				std::lock_guard<std::mutex> lock(mMutex);
+				mTypes = 0;
+				return *this;
+			}
+
+			/// Held while checking and filling the cache, since settings get read from worker threads too
+			std::mutex	 mMutex;
+			std::string	 mParsedValue;
+			unsigned int mTypes;
+			bool		 mBool;
+			int			 mInt;
+			float		 mFloat;
+			double		 mDouble;
+			ci::vec3	 mVec;
+			ci::Rectf	 mRect;
+			ci::ColorA	 mColor;
+		};
+
+		/// Answers true if the type bit was already cached for the current value, otherwise marks it cached.
+		/// Call with mCache.mMutex locked
+		bool isCached(const unsigned int type) const;
+
+		mutable Cache mCache;
+	};
+
+	/**
+	 * \class Handle
+	 * \brief Finds a setting once, so reading it afterwards doesn't look up the name again.
+	 * Looks the setting up again if the settings it came from are cleared, reloaded or replaced.
+	 * The settings have to outlive the handle.
+	 */
+	class Handle {
+	  public:
+		Handle();
+		Handle(Settings&, const std::string& name, const int index = 0, const std::string& defaultRawValue = "");
+
+		bool valid() const { return mSettings != nullptr; }
+
+		/// The setting, created with the default value if it doesn't exist
+		Setting& get();
+
+		bool			   getBool() { return get().getBool(); }
+		int				   getInt() { return get().getInt(); }
+		float			   getFloat() { return get().getFloat(); }
+		double			   getDouble() { return get().getDouble(); }
+		const std::string& getString() { return get().getString(); }
+		const ci::vec2	   getVec2() { return get().getVec2(); }
+		const ci::vec3	   getVec3() { return get().getVec3(); }
+		const ci::Rectf	   getRect() { return get().getRect(); }
+
+	  private:
+		Settings*	mSettings;
+		std::string mName;
+		int			mIndex;
+		std::string mDefault;
+		size_t		mSlot;
+		size_t		mSlotIndex;
 	};
+
 	/// static method to merge settings
 	void mergeSettings(const Settings& mergeIn);
 
@@ -209,6 +286,9 @@ class Settings {
 						const std::string& minValue = "", const std::string& maxValue = "",
 						const std::string& possibleValues = "");
 
+	/// A handle for reading a setting repeatedly, e.g. every frame. Creates the setting if it doesn't exist.
+	Handle getHandle(const std::string& name, const int index = 0, const std::string& defaultRawValue = "");
+
 	/// Appends the setting to the end of the setting list.
 	/// Note: set mReadIndex correctly if you want to insert this new setting inside the overall list
 	void addSetting(const Setting& newSetting);
@@ -261,10 +341,21 @@ class Settings {
 	/// getSetting() calls)
 	std::vector<std::pair<std::string, std::vector<Setting>>> mSettings;
 
+	/// The index in mSettings of each setting name
+	std::unordered_map<std::string, size_t> mSettingIndices;
+
 	std::string			 mName;
 	unsigned int		 mReadIndex;
 	std::vector<Setting> mSortedSettings; // rebuilt every call of getReadSortedIndex()
 
+	/// The setting with this name and index, or nullptr
+	Setting* findSetting(const std::string& name, const int index);
+	/// The setting, which is created if it doesn't exist (see getSetting()), and where it is in mSettings
+	Setting& findOrCreateSetting(const std::string& name, const int index, const std::string& defaultRawValue,
+								 size_t& slot, size_t& slotIndex);
+	/// Adds a new name to the end of mSettings
+	void appendSettings(const std::string& name, const std::vector<Setting>&);
+
 	/// Used in the read function
 	void directReadFrom(const std::string& filename, const bool clear);
 	void directReadFromXml(ci::XmlTree& tree, const std::string& referenceFilename, const bool clear,
@@ -24,6 +24,8 @@
 #include <ds/debug/computer_info.h>
 #include <ds/debug/logger.h>
 #include <ds/math/math_defs.h>
+#include <ds/ui/service/load_image_service.h>
+#include <ds/ui/service/pango_font_service.h>
 #include <ds/util/color_util.h>
 
 // Select the platform specific implementation OS verion / app version / product name
@@ -298,16 +300,24 @@ void SettingsEditor::drawAppStatusInfo() {
 	// No need for these to change every single frame
 	if (ci::app::getElapsedFrames() % 8 == 0) {
 		mSpriteCount	= int(eng.mSprites.size());
+		mSpritesUpdated = mEngine.getSpritesUpdated();
 		mTouchMode		= ds::ui::TouchMode::toString(eng.mTouchMode);
 		mPhysicalMemory = mEngine.getComputerInfo().getPhysicalMemoryUsedByProcess();
 		mVirtualMemory	= mEngine.getComputerInfo().getVirtualMemoryUsedByProcess();
 
 		if (mEngine.getMode() != ds::ui::SpriteEngine::STANDALONE_MODE) {
-			mBytesReceived = mEngine.getBytesRecieved();
-			mBytesSent	   = mEngine.getBytesSent();
+			mBytesReceived	 = mEngine.getBytesRecieved();
+			mBytesSent		 = mEngine.getBytesSent();
+			mBytesCopied	 = mEngine.getBytesCopiedPerFrame();
+			mFramesCoalesced = mEngine.getFramesCoalesced();
 		}
 
 		mFps = eng.getAverageFps();
+
+		mImageQueue = int(mEngine.getLoadImageService().getQueueDepth());
+		mEngine.getLoadImageService().getQueueWait(mImageWaitAvg, mImageWaitMax);
+		ds::cfg::SettingsVariables::getExpressionCacheStats(mExpressionHits, mExpressionMisses);
+		mTextCacheStats = mEngine.getPangoFontService().getTextCache()->getStats();
 	}
 
 	if (!mProductName.empty()) {
@@ -318,13 +328,23 @@ void SettingsEditor::drawAppStatusInfo() {
 
 	ImGui::Text("\tVersion: %s", mAppVersion.data());
 	ImGui::Text("\tSprites: %i", int(mSpriteCount));
+	ImGui::Text("\tSprites Updated / Frame: %i", mSpritesUpdated);
 	ImGui::Text("\tFPS: %f", mFps);
 	ImGui::Text("\tTouch Mode: %s", mTouchMode.data());
 	ImGui::Text("\tPhysical Memory: %f", mPhysicalMemory);
 	ImGui::Text("\tVirtual Memory: %f", mVirtualMemory);
+	ImGui::Text("\tImages Queued: %i", mImageQueue);
+	ImGui::Text("\tImage Queue Wait: %.3fs avg, %.3fs max", mImageWaitAvg, mImageWaitMax);
+	ImGui::Text("\tExpression Cache: %zu hits, %zu misses", mExpressionHits, mExpressionMisses);
+	ImGui::Text("\tText Cache: %zu entries, %zu in use, %zukb", mTextCacheStats.mEntries,
+				mTextCacheStats.mEntriesInUse, mTextCacheStats.mBytes / 1024);
+	ImGui::Text("\tText Cache: %llu hits, %llu misses, %llu evictions", (unsigned long long)mTextCacheStats.mHits,
+				(unsigned long long)mTextCacheStats.mMisses, (unsigned long long)mTextCacheStats.mEvictions);
 	if (mEngine.getMode() != ds::ui::SpriteEngine::STANDALONE_MODE) {
 		ImGui::Text("\tBytes Received: %i", mBytesReceived);
 		ImGui::Text("\tBytes Sent: %i", mBytesSent);
+		ImGui::Text("\tBytes Copied / Frame: %i", mBytesCopied);
+		ImGui::Text("\tFrames Coalesced: %i", mFramesCoalesced);
 	}
 	ImGui::Separator();
 	ImGui::Text("Computer Info");
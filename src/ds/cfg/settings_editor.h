@@ -9,6 +9,7 @@
 #include <ds/cfg/settings.h>
 #include <ds/network/https_client.h>
 #include <ds/ui/layout/layout_sprite.h>
+#include <ds/ui/service/text_cache.h>
 #include <ds/ui/sprite/sprite.h>
 #include <ds/ui/sprite/sprite_engine.h>
 
@@ -69,13 +70,23 @@ class SettingsEditor : public ds::ui::Sprite {
 	bool mLogOpen			= false;
 
 	// App Status
-	int			mSpriteCount = 0;
+	int			mSpriteCount	= 0;
+	int			mSpritesUpdated = 0;
 	std::string mTouchMode;
-	float		mPhysicalMemory = 0.f;
-	float		mVirtualMemory	= 0.f;
-	int			mBytesReceived	= 0;
-	int			mBytesSent		= 0;
-	float		mFps			= 0.f;
+	float		mPhysicalMemory	  = 0.f;
+	float		mVirtualMemory	  = 0.f;
+	int			mBytesReceived	  = 0;
+	int			mBytesSent		  = 0;
+	int			mBytesCopied	  = 0;
+	int			mFramesCoalesced  = 0;
+	float		mFps			  = 0.f;
+	int			mImageQueue		  = 0;
+	double		mImageWaitAvg	  = 0.0;
+	double		mImageWaitMax	  = 0.0;
+	size_t		mExpressionHits	  = 0;
+	size_t		mExpressionMisses = 0;
+
+	ds::ui::TextCache::Stats mTextCacheStats;
 
 	bool	  mSrcDestSaved = false;
 	ci::Rectf mOrigSrc, mOrigDest;
@@ -2,6 +2,12 @@
 
 #include "settings_variables.h"
 
+#include <atomic>
+#include <cctype>
+#include <cstdlib>
+#include <memory>
+#include <mutex>
+
 #include <ds/app/engine/engine.h>
 #include <ds/app/engine/engine_cfg.h>
 
@@ -33,6 +39,155 @@ class Init {
 };
 Init INIT;
 
+/// Parsed expressions, by their text. Expressions without variables always come out the same, so only their
+/// result is kept. Expressions with variables keep the parser, and are evaluated again for each set of values.
+class ExpressionCache {
+  public:
+	struct Compiled {
+		Compiled()
+		  : mValid(false) {}
+
+		FunctionParser			 mParser;
+		std::vector<std::string> mVariables;
+		bool					 mValid;
+	};
+
+	ExpressionCache()
+	  : mHits(0)
+	  , mMisses(0) {}
+
+	bool findResult(const std::string& expr, std::string& result) {
+		std::lock_guard<std::mutex> lock(mMutex);
+		auto						findy = mResults.find(expr);
+		if (findy == mResults.end()) {
+			++mMisses;
+			return false;
+		}
+		++mHits;
+		result = findy->second;
+		return true;
+	}
+
+	void addResult(const std::string& expr, const std::string& result) {
+		std::lock_guard<std::mutex> lock(mMutex);
+		if (mResults.size() >= MAX_ENTRIES) mResults.clear();
+		mResults[expr] = result;
+	}
+
+	/// Answers false if expr can't be parsed with these variables
+	bool evaluate(const std::string& expr, const std::vector<std::string>& variables,
+				  const std::vector<double>& values, double& result) {
+		std::lock_guard<std::mutex> lock(mMutex);
+		if (mCompiled.size() >= MAX_ENTRIES && mCompiled.find(expr) == mCompiled.end()) mCompiled.clear();
+
+		auto& compiled = mCompiled[expr];
+		if (compiled && compiled->mVariables == variables) {
+			++mHits;
+		} else {
+			++mMisses;
+			std::string varList;
+			for (auto it = variables.begin(), end = variables.end(); it != end; ++it) {
+				if (!varList.empty()) varList.append(",");
+				varList.append(*it);
+			}
+
+			compiled.reset(new Compiled());
+			compiled->mVariables = variables;
+			compiled->mParser.AddConstant("pi", 3.1415926535897932);
+			compiled->mValid = compiled->mParser.Parse(expr, varList) < 0;
+			if (compiled->mValid) compiled->mParser.Optimize();
+		}
+
+		if (!compiled->mValid) return false;
+		// Eval isn't const, it uses the parser's stack
+		result = compiled->mParser.Eval(values.empty() ? nullptr : values.data());
+		return true;
+	}
+
+	void getStats(size_t& hits, size_t& misses) const {
+		hits   = mHits;
+		misses = mMisses;
+	}
+
+  private:
+	static const size_t MAX_ENTRIES = 8192;
+
+	std::mutex												   mMutex;
+	std::unordered_map<std::string, std::string>			   mResults;
+	std::unordered_map<std::string, std::unique_ptr<Compiled>> mCompiled;
+	std::atomic<size_t>										   mHits;
+	std::atomic<size_t>										   mMisses;
+};
+ExpressionCache EXPRESSION_CACHE;
+
+bool is_identifier(const std::string& name) {
+	if (name.empty() || std::isdigit(static_cast<unsigned char>(name[0]))) return false;
+	for (auto it = name.begin(), end = name.end(); it != end; ++it) {
+		if (!std::isalnum(static_cast<unsigned char>(*it)) && *it != '_') return false;
+	}
+	return true;
+}
+
+/// Answers true if the whole string is an unsigned number, which is read the same as a literal in the expression
+/// text. A signed value can't be bound: pasted in, -5^2 is -25, but bound as x, x^2 is 25.
+bool to_number(const std::string& value, double& number) {
+	if (value.empty() || !(std::isdigit(static_cast<unsigned char>(value[0])) || value[0] == '.')) return false;
+
+	const char* start = value.c_str();
+	char*		end	  = nullptr;
+	number			  = std::strtod(start, &end);
+	if (end == start) return false;
+	while (*end != 0 && std::isspace(static_cast<unsigned char>(*end))) {
+		++end;
+	}
+	return *end == 0;
+}
+
+/// Swaps each $_variable in expr for a plain name, and collects the variables' values. Answers false if any
+/// variable isn't an unsigned number, in which case the expression has to be substituted as text instead.
+bool bind_variables(const std::string& expr, const ds::cfg::VariableMap& vars, std::string& boundExpr,
+					std::vector<std::string>& names, std::vector<double>& values) {
+	boundExpr.clear();
+	names.clear();
+	values.clear();
+
+	size_t pos = 0;
+	while (true) {
+		const auto theStart = expr.find("$_", pos);
+		if (theStart == std::string::npos) break;
+
+		// Variable names end the same way replaceSingleVariable() ends them
+		auto theEnd = expr.find_first_of(" ,;{}.'", theStart);
+		if (theEnd == std::string::npos) theEnd = expr.size();
+
+		const auto name = expr.substr(theStart + 2, theEnd - theStart - 2);
+		if (!is_identifier(name)) return false;
+		auto findy = vars.find(name);
+		if (findy == vars.end()) return false;
+
+		if (std::find(names.begin(), names.end(), name) == names.end()) {
+			double number = 0.0;
+			if (!to_number(findy->second, number)) return false;
+			names.push_back(name);
+			values.push_back(number);
+		}
+
+		boundExpr.append(expr, pos, theStart - pos);
+		boundExpr.append(name);
+		pos = theEnd;
+	}
+	boundExpr.append(expr, pos, std::string::npos);
+	return true;
+}
+
+std::string expression_result(const double theResult) {
+	std::string returny = std::to_string(theResult);
+	if (returny == "nan" || returny == "-nan") {
+		DS_LOG_WARNING("SettingsVariables: Experession didn't parse to a number! Using 0.0");
+		return "0.0";
+	}
+	return returny;
+}
 
 } // namespace
 
@@ -42,6 +197,7 @@ namespace ds::cfg {
 std::string SettingsVariables::parseExpression(const std::string& theExpr) {
 
 	std::string returny = theExpr;
+	if (EXPRESSION_CACHE.findResult(theExpr, returny)) return returny;
 
 	FunctionParser fparser;
 	fparser.AddConstant("pi", 3.1415926535897932);
@@ -53,12 +209,8 @@ std::string SettingsVariables::parseExpression(const std::string& theExpr) {
 
 	double* vals	  = {};
 	double	theResult = fparser.Eval(vals);
-	returny			  = std::to_string(theResult);
-
-	if (returny == "nan") {
-		DS_LOG_WARNING("SettingsVariables: Experession didn't parse to a number! Using 0.0");
-		return "0.0";
-	}
+	returny			  = expression_result(theResult);
+	EXPRESSION_CACHE.addResult(theExpr, returny);
 
 	DS_LOG_VERBOSE(2, "SettingsVariables: Parsed expression: " << theExpr << " into " << returny);
 
@@ -105,6 +257,40 @@ std::string SettingsVariables::parseAllExpressions(const std::string& value) {
 	return finalValue;
 }
 
+std::string SettingsVariables::replaceVariablesAndExpressions(const std::string& value, const VariableMap& local_map) {
+	// Without wrapped expressions there's nothing to bind
+	if (value.find("#expr{") == std::string::npos) return parseAllExpressions(replaceVariables(value, local_map));
+
+	const VariableMap& vars = (local_map.empty() ? VARIABLE_MAP : local_map);
+
+	std::string				 finalValue, boundExpr;
+	std::vector<std::string> names;
+	std::vector<double>		 values;
+	for (const auto& elemPair : ds::extractPairs(value, "#expr{", "}")) {
+		const std::string& val		 = elemPair.second;
+		double			   theResult = 0.0;
+		if (!elemPair.first) {
+			finalValue.append(replaceVariables(val, local_map));
+		} else if (!bind_variables(val, vars, boundExpr, names, values)) {
+			// Anything that isn't a number is substituted as text, and the expression is parsed afterwards
+			finalValue.append("#expr{").append(replaceVariables(val, local_map)).append("}");
+		} else if (names.empty()) {
+			finalValue.append(parseExpression(boundExpr));
+		} else if (EXPRESSION_CACHE.evaluate(boundExpr, names, values, theResult)) {
+			finalValue.append(expression_result(theResult));
+		} else {
+			finalValue.append("#expr{").append(replaceVariables(val, local_map)).append("}");
+		}
+	}
+
+	if (finalValue.find("#expr") == std::string::npos) return finalValue;
+	return parseAllExpressions(finalValue);
+}
+
+void SettingsVariables::getExpressionCacheStats(size_t& hits, size_t& misses) {
+	EXPRESSION_CACHE.getStats(hits, misses);
+}
+
 std::string SettingsVariables::replaceVariables(const std::string& value, const VariableMap& local_map) {
 	if (value.find("$_") != std::string::npos) {
 		/// keep track of parses, cause it could get circular
@@ -177,10 +363,8 @@ std::string SettingsVariables::replaceSingleVariable(const std::string& value, c
 	// paramName << std::endl << "\tAFTER:" << endString << std::endl << "\tInd:" << theStart << " " << theEnd <<
 	// std::endl;
 
-	VariableMap& combined_map = VARIABLE_MAP;
-	if (local_map.size() > 0) {
-		combined_map = local_map;
-	}
+	// Look in the local map instead of copying it over the app's variables
+	const VariableMap& combined_map = (local_map.size() > 0 ? local_map : VARIABLE_MAP);
 
 	auto findy = combined_map.find(paramName);
 	if (findy != combined_map.end()) {
@@ -2,6 +2,7 @@
 #ifndef DS_CFG_SETTINGS_VARIABLES_
 #define DS_CFG_SETTINGS_VARIABLES_
 
+#include <cstddef>
 #include <string>
 #include <unordered_map>
 
@@ -16,6 +17,14 @@ class SettingsVariables {
 	static std::string parseExpression(const std::string& value);
 	static std::string parseAllExpressions(const std::string& value);
 
+	/// Same as replaceVariables() followed by parseAllExpressions(), except unsigned numeric variables in \#expr{}
+	/// are passed to the expression as values, so the expression is only parsed once for any values
+	static std::string replaceVariablesAndExpressions(const std::string& value,
+													  const VariableMap& local_map = VariableMap());
+
+	/// How many expressions were evaluated from the cache of parsed expressions, and how many had to be parsed
+	static void getExpressionCacheStats(size_t& hits, size_t& misses);
+
 	/// Replaces any values starting with $_ with any variables that are found.
 	/// Runs until no more variables are found, so be careful with circular references!
 	static std::string replaceVariables(const std::string& value, const VariableMap& local_map = VariableMap());
@@ -4,10 +4,31 @@
 
 #include <ds/app/event.h>
 
+#include <string>
+#include <vector>
+
 namespace ds {
 
+/// The row ids that changed in one table of the content model
+struct ContentTableChanges {
+	/// The table's name in the data model
+	std::string		 mTable;
+	std::vector<int> mAdded;
+	std::vector<int> mRemoved;
+	std::vector<int> mModified;
+};
+
 /// ContentQuery has completed and there is new content available
-class ContentUpdatedEvent : public ds::RegisteredEvent<ContentUpdatedEvent> {};
+class ContentUpdatedEvent : public ds::RegisteredEvent<ContentUpdatedEvent> {
+  public:
+	ContentUpdatedEvent()
+	  : mIncremental(false) {}
+
+	/// With content:incremental on, rows were patched into the existing models and mChanges lists every table that
+	/// changed. Otherwise the content was rebuilt and mChanges is empty.
+	bool							 mIncremental;
+	std::vector<ContentTableChanges> mChanges;
+};
 
 /// A request to re-query content (all queries are asynchronous)
 class RequestContentQueryEvent : public ds::RegisteredEvent<RequestContentQueryEvent> {};
@@ -2,6 +2,11 @@
 
 #include "content_model.h"
 
+#include <atomic>
+#include <mutex>
+#include <set>
+#include <unordered_map>
+
 #include <ds/util/color_util.h>
 #include <ds/util/string_util.h>
 
@@ -32,6 +37,30 @@ namespace {
 	const std::vector<ci::vec3>		EMPTY_VEC3_LIST;
 	const std::vector<ci::Rectf>	EMPTY_RECTF_LIST;
 
+	/// Held while a ContentProperty parses its value. Each one only parses once, so sharing it costs next to nothing
+	std::mutex PROPERTY_PARSE_MUTEX;
+
+	/// Bumped when any model changes, which throws away every lookup index. Only changes after a lookup bump it, so
+	/// the threads building content don't all write to it for every property.
+	std::atomic<uint64_t> MODEL_GENERATION(1);
+	/// The newest generation anything looked up children in
+	std::atomic<uint64_t> LOOKUP_GENERATION(0);
+
+	void model_changed() {
+		uint64_t generation = MODEL_GENERATION.load();
+		if (LOOKUP_GENERATION.load() == generation) {
+			MODEL_GENERATION.compare_exchange_strong(generation, generation + 1);
+		}
+	}
+
+	uint64_t model_looked_up() {
+		const uint64_t generation = MODEL_GENERATION.load();
+		uint64_t	   seen		  = LOOKUP_GENERATION.load();
+		while (seen < generation && !LOOKUP_GENERATION.compare_exchange_weak(seen, generation)) {
+		}
+		return generation;
+	}
+
 } // namespace
 
 ContentProperty::ContentProperty()
@@ -39,19 +68,87 @@ ContentProperty::ContentProperty()
   , mValue("")
   , mIntValue(0)
   , mDoubleValue(0)
+  , mBoolValue(false)
+  , mNumbersParsed(true)
+  , mBoolParsed(true)
   , mResource(nullptr) {}
 
-ContentProperty::ContentProperty(const std::string& name, const std::string& value) {
+ContentProperty::ContentProperty(const std::string& name, const std::string& value)
+  : mIntValue(0)
+  , mDoubleValue(0)
+  , mBoolValue(false)
+  , mNumbersParsed(false)
+  , mBoolParsed(false) {
 	setValue(value);
 	setName(name);
 }
 
 ContentProperty::ContentProperty(const std::string& name, const std::string& value, const int& valueInt,
 								 const double& valueDouble) {
-	mName		 = name;
-	mValue		 = value;
-	mIntValue	 = valueInt;
-	mDoubleValue = valueDouble;
+	mName		   = name;
+	mValue		   = value;
+	mIntValue	   = valueInt;
+	mDoubleValue   = valueDouble;
+	mBoolValue	   = false;
+	mNumbersParsed = true;
+	mBoolParsed	   = false;
+}
+
+ContentProperty::ContentProperty(const ContentProperty& other)
+  : mName(other.mName)
+  , mValue(other.mValue)
+  , mIntValue(0)
+  , mDoubleValue(0)
+  , mBoolValue(false)
+  , mNumbersParsed(false)
+  , mBoolParsed(false)
+  , mResource(other.mResource) {
+	copyParsed(other);
+}
+
+ContentProperty::ContentProperty(ContentProperty&& other)
+  : mName(std::move(other.mName))
+  , mValue(std::move(other.mValue))
+  , mIntValue(0)
+  , mDoubleValue(0)
+  , mBoolValue(false)
+  , mNumbersParsed(false)
+  , mBoolParsed(false)
+  , mResource(std::move(other.mResource)) {
+	copyParsed(other);
+}
+
+ContentProperty& ContentProperty::operator=(const ContentProperty& other) {
+	if (this != &other) {
+		mName	  = other.mName;
+		mValue	  = other.mValue;
+		mResource = other.mResource;
+		copyParsed(other);
+	}
+	return *this;
+}
+
+ContentProperty& ContentProperty::operator=(ContentProperty&& other) {
+	if (this != &other) {
+		mName	  = std::move(other.mName);
+		mValue	  = std::move(other.mValue);
+		mResource = std::move(other.mResource);
+		copyParsed(other);
+	}
+	return *this;
+}
+
+void ContentProperty::copyParsed(const ContentProperty& other) {
+	const bool numbersParsed = other.mNumbersParsed.load();
+	if (numbersParsed) {
+		mIntValue	 = other.mIntValue;
+		mDoubleValue = other.mDoubleValue;
+	}
+	const bool boolParsed = other.mBoolParsed.load();
+	if (boolParsed) mBoolValue = other.mBoolValue;
+
+	mNumbersParsed = numbersParsed;
+	mBoolParsed	   = boolParsed;
 }
 
 const std::string& ContentProperty::getName() const {
@@ -67,63 +164,79 @@ const std::string& ContentProperty::getValue() const {
 }
 
 void ContentProperty::setValue(const std::string& value) {
-	mValue		 = value;
-	mIntValue	 = ds::string_to_int(value);
-	mDoubleValue = ds::string_to_double(value);
+	mValue		   = value;
+	mNumbersParsed = false;
+	mBoolParsed	   = false;
 }
 
 void ContentProperty::setValue(const std::wstring& value) {
-	mValue		 = ds::utf8_from_wstr(value);
-	mIntValue	 = ds::wstring_to_int(value);
-	mDoubleValue = ds::wstring_to_double(value);
+	mValue		   = ds::utf8_from_wstr(value);
+	mNumbersParsed = false;
+	mBoolParsed	   = false;
 }
 
 void ContentProperty::setValue(const int& value) {
-	mValue		 = ds::value_to_string<int>(value);
-	mIntValue	 = value;
-	mDoubleValue = (double)mIntValue;
+	mValue		   = ds::value_to_string<int>(value);
+	mIntValue	   = value;
+	mDoubleValue   = (double)mIntValue;
+	mNumbersParsed = true;
+	mBoolParsed	   = false;
 }
 
 void ContentProperty::setValue(const double& value) {
-	mValue		 = ds::value_to_string<double>(value);
-	mIntValue	 = (int)round(value);
-	mDoubleValue = value;
+	mValue		   = ds::value_to_string<double>(value);
+	mIntValue	   = (int)round(value);
+	mDoubleValue   = value;
+	mNumbersParsed = true;
+	mBoolParsed	   = false;
 }
 
 void ContentProperty::setValue(const float& value) {
-	mValue		 = ds::value_to_string<float>(value);
-	mIntValue	 = (int)roundf(value);
-	mDoubleValue = (double)(value);
+	mValue		   = ds::value_to_string<float>(value);
+	mIntValue	   = (int)roundf(value);
+	mDoubleValue   = (double)(value);
+	mNumbersParsed = true;
+	mBoolParsed	   = false;
 }
 
 void ContentProperty::setValue(const ci::Color& value) {
-	mValue		 = ds::unparseColor(value);
-	mIntValue	 = 0;
-	mDoubleValue = 0.0;
+	mValue		   = ds::unparseColor(value);
+	mIntValue	   = 0;
+	mDoubleValue   = 0.0;
+	mNumbersParsed = true;
+	mBoolParsed	   = false;
 }
 
 void ContentProperty::setValue(const ci::ColorA& value) {
-	mValue		 = ds::unparseColor(value);
-	mIntValue	 = 0;
-	mDoubleValue = 0.0;
+	mValue		   = ds::unparseColor(value);
+	mIntValue	   = 0;
+	mDoubleValue   = 0.0;
+	mNumbersParsed = true;
+	mBoolParsed	   = false;
 }
 
 void ContentProperty::setValue(const ci::vec2& value) {
-	mValue		 = ds::unparseVector(value);
-	mIntValue	 = 0;
-	mDoubleValue = 0.0;
+	mValue		   = ds::unparseVector(value);
+	mIntValue	   = 0;
+	mDoubleValue   = 0.0;
+	mNumbersParsed = true;
+	mBoolParsed	   = false;
 }
 
 void ContentProperty::setValue(const ci::vec3& value) {
-	mValue		 = ds::unparseVector(value);
-	mIntValue	 = 0;
-	mDoubleValue = 0.0;
+	mValue		   = ds::unparseVector(value);
+	mIntValue	   = 0;
+	mDoubleValue   = 0.0;
+	mNumbersParsed = true;
+	mBoolParsed	   = false;
 }
 
 void ContentProperty::setValue(const ci::Rectf& value) {
-	mValue		 = ds::unparseRect(value);
-	mIntValue	 = 0;
-	mDoubleValue = 0.0;
+	mValue		   = ds::unparseRect(value);
+	mIntValue	   = 0;
+	mDoubleValue   = 0.0;
+	mNumbersParsed = true;
+	mBoolParsed	   = false;
 }
 
 ds::Resource ContentProperty::getResource() const {
@@ -150,21 +263,43 @@ bool ContentProperty::empty() const {
 }
 
 bool ContentProperty::getBool() const {
-	return ds::parseBoolean(mValue);
+	if (!mBoolParsed) parseBool();
+	return mBoolValue;
 }
 
 int ContentProperty::getInt() const {
+	if (!mNumbersParsed) parseNumbers();
 	return mIntValue;
 }
 
 float ContentProperty::getFloat() const {
+	if (!mNumbersParsed) parseNumbers();
 	return (float)mDoubleValue;
 }
 
 double ContentProperty::getDouble() const {
+	if (!mNumbersParsed) parseNumbers();
 	return mDoubleValue;
 }
 
+void ContentProperty::parseNumbers() const {
+	// Another thread may have parsed it while this one waited
+	std::lock_guard<std::mutex> lock(PROPERTY_PARSE_MUTEX);
+	if (mNumbersParsed) return;
+
+	mIntValue	   = ds::string_to_int(mValue);
+	mDoubleValue   = ds::string_to_double(mValue);
+	mNumbersParsed = true;
+}
+
+void ContentProperty::parseBool() const {
+	std::lock_guard<std::mutex> lock(PROPERTY_PARSE_MUTEX);
+	if (mBoolParsed) return;
+
+	mBoolValue	= ds::parseBoolean(mValue);
+	mBoolParsed = true;
+}
+
 ci::Color ContentProperty::getColor(ds::ui::SpriteEngine& eng) const {
 	return ds::parseColor(mValue, eng);
 }
@@ -196,11 +331,79 @@ ci::Rectf ContentProperty::getRect() const {
 
 class ContentModelRef::Data {
   public:
+	/// Positions in mChildren, and descendants, for the lookups that have been asked for since the last change
+	struct Index {
+		Index()
+		  : mChildrenBuilt(false)
+		  , mDescendantsBuilt(false) {}
+
+		bool mChildrenBuilt;
+		/// The first child with each id, name and property value, and every child with each label
+		std::unordered_map<int, size_t>											 mIds;
+		std::unordered_map<std::string, size_t>									 mNames;
+		std::unordered_map<std::string, std::vector<size_t>>					 mLabels;
+		std::unordered_map<std::string, std::unordered_map<std::string, size_t>> mProperties;
+
+		bool mDescendantsBuilt;
+		/// Name, then id, to the first match in the same order getDescendant() searches
+		std::unordered_map<std::string, std::unordered_map<int, ContentModelRef>> mDescendants;
+	};
+
 	Data()
 	  : mName(EMPTY_STRING)
 	  , mLabel(EMPTY_STRING)
 	  , mUserData(nullptr)
-	  , mId(EMPTY_INT) {}
+	  , mId(EMPTY_INT)
+	  , mLookupGeneration(0)
+	  , mIndexGeneration(0) {}
+
+	/// Answers the index if it's worth using, or null to scan the children instead. Call with mIndexMutex held.
+	/// The first lookup after a change scans, so models that change between every lookup never pay for an index.
+	Index* getIndex() {
+		const uint64_t generation = model_looked_up();
+		if (mIndex && mIndexGeneration == generation) return mIndex.get();
+		if (mLookupGeneration != generation) {
+			mLookupGeneration = generation;
+			mIndex.reset();
+			return nullptr;
+		}
+
+		mIndex.reset(new Index());
+		mIndexGeneration = generation;
+		return mIndex.get();
+	}
+
+	Index& getChildIndex(Index& index) {
+		if (index.mChildrenBuilt) return index;
+
+		for (size_t k = 0; k < mChildren.size(); ++k) {
+			const ContentModelRef& child = mChildren[k];
+			index.mIds.emplace(child.getId(), k);
+			index.mNames.emplace(child.getName(), k);
+			index.mLabels[child.getLabel()].push_back(k);
+		}
+		index.mChildrenBuilt = true;
+		return index;
+	}
+
+	std::unordered_map<std::string, size_t>& getPropertyIndex(Index& index, const std::string& propertyName) {
+		auto found = index.mProperties.find(propertyName);
+		if (found != index.mProperties.end()) return found->second;
+
+		auto& values = index.mProperties[propertyName];
+		for (size_t k = 0; k < mChildren.size(); ++k) {
+			values.emplace(mChildren[k].getPropertyString(propertyName), k);
+		}
+		return values;
+	}
+
+	std::unordered_map<std::string, std::unordered_map<int, ContentModelRef>>& getDescendantIndex(Index& index) {
+		if (!index.mDescendantsBuilt) {
+			addDescendants(index, mChildren);
+			index.mDescendantsBuilt = true;
+		}
+		return index.mDescendants;
+	}
 
 	std::string											  mName;
 	std::string											  mLabel;
@@ -210,6 +413,20 @@ class ContentModelRef::Data {
 	std::map<std::string, std::vector<ContentProperty>>	  mPropertyLists;
 	std::vector<ContentModelRef>						  mChildren;
 	std::map<std::string, std::map<int, ContentModelRef>> mReferences;
+	std::set<std::string>								  mIndexedProperties;
+
+	std::mutex			   mIndexMutex;
+	uint64_t			   mLookupGeneration;
+	uint64_t			   mIndexGeneration;
+	std::unique_ptr<Index> mIndex;
+
+  private:
+	static void addDescendants(Index& index, const std::vector<ContentModelRef>& children) {
+		for (const auto& it : children) {
+			index.mDescendants[it.getName()].emplace(it.getId(), it);
+			addDescendants(index, it.getChildren());
+		}
+	}
 };
 
 ContentModelRef::ContentModelRef() {}
@@ -229,6 +446,7 @@ const int& ContentModelRef::getId() const {
 void ContentModelRef::setId(const int& id) {
 	createData();
 	mData->mId = id;
+	model_changed();
 }
 
 const std::string& ContentModelRef::getName() const {
@@ -239,6 +457,7 @@ const std::string& ContentModelRef::getName() const {
 void ContentModelRef::setName(const std::string& name) {
 	createData();
 	mData->mName = name;
+	model_changed();
 }
 
 const std::string& ContentModelRef::getLabel() const {
@@ -249,6 +468,7 @@ const std::string& ContentModelRef::getLabel() const {
 void ContentModelRef::setLabel(const std::string& name) {
 	createData();
 	mData->mLabel = name;
+	model_changed();
 }
 
 void* ContentModelRef::getUserData() const {
@@ -274,6 +494,7 @@ bool ContentModelRef::empty() const {
 
 void ContentModelRef::clear() {
 	mData.reset(new Data());
+	model_changed();
 }
 
 ds::model::ContentModelRef ContentModelRef::duplicate() const {
@@ -295,8 +516,9 @@ ds::model::ContentModelRef ContentModelRef::duplicate() const {
 	}
 	newModel.setChildren(newChildren);
 
-	newModel.mData->mReferences	   = mData->mReferences;
-	newModel.mData->mPropertyLists = mData->mPropertyLists;
+	newModel.mData->mReferences		   = mData->mReferences;
+	newModel.mData->mPropertyLists	   = mData->mPropertyLists;
+	newModel.mData->mIndexedProperties = mData->mIndexedProperties;
 
 	return newModel;
 }
@@ -440,9 +662,14 @@ const std::map<std::string, ContentProperty>& ContentModelRef::getProperties() c
 void ContentModelRef::setProperties(const std::map<std::string, ContentProperty>& newProperties) {
 	createData();
 	mData->mProperties = newProperties;
+	model_changed();
 }
 
 ds::model::ContentProperty ContentModelRef::getProperty(const std::string& propertyName) const {
+	return findProperty(propertyName);
+}
+
+const ContentProperty& ContentModelRef::findProperty(const std::string& propertyName) const {
 	if (!mData) return EMPTY_PROPERTY;
 	auto findy = mData->mProperties.find(propertyName);
 	if (findy != mData->mProperties.end()) {
@@ -453,66 +680,68 @@ ds::model::ContentProperty ContentModelRef::getProperty(const std::string& prope
 }
 
 std::string ContentModelRef::getPropertyValue(const std::string& propertyName) const {
-	return getProperty(propertyName).getValue();
+	return findProperty(propertyName).getValue();
 }
 
 bool ContentModelRef::getPropertyBool(const std::string& propertyName) const {
-	return getProperty(propertyName).getBool();
+	return findProperty(propertyName).getBool();
 }
 
 int ContentModelRef::getPropertyInt(const std::string& propertyName) const {
-	return getProperty(propertyName).getInt();
+	return findProperty(propertyName).getInt();
 }
 
 float ContentModelRef::getPropertyFloat(const std::string& propertyName) const {
-	return getProperty(propertyName).getFloat();
+	return findProperty(propertyName).getFloat();
 }
 
 double ContentModelRef::getPropertyDouble(const std::string& propertyName) const {
-	return getProperty(propertyName).getDouble();
+	return findProperty(propertyName).getDouble();
 }
 
 ci::Color ContentModelRef::getPropertyColor(ds::ui::SpriteEngine& eng, const std::string& propertyName) const {
-	return getProperty(propertyName).getColor(eng);
+	return findProperty(propertyName).getColor(eng);
 }
 
 ci::ColorA ContentModelRef::getPropertyColorA(ds::ui::SpriteEngine& eng, const std::string& propertyName) const {
-	return getProperty(propertyName).getColorA(eng);
+	return findProperty(propertyName).getColorA(eng);
 }
 
 std::string ContentModelRef::getPropertyString(const std::string& propertyName) const {
-	return getProperty(propertyName).getString();
+	return findProperty(propertyName).getString();
 }
 
 std::wstring ContentModelRef::getPropertyWString(const std::string& propertyName) const {
-	return getProperty(propertyName).getWString();
+	return findProperty(propertyName).getWString();
 }
 
 ci::vec2 ContentModelRef::getPropertyVec2(const std::string& propertyName) const {
-	return getProperty(propertyName).getVec2();
+	return findProperty(propertyName).getVec2();
 }
 
 ci::vec3 ContentModelRef::getPropertyVec3(const std::string& propertyName) const {
-	return getProperty(propertyName).getVec3();
+	return findProperty(propertyName).getVec3();
 }
 
 ci::Rectf ContentModelRef::getPropertyRect(const std::string& propertyName) const {
-	return getProperty(propertyName).getRect();
+	return findProperty(propertyName).getRect();
 }
 
 ds::Resource ContentModelRef::getPropertyResource(const std::string& propertyName) const {
-	return getProperty(propertyName).getResource();
+	return findProperty(propertyName).getResource();
 }
 
 void ContentModelRef::setProperty(const std::string& propertyName, ContentProperty& datamodel) {
 	createData();
 
 	mData->mProperties[propertyName] = datamodel;
+	model_changed();
 }
 
 void ContentModelRef::setProperty(const std::string& propertyName, const std::string& propertyValue) {
 	createData();
 	mData->mProperties[propertyName] = ContentProperty(propertyName, propertyValue);
+	model_changed();
 }
 
 void ContentModelRef::setProperty(const std::string& propertyName, const std::wstring& value) {
@@ -828,6 +1057,14 @@ ContentModelRef ContentModelRef::getChild(const size_t index) {
 ContentModelRef ContentModelRef::getChildById(const int id) {
 	createData();
 
+	std::lock_guard<std::mutex> lock(mData->mIndexMutex);
+	if (auto index = mData->getIndex()) {
+		const auto& ids	  = mData->getChildIndex(*index).mIds;
+		auto		found = ids.find(id);
+		if (found != ids.end()) return mData->mChildren[found->second];
+		return EMPTY_DATAMODEL;
+	}
+
 	for (auto it : mData->mChildren) {
 		if (it.getId() == id) return it;
 	}
@@ -851,6 +1088,14 @@ ContentModelRef ContentModelRef::getChildByName(const std::string& childName) co
 		}
 	}
 
+	std::lock_guard<std::mutex> lock(mData->mIndexMutex);
+	if (auto index = mData->getIndex()) {
+		const auto& names = mData->getChildIndex(*index).mNames;
+		auto		found = names.find(childName);
+		if (found != names.end()) return mData->mChildren[found->second];
+		return EMPTY_DATAMODEL;
+	}
+
 	for (auto it : mData->mChildren) {
 		if (it.getName() == childName) return it;
 	}
@@ -859,6 +1104,18 @@ ContentModelRef ContentModelRef::getChildByName(const std::string& childName) co
 }
 
 ds::model::ContentModelRef ContentModelRef::getDescendant(const std::string& childName, const int childId) const {
+	if (!mData) return ContentModelRef();
+
+	std::lock_guard<std::mutex> lock(mData->mIndexMutex);
+	if (auto index = mData->getIndex()) {
+		auto& descendants = mData->getDescendantIndex(*index);
+		auto  named		  = descendants.find(childName);
+		if (named == descendants.end()) return ContentModelRef();
+		auto found = named->second.find(childId);
+		if (found == named->second.end()) return ContentModelRef();
+		return found->second;
+	}
+
 	for (auto it : getChildren()) {
 		if (it.getId() == childId && it.getName() == childName) {
 			return it;
@@ -875,6 +1132,21 @@ ds::model::ContentModelRef ContentModelRef::getDescendant(const std::string& chi
 
 std::vector<ContentModelRef> ContentModelRef::getChildrenWithLabel(const std::string& label) const {
 	std::vector<ContentModelRef> childrenWithLabel;
+	if (!mData) return childrenWithLabel;
+
+	std::lock_guard<std::mutex> lock(mData->mIndexMutex);
+	if (auto index = mData->getIndex()) {
+		const auto& labels = mData->getChildIndex(*index).mLabels;
+		auto		found  = labels.find(label);
+		if (found != labels.end()) {
+			childrenWithLabel.reserve(found->second.size());
+			for (auto it : found->second) {
+				childrenWithLabel.push_back(mData->mChildren[it]);
+			}
+		}
+		return childrenWithLabel;
+	}
+
 	for (auto it : getChildren()) {
 		if (it.getLabel() == label) {
 			childrenWithLabel.push_back(it);
@@ -885,6 +1157,18 @@ std::vector<ContentModelRef> ContentModelRef::getChildrenWithLabel(const std::st
 
 ContentModelRef ContentModelRef::findChildByPropertyValue(const std::string& propertyName,
 														  const std::string& propertyValue) const {
+	if (!mData) return ContentModelRef();
+
+	std::lock_guard<std::mutex> lock(mData->mIndexMutex);
+	if (mData->mIndexedProperties.count(propertyName) > 0) {
+		if (auto index = mData->getIndex()) {
+			const auto& values = mData->getPropertyIndex(*index, propertyName);
+			auto		found  = values.find(propertyValue);
+			if (found != values.end()) return mData->mChildren[found->second];
+			return ContentModelRef();
+		}
+	}
+
 	for (auto it : getChildren()) {
 		if (it.getPropertyString(propertyName) == propertyValue) {
 			return it;
@@ -893,6 +1177,13 @@ ContentModelRef ContentModelRef::findChildByPropertyValue(const std::string& pro
 	return ContentModelRef();
 }
 
+void ContentModelRef::indexProperty(const std::string& propertyName) {
+	createData();
+
+	std::lock_guard<std::mutex> lock(mData->mIndexMutex);
+	mData->mIndexedProperties.insert(propertyName);
+}
+
 bool ContentModelRef::hasChild(const std::string& name) const {
 	return !getChildByName(name).empty();
 }
@@ -901,6 +1192,7 @@ void ContentModelRef::addChild(const ContentModelRef& datamodel) {
 	createData();
 
 	mData->mChildren.emplace_back(datamodel);
+	model_changed();
 }
 
 void ContentModelRef::addChild(const ContentModelRef& datamodel, const size_t index) {
@@ -911,6 +1203,7 @@ void ContentModelRef::addChild(const ContentModelRef& datamodel, const size_t in
 	} else {
 		mData->mChildren.emplace_back(datamodel);
 	}
+	model_changed();
 }
 
 void ContentModelRef::replaceChild(const ds::model::ContentModelRef &datamodel) {
@@ -945,11 +1238,13 @@ bool ContentModelRef::hasChildren() const {
 void ContentModelRef::setChildren(const std::vector<ds::model::ContentModelRef> &children) {
 	createData();
 	mData->mChildren = children;
+	model_changed();
 }
 
 void ContentModelRef::clearChildren() const {
 	if (!mData) return;
 	mData->mChildren.clear();
+	model_changed();
 }
 
 
@@ -8,6 +8,7 @@
 
 #include <ds/data/resource.h>
 
+#include <atomic>
 #include <map>
 #include <memory>
 #include <vector>
@@ -32,6 +33,10 @@ class ContentProperty {
 	ContentProperty();
 	ContentProperty(const std::string& name, const std::string& value);
 	ContentProperty(const std::string& name, const std::string& value, const int& valueInt, const double& valueDouble);
+	ContentProperty(const ContentProperty&);
+	ContentProperty(ContentProperty&&);
+	ContentProperty& operator=(const ContentProperty&);
+	ContentProperty& operator=(ContentProperty&&);
 
 	/// Get the name of this property
 	const std::string& getName() const;
@@ -57,6 +62,8 @@ class ContentProperty {
 
 	bool empty() const;
 	/// ------- This value, type converted when called --------- //
+	/// Numbers and bools are parsed the first time they're asked for, and kept until the value changes.
+	/// Any number of threads can read the same property, as long as none of them sets it meanwhile
 
 	bool   getBool() const;
 	int	   getInt() const;
@@ -75,10 +82,20 @@ class ContentProperty {
 	ci::Rectf getRect() const;
 
   protected:
+	void parseNumbers() const;
+	void parseBool() const;
+	/// Takes the parsed values of other only if they're finished, otherwise they're parsed again when asked for
+	void copyParsed(const ContentProperty& other);
+
 	std::string				  mName;
 	std::string				  mValue;
-	int						  mIntValue;
-	double					  mDoubleValue;
+	mutable int				  mIntValue;
+	mutable double			  mDoubleValue;
+	mutable bool			  mBoolValue;
+	/// Stored after the values they cover, so a reader that sees one set can use its values
+	mutable std::atomic<bool> mNumbersParsed;
+	mutable std::atomic<bool> mBoolParsed;
+
 	std::shared_ptr<Resource> mResource;
 };
 
@@ -94,6 +111,9 @@ class ContentProperty {
  *			* A label, for identifying models to humans
  *			* An Id, which has no guarantee of uniqueness, that typically comes from a database, and can be used to
  *look up models
+ *		 Looking up children by id, name, label or an indexed property, and getDescendant(), scan the children
+ *until the same model is searched twice with no model changed in between. After that they use indexes, which
+ *are thrown away the next time any model changes.
  */
 class ContentModelRef {
   public:
@@ -139,6 +159,10 @@ class ContentModelRef {
 	/// Tests if this ContentModelRef has the same Id, Name, Label and underlying data pointer
 	bool operator==(const ContentModelRef&) const;
 
+	/// The same for every ContentModelRef that shares this one's data, for telling refs apart without comparing
+	/// their contents
+	const void* getDataPointer() const { return mData.get(); }
+
 	bool weakEqual(const ContentModelRef& b) const;
 
 	bool equalChildrenAndReferences(const ContentModelRef&				  b,
@@ -243,6 +267,10 @@ class ContentModelRef {
 	/// Returns an empty model if no match is found
 	ContentModelRef findChildByPropertyValue(const std::string& propertyName, const std::string& propertyValue) const;
 
+	/// Lets findChildByPropertyValue() on this model use an index for propertyName.
+	/// Worth it for properties that are looked up a lot, like the foreign keys of a big table.
+	void indexProperty(const std::string& propertyName);
+
 	/// Adds this child to the end of this children list, or at the index supplied
 	void addChild(const ContentModelRef& datamodel);
 	void addChild(const ContentModelRef& datamodel, const size_t index);
@@ -283,6 +311,9 @@ class ContentModelRef {
 	void printTree(const bool verbose, const std::string& indent = "") const;
 
   private:
+	/// The property itself rather than a copy, so its parsed numbers are kept
+	const ContentProperty& findProperty(const std::string& propertyName) const;
+
 	void createData();
 	class Data;
 	std::shared_ptr<Data> mData;
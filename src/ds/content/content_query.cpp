@@ -2,27 +2,55 @@
 
 #include "content_query.h"
 
+#include <algorithm>
+#include <atomic>
 #include <map>
 #include <sstream>
+#include <thread>
 
 #include <ds/app/environment.h>
 #include <ds/cfg/settings_variables.h>
 #include <ds/debug/logger.h>
 #include <ds/query/query_client.h>
+#include <ds/query/sql_connection_pool.h>
 #include <ds/query/sqlite/sqlite3.h>
 #include <ds/util/file_meta_data.h>
 
 namespace ds {
 
+namespace {
+	/// What a column in a table query is used for, worked out once per query
+	struct TableColumn {
+		TableColumn()
+		  : mIsId(false)
+		  , mIsName(false)
+		  , mIsLabel(false)
+		  , mIsResource(false) {}
+
+		std::string mName;
+		bool		mIsId;
+		bool		mIsName;
+		bool		mIsLabel;
+		bool		mIsResource;
+	};
+} // namespace
+
 ContentQuery::ContentQuery()
   : mCheckUpdatedResources(true)
+  , mQueryThreads(0)
   , mTableId(0) {}
 
 void ContentQuery::run() {
+	// The cms may have swapped the database file since the last update, so don't read it through a connection
+	// that's still open on the old one
+	ds::query::SqlConnectionPool::closeAll();
+
 	mData = ds::model::ContentModelRef("sqlite", 0, "The root of all sqlite data");
 	mData.setProperty("cms_database", mCmsDatabase);
 	mData.setProperty("model_xml", mXmlDataModel);
+	mTables	 = ds::model::ContentModelRef("tables");
 	mTableId = 0;
+	mTableTimings.clear();
 
 	Poco::Timestamp::TimeVal before = Poco::Timestamp().epochMicroseconds();
 
@@ -81,7 +109,11 @@ void ContentQuery::run() {
 
 	if (metaNode.empty() || metaNode.getPropertyString("use_resources").empty() ||
 		metaNode.getPropertyBool("use_resources")) {
+		Poco::Timestamp::TimeVal resourcesBefore = Poco::Timestamp().epochMicroseconds();
 		updateResourceCache();
+		Poco::Timestamp::TimeVal resourcesAfter = Poco::Timestamp().epochMicroseconds();
+		mTableTimings.push_back(TableTiming("resources", mAllResources.size(),
+											(float)(resourcesAfter - resourcesBefore) / 1000000.0f));
 	}
 
 	if (ds::getLogger().hasVerboseLevel(4)) metaData.printTree(true, "");
@@ -92,8 +124,19 @@ void ContentQuery::run() {
 		auto tables = mData.getChildren();
 		for (auto it : tables) {
 			it.setName(it.getProperty("tbl_name").getString());
-			getDataFromTable(it, it.getProperty("tbl_name").getString());
 		}
+
+		/// Each table only fills in its own model, so they can all be read at once
+		std::vector<TableTiming> timings(tables.size(), TableTiming("", 0, 0.0f));
+		runParallel(tables.size(), [this, &tables, &timings](const size_t index) {
+			Poco::Timestamp::TimeVal tableBefore = Poco::Timestamp().epochMicroseconds();
+			getDataFromTable(tables[index], tables[index].getName());
+			Poco::Timestamp::TimeVal tableAfter = Poco::Timestamp().epochMicroseconds();
+			timings[index] = TableTiming(tables[index].getName(), tables[index].getChildren().size(),
+										 (float)(tableAfter - tableBefore) / 1000000.0f);
+		});
+		mTableTimings.insert(mTableTimings.end(), timings.begin(), timings.end());
+		mTables.setChildren(tables);
 	} else {
 
 		/// First we get all the tables independently in a list
@@ -102,11 +145,19 @@ void ContentQuery::run() {
 
 		/// then we link all the tables together based on depth and parent id's
 		assembleModels(tablesData);
+		mTables = tablesData;
 	}
 
 	Poco::Timestamp::TimeVal after = Poco::Timestamp().epochMicroseconds();
 
-	DS_LOG_VERBOSE(1, "Finished data query in " << (float)(after - before) / 1000000.0f << " seconds.");
+	if (ds::getLogger().hasVerboseLevel(1)) {
+		std::stringstream timings;
+		for (auto& it : mTableTimings) {
+			timings << "\n\t" << it.mName << ": " << it.mRows << " rows in " << it.mSeconds << " seconds";
+		}
+		DS_LOG_VERBOSE(1, "Finished data query in " << (float)(after - before) / 1000000.0f << " seconds with "
+													<< mQueryThreads << " extra threads." << timings.str());
+	}
 }
 
 void ContentQuery::assembleModels(ds::model::ContentModelRef tablesParent) {
@@ -217,8 +268,7 @@ ds::model::ContentModelRef ContentQuery::readXml() {
 		auto		theFile	   = cinder::loadFile(filePath);
 		std::string theContent = std::string((char*)theFile->getBuffer()->getData(), theFile->getBuffer()->getSize());
 
-		std::string value = ds::cfg::SettingsVariables::replaceVariables(theContent);
-		value			  = ds::cfg::SettingsVariables::parseAllExpressions(value);
+		std::string value = ds::cfg::SettingsVariables::replaceVariablesAndExpressions(theContent);
 
 		xml = ci::XmlTree(value);
 	} catch (ci::XmlTree::Exception& e) {
@@ -299,22 +349,15 @@ void ContentQuery::updateResourceCache() {
 	}
 
 	/// Lets do the query!
-	sqlite3* db = NULL;
-	// open the database
-	const int sqliteResultCode =
-		sqlite3_open_v2(ds::getNormalizedPath(mCmsDatabase).c_str(), &db, SQLITE_OPEN_READONLY, 0);
+	int	 sqliteResultCode = SQLITE_OK;
+	auto db				  = ds::query::SqlConnectionPool::acquire(mCmsDatabase, SQLITE_OPEN_READONLY,
+																  &sqliteResultCode);
 
 	/// if everything went ok
-	if (sqliteResultCode == SQLITE_OK) {
-		sqlite3_busy_timeout(db, 1500);
-		sqlite3_stmt* statement;
-		const int	  err = sqlite3_prepare_v2(db, resQuery.c_str(), -1, &statement, 0);
-		if (err != SQLITE_OK) {
-			sqlite3_finalize(statement);
-			DS_LOG_ERROR("ContentQuery::updateResourceQuery::rawSelect SQL error code="
-						 << err << " message=" << sqlite3_errstr(err) << " on select=" << resQuery << std::endl);
-
-		} else {
+	if (db) {
+		auto prepared = db.prepare(resQuery);
+		if (prepared) {
+			sqlite3_stmt* statement = prepared.get();
 
 			/// go through all the rows
 			while (true) {
@@ -362,12 +405,10 @@ void ContentQuery::updateResourceCache() {
 					}
 
 				} else {
-					sqlite3_finalize(statement);
 					break;
 				}
 			}
 		}
-		sqlite3_close_v2(db);
 	} else {
 		DS_LOG_ERROR("ContentQuery:updateResourceQuery Unable to access the database "
 					 << mCmsDatabase << " (SQLite error " << sqliteResultCode << ")." << std::endl);
@@ -380,6 +421,24 @@ void ContentQuery::getDataFromTable(ds::model::ContentModelRef parentModel, ds::
 									const std::string& dbPath, std::unordered_map<int, ds::Resource>& allResources,
 									const int depth, const int parentModelId) {
 
+	/// Gather every table in the description first, so they can all be read at once
+	std::vector<TableLoad> loads;
+	collectTables(tableDescription, depth, parentModelId, loads);
+
+	runParallel(loads.size(), [this, &loads, &dbPath, &allResources](const size_t index) {
+		loadTable(loads[index], dbPath, allResources);
+	});
+
+	/// Added in the order they're described, same as if they'd been read one at a time
+	for (auto& it : loads) {
+		parentModel.addChild(it.mModel);
+		mTableTimings.push_back(TableTiming(it.mModel.getName(), it.mRows, it.mSeconds));
+	}
+}
+
+void ContentQuery::collectTables(ds::model::ContentModelRef tableDescription, const int depth,
+								 const int parentModelId, std::vector<TableLoad>& loads) {
+
 	std::string theTable	  = tableDescription.getPropertyValue("table_name");
 	std::string theTableAlias = tableDescription.getPropertyValue("name");
 
@@ -391,8 +450,7 @@ void ContentQuery::getDataFromTable(ds::model::ContentModelRef parentModel, ds::
 		theTableAlias = theTable;
 	}
 
-	int						   thisId	  = mTableId++;
-	ds::model::ContentModelRef tableModel = ds::model::ContentModelRef(theTableAlias, thisId, "SQLite Table");
+	int thisId = mTableId++;
 
 	if (theTable.empty()) {
 		if (tableDescription.getName() != "model" && tableDescription.getName() != "meta" &&
@@ -400,193 +458,208 @@ void ContentQuery::getDataFromTable(ds::model::ContentModelRef parentModel, ds::
 			DS_LOG_WARNING("ContentQuery::getDataFromTable() No table name specified in datamodel query");
 		}
 
-		tableModel = parentModel;
-
 	} else {
+		TableLoad load;
+		load.mTable		  = theTable;
+		load.mDescription = tableDescription;
+		load.mModel		  = ds::model::ContentModelRef(theTableAlias, thisId, "SQLite Table");
+		load.mModel.setProperties(tableDescription.getProperties());
+		load.mModel.setProperty("depth", depth);
+		load.mModel.setProperty("parent_id", parentModelId);
+		loads.push_back(load);
+	}
 
-		std::string selectStmt	= tableDescription.getPropertyString("select");
-		std::string sorting		= tableDescription.getPropertyString("sort");
-		std::string whereClause = tableDescription.getPropertyString("where");
-		std::string limits		= tableDescription.getPropertyString("limit");
-		std::string reccys		= tableDescription.getPropertyString("resources");
-		std::string primaryId	= tableDescription.getPropertyString("id");
-		std::string theName		= tableDescription.getPropertyString("name_field");
-		std::string theLabel	= tableDescription.getPropertyString("label_field");
-
-		tableModel.setProperties(tableDescription.getProperties());
-		tableModel.setProperty("depth", depth);
-		tableModel.setProperty("parent_id", parentModelId);
-		tableModel.setId(thisId);
-
-
-		/// Select
-		std::stringstream theQuery;
-		if (selectStmt.empty()) {
-			theQuery << "SELECT * FROM " << theTable;
-		} else {
-			theQuery << selectStmt;
-		}
+	auto tableChildren = tableDescription.getChildren();
+	for (auto it : tableChildren) {
+		collectTables(it, depth + 1, thisId, loads);
+	}
+}
 
-		/// Where
-		if (!whereClause.empty()) {
-			theQuery << " WHERE " << whereClause;
-		}
+void ContentQuery::loadTable(TableLoad& load, const std::string& dbPath,
+							 const std::unordered_map<int, ds::Resource>& allResources) const {
+	Poco::Timestamp::TimeVal before = Poco::Timestamp().epochMicroseconds();
 
-		/// Sorting
-		if (!sorting.empty()) {
-			auto theSorts = ds::split(sorting, ", ", true);
+	const std::string& theTable		 = load.mTable;
+	const std::string& theTableAlias = load.mModel.getName();
 
-			bool firsty = true;
-			for (auto it : theSorts) {
-				if (it.empty()) continue;
+	std::string selectStmt	= load.mDescription.getPropertyString("select");
+	std::string sorting		= load.mDescription.getPropertyString("sort");
+	std::string whereClause = load.mDescription.getPropertyString("where");
+	std::string limits		= load.mDescription.getPropertyString("limit");
+	std::string reccys		= load.mDescription.getPropertyString("resources");
+	std::string primaryId	= load.mDescription.getPropertyString("id");
+	std::string theName		= load.mDescription.getPropertyString("name_field");
+	std::string theLabel	= load.mDescription.getPropertyString("label_field");
 
-				if (firsty) {
-					theQuery << " ORDER BY ";
-				} else {
-					theQuery << ", ";
-				}
 
-				firsty = false;
-				theQuery << it;
-			}
-		}
+	/// Select
+	std::stringstream theQuery;
+	if (selectStmt.empty()) {
+		theQuery << "SELECT * FROM " << theTable;
+	} else {
+		theQuery << selectStmt;
+	}
 
-		if (!limits.empty()) {
-			theQuery << " LIMIT " << limits;
-		}
+	/// Where
+	if (!whereClause.empty()) {
+		theQuery << " WHERE " << whereClause;
+	}
 
-		/// Resources
-		auto resourceColumns = ds::split(reccys, ", ", true);
+	/// Sorting
+	if (!sorting.empty()) {
+		auto theSorts = ds::split(sorting, ", ", true);
 
-		/// Lets do the query!
-		sqlite3* db = NULL;
-		// open the database
-		const int sqliteResultCode =
-			sqlite3_open_v2(ds::getNormalizedPath(dbPath).c_str(), &db, SQLITE_OPEN_READONLY, 0);
+		bool firsty = true;
+		for (auto it : theSorts) {
+			if (it.empty()) continue;
 
-		/// if everything went ok
-		if (sqliteResultCode == SQLITE_OK) {
-			sqlite3_busy_timeout(db, 1500);
+			if (firsty) {
+				theQuery << " ORDER BY ";
+			} else {
+				theQuery << ", ";
+			}
 
-			DS_LOG_VERBOSE(4, "Executing SQL query " << theQuery.str());
+			firsty = false;
+			theQuery << it;
+		}
+	}
 
-			sqlite3_stmt* statement;
-			const int	  err = sqlite3_prepare_v2(db, theQuery.str().c_str(), -1, &statement, 0);
-			if (err != SQLITE_OK) {
-				sqlite3_finalize(statement);
-				DS_LOG_ERROR("ContentQuery::rawSelect SQL error code=" << err << " message=" << sqlite3_errstr(err)
-																	   << " on select=" << theQuery.str().c_str()
-																	   << std::endl);
+	if (!limits.empty()) {
+		theQuery << " LIMIT " << limits;
+	}
 
-			} else {
+	/// Resources
+	auto resourceColumns = ds::split(reccys, ", ", true);
 
-				/// in case there's no id field specified or a primary key column
-				int id = 1;
-
-				/// go through all the rows
-				while (true) {
-
-					/// if this isn't a row, then we're done with the query
-					auto statementResult = sqlite3_step(statement);
-					if (statementResult == SQLITE_ROW) {
-
-						bool parsedMetadata = false;
-
-						auto					   columnCount = sqlite3_data_count(statement);
-						ds::model::ContentModelRef thisRow =
-							ds::model::ContentModelRef(theTableAlias, id, theTable + " row");
-						id++;
-
-						for (int i = 0; i < columnCount; i++) {
-
-							auto columnName = sqlite3_column_name(statement, i);
-
-							/// If we don't have a primary id set already, look up the metadata for this column and see
-							/// if it's the primary key
-							if (primaryId.empty() && !parsedMetadata) {
-								const char* dataType	 = NULL;
-								const char* collSequence = NULL;
-								int			notNull		 = 0;
-								int			primaryKey	 = 0;
-								int			autoInc		 = 0;
-								int			resulty =
-									sqlite3_table_column_metadata(db, NULL, theTable.c_str(), columnName, &dataType,
-																  &collSequence, &notNull, &primaryKey, &autoInc);
-
-								if (primaryKey) {
-									primaryId = columnName;
-								}
-
-								if (ds::getLogger().hasVerboseLevel(3)) {
-									if (dataType) {
-										DS_LOG_VERBOSE(3, " Column "
-															  << columnName << " type:" << dataType
-															  << " col seq:" << collSequence << " not null:" << notNull
-															  << " prim key:" << primaryKey << " autoinc:" << autoInc);
-									} else {
-										DS_LOG_VERBOSE(3, " Column "
-															  << columnName << " type:NULL col seq:" << collSequence
-															  << " not null:" << notNull << " prim key:" << primaryKey
-															  << " autoinc:" << autoInc);
-									}
-								}
-							}
+	/// Lets do the query! Each thread gets its own read-only connection from the pool
+	int	 sqliteResultCode = SQLITE_OK;
+	auto db				  = ds::query::SqlConnectionPool::acquire(dbPath, SQLITE_OPEN_READONLY, &sqliteResultCode);
 
-							auto theText = sqlite3_column_text(statement, i);
+	/// if everything went ok
+	if (db) {
+		DS_LOG_VERBOSE(4, "Executing SQL query " << theQuery.str());
+
+		auto prepared = db.prepare(theQuery.str());
+		if (prepared) {
+			sqlite3_stmt* statement = prepared.get();
+
+			/// Work out what each column is for once, rather than for every row
+			const int				 columnCount = sqlite3_column_count(statement);
+			std::vector<TableColumn> columns(columnCount);
+			for (int i = 0; i < columnCount; i++) {
+				auto columnName = sqlite3_column_name(statement, i);
+				if (columnName) columns[i].mName = columnName;
+
+				/// If we don't have a primary id set already, look up the metadata for this column and see
+				/// if it's the primary key
+				if (primaryId.empty() && columnName) {
+					const char* dataType	 = NULL;
+					const char* collSequence = NULL;
+					int			notNull		 = 0;
+					int			primaryKey	 = 0;
+					int			autoInc		 = 0;
+					sqlite3_table_column_metadata(db.get(), NULL, theTable.c_str(), columnName, &dataType,
+												  &collSequence, &notNull, &primaryKey, &autoInc);
+
+					if (primaryKey) {
+						primaryId = columnName;
+					}
 
-							auto theInt	 = sqlite3_column_int(statement, i);
-							auto theDoub = sqlite3_column_double(statement, i);
+					if (ds::getLogger().hasVerboseLevel(3)) {
+						if (dataType) {
+							DS_LOG_VERBOSE(3, " Column " << columnName << " type:" << dataType
+														 << " col seq:" << collSequence << " not null:" << notNull
+														 << " prim key:" << primaryKey << " autoinc:" << autoInc);
+						} else {
+							DS_LOG_VERBOSE(3, " Column " << columnName << " type:NULL col seq:" << collSequence
+														 << " not null:" << notNull << " prim key:" << primaryKey
+														 << " autoinc:" << autoInc);
+						}
+					}
+				}
+			}
 
-							std::string theData = "";
-							if (theText) {
-								theData = reinterpret_cast<const char*>(theText);
-							}
+			for (auto& column : columns) {
+				column.mIsId	= !column.mName.empty() && column.mName == primaryId;
+				column.mIsName	= !theName.empty() && column.mName == theName;
+				column.mIsLabel = !theLabel.empty() && column.mName == theLabel;
+				column.mIsResource =
+					std::find(resourceColumns.begin(), resourceColumns.end(), column.mName) != resourceColumns.end();
+			}
 
-							if (columnName == primaryId) {
-								thisRow.setId(theInt);
-							}
+			/// in case there's no id field specified or a primary key column
+			int id = 1;
 
-							if (!theName.empty() && columnName == theName) {
-								thisRow.setName(theData);
-							}
-							if (!theLabel.empty() && columnName == theLabel) {
-								thisRow.setLabel(theData);
-							}
+			/// go through all the rows, until there isn't one
+			while (sqlite3_step(statement) == SQLITE_ROW) {
+				ds::model::ContentModelRef thisRow = ds::model::ContentModelRef(theTableAlias, id, theTable + " row");
+				id++;
 
-							thisRow.setProperty(columnName,
-												ds::model::ContentProperty(columnName, theData, theInt, theDoub));
+				for (int i = 0; i < columnCount; i++) {
+					const TableColumn& column = columns[i];
 
-							if (!resourceColumns.empty() && std::find(resourceColumns.begin(), resourceColumns.end(),
-																	  columnName) != resourceColumns.end()) {
-								thisRow.setPropertyResource(columnName, allResources[ds::string_to_int(theData)]);
-							}
-						}
+					auto		theText = sqlite3_column_text(statement, i);
+					std::string theData = "";
+					if (theText) {
+						theData = reinterpret_cast<const char*>(theText);
+					}
 
-						// only parse metada for the first row
-						parsedMetadata = true;
+					auto theInt	 = sqlite3_column_int(statement, i);
+					auto theDoub = sqlite3_column_double(statement, i);
 
-						tableModel.addChild(thisRow);
+					if (column.mIsId) {
+						thisRow.setId(theInt);
+					}
+					if (column.mIsName) {
+						thisRow.setName(theData);
+					}
+					if (column.mIsLabel) {
+						thisRow.setLabel(theData);
+					}
 
+					ds::model::ContentProperty theProp(column.mName, theData, theInt, theDoub);
+					thisRow.setProperty(column.mName, theProp);
 
-					} else {
-						sqlite3_finalize(statement);
-						break;
+					if (column.mIsResource) {
+						// Other tables are looking up resources at the same time, so don't add missing ones
+						auto found = allResources.find(ds::string_to_int(theData));
+						thisRow.setPropertyResource(column.mName,
+													found != allResources.end() ? found->second : ds::Resource());
 					}
 				}
+
+				load.mModel.addChild(thisRow);
+				load.mRows++;
 			}
-			sqlite3_close_v2(db);
-		} else {
-			DS_LOG_ERROR("ContentQuery: Unable to access the database " << dbPath << " (SQLite error "
-																		<< sqliteResultCode << ")." << std::endl);
 		}
+	} else {
+		DS_LOG_ERROR("ContentQuery: Unable to access the database " << dbPath << " (SQLite error " << sqliteResultCode
+																	<< ")." << std::endl);
+	}
 
-		parentModel.addChild(tableModel);
+	Poco::Timestamp::TimeVal after = Poco::Timestamp().epochMicroseconds();
+	load.mSeconds				   = (float)(after - before) / 1000000.0f;
+}
 
-	} // table name is present
+void ContentQuery::runParallel(const size_t count, const std::function<void(const size_t)>& fn) {
+	std::atomic<size_t> next(0);
 
-	auto tableChildren = tableDescription.getChildren();
-	for (auto it : tableChildren) {
-		getDataFromTable(parentModel, it, dbPath, allResources, depth + 1, thisId);
+	auto work = [&next, count, &fn]() {
+		for (size_t index = next++; index < count; index = next++) {
+			fn(index);
+		}
+	};
+
+	/// This thread does its share too
+	const size_t extra = std::min(static_cast<size_t>(std::max(mQueryThreads, 0)), count > 0 ? count - 1 : 0);
+
+	std::vector<std::thread> threads;
+	for (size_t k = 0; k < extra; ++k) {
+		threads.emplace_back(work);
+	}
+	work();
+	for (auto& it : threads) {
+		it.join();
 	}
 }
 
@@ -595,18 +668,14 @@ void ContentQuery::getDataFromTable(ds::model::ContentModelRef parentModel, cons
 
 	std::string dbPath			 = cms.getDatabasePath();
 	std::string sampleQuery		 = "SELECT * FROM " + theTable;
-	sqlite3*	db				 = NULL;
-	const int	sqliteResultCode = sqlite3_open_v2(ds::getNormalizedPath(dbPath).c_str(), &db, SQLITE_OPEN_READONLY, 0);
-	if (sqliteResultCode == SQLITE_OK) {
-		sqlite3_busy_timeout(db, 1500);
-
-		sqlite3_stmt* statement;
-		const int	  err = sqlite3_prepare_v2(db, sampleQuery.c_str(), -1, &statement, 0);
-		if (err != SQLITE_OK) {
-			sqlite3_finalize(statement);
-			DS_LOG_ERROR("SqlDatabase::rawSelect SQL error = " << err << " on select=" << sampleQuery << std::endl);
-		} else {
-			int id = 1;
+	int			sqliteResultCode = SQLITE_OK;
+	auto		db				 = ds::query::SqlConnectionPool::acquire(dbPath, SQLITE_OPEN_READONLY,
+																		 &sqliteResultCode);
+	if (db) {
+		auto prepared = db.prepare(sampleQuery);
+		if (prepared) {
+			sqlite3_stmt* statement = prepared.get();
+			int			  id		= 1;
 
 
 			while (true) {
@@ -629,14 +698,12 @@ void ContentQuery::getDataFromTable(ds::model::ContentModelRef parentModel, cons
 					parentModel.addChild(thisRow);
 
 				} else {
-					sqlite3_finalize(statement);
 					break;
 				}
 			}
 
 			// parentModel.addChild("tables", thisTable);
 		}
-		sqlite3_close_v2(db);
 	} else {
 		DS_LOG_ERROR("ContentQuery: Unable to access the database " << dbPath << " (SQLite error " << sqliteResultCode
 																	<< ")." << std::endl);
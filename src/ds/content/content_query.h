@@ -33,6 +33,8 @@ class ContentQuery : public Poco::Runnable {
 						  const int depth, const int parentModelId);
 
 	ds::model::ContentModelRef mData;
+	/// Every table read by the last run(), before they were nested in each other. Shares its rows with mData.
+	ds::model::ContentModelRef mTables;
 
 	std::string							  mLastUpdatedResource;
 	std::unordered_map<int, ds::Resource> mAllResources;
@@ -48,7 +50,44 @@ class ContentQuery : public Poco::Runnable {
 	std::string mResourceLocation;
 	std::string mXmlDataModel;
 
+	/// Extra threads used to read tables at the same time. 0 reads them one after another.
+	int mQueryThreads;
 	int mTableId;
+
+  private:
+	/// One table from the data model, read on whichever thread gets to it first
+	struct TableLoad {
+		TableLoad()
+		  : mRows(0)
+		  , mSeconds(0.0f) {}
+
+		std::string				   mTable;
+		ds::model::ContentModelRef mDescription;
+		ds::model::ContentModelRef mModel;
+		size_t					   mRows;
+		float					   mSeconds;
+	};
+
+	struct TableTiming {
+		TableTiming(const std::string& name, const size_t rows, const float seconds)
+		  : mName(name)
+		  , mRows(rows)
+		  , mSeconds(seconds) {}
+
+		std::string mName;
+		size_t		mRows;
+		float		mSeconds;
+	};
+
+	void collectTables(ds::model::ContentModelRef tableDescription, const int depth, const int parentModelId,
+					   std::vector<TableLoad>& loads);
+	void loadTable(TableLoad& load, const std::string& dbPath,
+				   const std::unordered_map<int, ds::Resource>& allResources) const;
+	/// Call fn with every index below count, spread over this thread and up to mQueryThreads more
+	void runParallel(const size_t count, const std::function<void(const size_t)>& fn);
+
+	/// How long each table took in the last run(), for the log
+	std::vector<TableTiming> mTableTimings;
 };
 
 } // namespace ds
@@ -10,6 +10,38 @@
 
 namespace ds {
 
+namespace {
+	void hash_combine(size_t& seed, const size_t value) {
+		seed ^= value + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+	}
+
+	/// Covers everything a query sets on a row except its children, which come from other tables
+	size_t hash_row(const ds::model::ContentModelRef& row) {
+		std::hash<std::string> hasher;
+		size_t				   seed = 0;
+		hash_combine(seed, hasher(row.getName()));
+		hash_combine(seed, hasher(row.getLabel()));
+		for (auto& it : row.getProperties()) {
+			hash_combine(seed, hasher(it.first));
+			hash_combine(seed, hasher(it.second.getValue()));
+
+			auto resource = it.second.getResource();
+			if (!resource.empty()) {
+				hash_combine(seed, hasher(resource.getAbsoluteFilePath()));
+				hash_combine(seed, std::hash<float>()(resource.getWidth()));
+				hash_combine(seed, std::hash<float>()(resource.getHeight()));
+				hash_combine(seed, std::hash<double>()(resource.getDuration()));
+			}
+		}
+		return seed;
+	}
+
+	/// Table names can repeat in a data model, ids don't
+	std::string table_key(const ds::model::ContentModelRef& table) {
+		return table.getName() + "#" + std::to_string(table.getId());
+	}
+} // namespace
+
 ContentWrangler::ContentWrangler(ds::ui::SpriteEngine& se)
   : mEngine(se)
   , mContentQuery(se, [] { return new ContentQuery(); })
@@ -48,6 +80,29 @@ void ContentWrangler::recieveQuery(ContentQuery& q) {
 	}
 	DS_LOG_VERBOSE(3, "ContentWrangler: runQuery() complete");
 
+	if (mEngine.getEngineSettings().getBool("content:incremental")) {
+		ContentUpdatedEvent updated;
+		updated.mIncremental = true;
+
+		auto live = mEngine.mContent.getChildByName(q.mData.getName());
+		if (!live) {
+			live = ds::model::ContentModelRef(q.mData.getName(), q.mData.getId(), q.mData.getLabel());
+			live.setProperties(q.mData.getProperties());
+			mEngine.mContent.addChild(live);
+		}
+
+		patchQuery(live, q, updated.mChanges);
+
+		/// Nothing to rebuild if nothing changed
+		if (!updated.mChanges.empty()) {
+			mEngine.getNotifier().notify(updated);
+		}
+		return;
+	}
+
+	// The live models are about to be replaced, so there's nothing to patch next time
+	mSnapshots.clear();
+
 	if (auto match = mEngine.mContent.getChildByName(q.mData.getName())) {
 		using ModelVec	   = std::vector<ds::model::ContentModelRef>;
 		ModelVec newTables = q.mData.getChildren();
@@ -95,6 +150,156 @@ void ContentWrangler::recieveQuery(ContentQuery& q) {
 	mEngine.getNotifier().notify(ContentUpdatedEvent());
 }
 
+void ContentWrangler::patchQuery(ds::model::ContentModelRef live, ContentQuery& q,
+								 std::vector<ContentTableChanges>& changes) {
+	ModelSnapshot& last = mSnapshots[q.mXmlDataModel];
+	ModelSnapshot  next;
+
+	/// The live model that takes the place of each new one that was already loaded
+	std::unordered_map<const void*, ds::model::ContentModelRef> replacements;
+
+	for (auto table : q.mTables.getChildren()) {
+		const std::string key		= table_key(table);
+		auto			  lastTable = last.mTables.find(key);
+		TableSnapshot&	  nextTable = next.mTables[key];
+		nextTable.mTable			= table;
+
+		if (lastTable != last.mTables.end()) {
+			nextTable.mTable = lastTable->second.mTable;
+			nextTable.mTable.setProperties(table.getProperties());
+			replacements[table.getDataPointer()] = nextTable.mTable;
+		}
+
+		ContentTableChanges tableChanges;
+		tableChanges.mTable = table.getName();
+
+		for (auto row : table.getChildren()) {
+			auto&		rows = nextTable.mRows[row.getId()];
+			RowSnapshot rowSnapshot;
+			rowSnapshot.mRow  = row;
+			rowSnapshot.mHash = hash_row(row);
+
+			RowSnapshot* lastRow = nullptr;
+			if (lastTable != last.mTables.end()) {
+				auto found = lastTable->second.mRows.find(row.getId());
+				if (found != lastTable->second.mRows.end() && rows.size() < found->second.size()) {
+					lastRow = &found->second[rows.size()];
+				}
+			}
+
+			if (!lastRow) {
+				tableChanges.mAdded.push_back(row.getId());
+			} else {
+				if (lastRow->mHash != rowSnapshot.mHash) {
+					ds::model::ContentModelRef liveRow = lastRow->mRow;
+					liveRow.setName(row.getName());
+					liveRow.setLabel(row.getLabel());
+					liveRow.setProperties(row.getProperties());
+					tableChanges.mModified.push_back(row.getId());
+				}
+
+				rowSnapshot.mRow				   = lastRow->mRow;
+				replacements[row.getDataPointer()] = lastRow->mRow;
+				// Anything left in the last snapshot afterwards was removed
+				lastRow->mRow = ds::model::ContentModelRef();
+			}
+
+			rows.push_back(rowSnapshot);
+		}
+
+		if (lastTable != last.mTables.end()) {
+			for (auto& it : lastTable->second.mRows) {
+				for (auto& rit : it.second) {
+					if (rit.mRow.getDataPointer()) tableChanges.mRemoved.push_back(it.first);
+				}
+			}
+			last.mTables.erase(lastTable);
+		}
+
+		if (!tableChanges.mAdded.empty() || !tableChanges.mRemoved.empty() || !tableChanges.mModified.empty()) {
+			changes.push_back(tableChanges);
+		}
+	}
+
+	/// Tables that aren't in the data model anymore
+	for (auto& it : last.mTables) {
+		ContentTableChanges tableChanges;
+		tableChanges.mTable = it.second.mTable.getName();
+		for (auto& rit : it.second.mRows) {
+			for (size_t k = 0; k < rit.second.size(); ++k) {
+				tableChanges.mRemoved.push_back(rit.first);
+			}
+		}
+		changes.push_back(tableChanges);
+	}
+
+	auto mapChildren = [&replacements](const std::vector<ds::model::ContentModelRef>& children) {
+		std::vector<ds::model::ContentModelRef> mapped;
+		mapped.reserve(children.size());
+		for (auto& it : children) {
+			auto found = replacements.find(it.getDataPointer());
+			mapped.push_back(found != replacements.end() ? found->second : it);
+		}
+		return mapped;
+	};
+
+	/// The new rows were nested in each other by the query. Point every model that stays, live or new, at the
+	/// models that stay.
+	for (auto table : q.mTables.getChildren()) {
+		auto found = replacements.find(table.getDataPointer());
+		auto stays = found != replacements.end() ? found->second : table;
+		stays.setChildren(mapChildren(table.getChildren()));
+
+		for (auto& row : table.getChildren()) {
+			auto rowFound = replacements.find(row.getDataPointer());
+			auto rowStays = rowFound != replacements.end() ? rowFound->second : row;
+			rowStays.setChildren(mapChildren(row.getChildren()));
+		}
+	}
+
+	/// Swap this data model's top level tables into the live root, leaving any other model's where they are.
+	/// The first time through, tables with the same name are taken to be this model's.
+	next.mTopLevel = mapChildren(q.mData.getChildren());
+
+	std::vector<ds::model::ContentModelRef> liveChildren;
+	bool									inserted = false;
+	for (auto& it : live.getChildren()) {
+		bool ours = false;
+		for (auto& lit : last.mTopLevel) {
+			if (lit.getDataPointer() == it.getDataPointer()) ours = true;
+		}
+		if (last.mTopLevel.empty()) {
+			for (auto& nit : next.mTopLevel) {
+				if (nit.getName() == it.getName()) ours = true;
+			}
+		}
+
+		if (!ours) {
+			liveChildren.push_back(it);
+		} else if (!inserted) {
+			liveChildren.insert(liveChildren.end(), next.mTopLevel.begin(), next.mTopLevel.end());
+			inserted = true;
+		}
+	}
+	if (!inserted) {
+		liveChildren.insert(liveChildren.end(), next.mTopLevel.begin(), next.mTopLevel.end());
+	}
+	live.setChildren(liveChildren);
+
+	last = next;
+
+	if (ds::Logger::hasVerboseLevel(2)) {
+		size_t added = 0, removed = 0, modified = 0;
+		for (auto& it : changes) {
+			added += it.mAdded.size();
+			removed += it.mRemoved.size();
+			modified += it.mModified.size();
+		}
+		DS_LOG_VERBOSE(2, "ContentWrangler: patched " << changes.size() << " tables, " << added << " rows added, "
+													  << removed << " removed, " << modified << " modified");
+	}
+}
+
 /// This will be called on every hard or soft app restart
 void ContentWrangler::initialize() {
 	if (!mEngine.getEngineSettings().getBool("content:use_wrangler")) {
@@ -130,14 +335,17 @@ void ContentWrangler::runQuery() {
 
 	DS_LOG_VERBOSE(3, "ContentWrangler: runQuery() starting");
 
+	const int queryThreads = mEngine.getEngineSettings().getInt("content:query_threads");
+
 	auto allModels = ds::split(mModelModelLocation, ";", true);
 	for (auto it : allModels) {
 		auto thisModel = it;
-		mContentQuery.start([thisModel](ds::ContentQuery& dq) {
+		mContentQuery.start([thisModel, queryThreads](ds::ContentQuery& dq) {
 			const ds::Resource::Id cms(ds::Resource::Id::CMS_TYPE, 0);
 			dq.mXmlDataModel	 = thisModel;
 			dq.mCmsDatabase		 = cms.getDatabasePath();
 			dq.mResourceLocation = cms.getResourcePath();
+			dq.mQueryThreads	 = queryThreads;
 		});
 	}
 }
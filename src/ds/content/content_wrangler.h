@@ -8,6 +8,7 @@
 #include <ds/network/helper/delayed_node_watcher.h>
 #include <ds/thread/parallel_runnable.h>
 
+#include "content_events.h"
 #include "content_model.h"
 #include "content_query.h"
 
@@ -41,6 +42,27 @@ class ContentWrangler {
 
 
   private:
+	/// A row as it was after the last query, with a hash of its contents to spot changes
+	struct RowSnapshot {
+		ds::model::ContentModelRef mRow;
+		size_t					   mHash;
+	};
+
+	/// Rows are found by id. Rows that share an id are told apart by the order they came in.
+	struct TableSnapshot {
+		ds::model::ContentModelRef						  mTable;
+		std::unordered_map<int, std::vector<RowSnapshot>> mRows;
+	};
+
+	/// Everything one data model xml loaded last time
+	struct ModelSnapshot {
+		std::unordered_map<std::string, TableSnapshot> mTables;
+		std::vector<ds::model::ContentModelRef>		   mTopLevel;
+	};
+
+	/// With content:incremental, patch the rows that changed into the live models instead of replacing them
+	void patchQuery(ds::model::ContentModelRef live, ContentQuery& q, std::vector<ContentTableChanges>& changes);
+
 	ds::ui::SpriteEngine&			   mEngine;
 	ds::ParallelRunnable<ContentQuery> mContentQuery;
 
@@ -48,6 +70,9 @@ class ContentWrangler {
 	ds::EventClient		   mEventClient;
 
 	std::string mModelModelLocation;
+
+	/// Keyed by the data model xml
+	std::unordered_map<std::string, ModelSnapshot> mSnapshots;
 };
 
 } // namespace ds
@@ -31,6 +31,18 @@ void DataBuffer::addRaw(const char* b, unsigned size) {
 	mStream.write(b, size);
 }
 
+void DataBuffer::addBuffer(DataBuffer& other) {
+	const unsigned start  = other.mStream.getReadPosition();
+	const unsigned length = other.size();
+	if (length <= start) return;
+
+	mStream.write(other.mStream.data() + start, length - start);
+}
+
+void DataBuffer::setReadView(const char* b, unsigned size) {
+	mStream.setReadView(b, size);
+}
+
 bool DataBuffer::readRaw(char* b, unsigned size) {
 	unsigned currentPosition = mStream.getReadPosition();
 
@@ -23,6 +23,11 @@ class DataBuffer {
 
 	/// function to add raw data no size added.
 	void addRaw(const char* b, unsigned size);
+	/// Add everything in the other buffer that hasn't been read yet, no size added.
+	void addBuffer(DataBuffer& other);
+	/// Read from memory owned by someone else without copying it, replacing my contents.
+	/// The memory must stay valid until I'm cleared or done being read.
+	void setReadView(const char* b, unsigned size);
 	/// function to read raw data no size will be read.
 	bool readRaw(char* b, unsigned size);
 
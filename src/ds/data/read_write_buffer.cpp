@@ -9,6 +9,7 @@ namespace ds {
 ReadWriteBuffer::ReadWriteBuffer(unsigned size /*= 0*/)
   : mSize(size)
   , mBuffer(nullptr)
+  , mView(nullptr)
   , mBufferReadPosition(0)
   , mBufferWritePosition(0)
   , mMaxBufferWritePosition(0) {
@@ -28,13 +29,14 @@ ReadWriteBuffer::~ReadWriteBuffer() {
 bool ReadWriteBuffer::read(char* buffer, unsigned size) {
 	if (mBufferReadPosition + size > mMaxBufferWritePosition) return false;
 
-	memcpy(buffer, mBuffer + mBufferReadPosition, size);
+	memcpy(buffer, (mView ? mView : mBuffer) + mBufferReadPosition, size);
 	mBufferReadPosition += size;
 
 	return true;
 }
 
 bool ReadWriteBuffer::write(const char* buffer, unsigned size) {
+	if (mView) detachView();
 	if (mBufferWritePosition + size > mSize) grow(math::getNextPowerOf2(static_cast<int32_t>(mSize + size)));
 
 	memcpy(mBuffer + mBufferWritePosition, buffer, size);
@@ -51,6 +53,7 @@ void ReadWriteBuffer::reserve(unsigned size) {
 }
 
 void ReadWriteBuffer::clear() {
+	mView					= nullptr;
 	mBufferReadPosition		= 0;
 	mBufferWritePosition	= 0;
 	mMaxBufferWritePosition = 0;
@@ -60,6 +63,20 @@ unsigned ReadWriteBuffer::size() {
 	return mSize;
 }
 
+void ReadWriteBuffer::setReadView(const char* buffer, unsigned size) {
+	mView					= buffer;
+	mBufferReadPosition		= 0;
+	mBufferWritePosition	= size;
+	mMaxBufferWritePosition = size;
+}
+
+void ReadWriteBuffer::detachView() {
+	const char* view = mView;
+	mView			 = nullptr;
+	if (mMaxBufferWritePosition > mSize) grow(math::getNextPowerOf2(static_cast<int32_t>(mMaxBufferWritePosition)));
+	memcpy(mBuffer, view, mMaxBufferWritePosition);
+}
+
 unsigned ReadWriteBuffer::getReadPosition() const {
 	return mBufferReadPosition;
 }
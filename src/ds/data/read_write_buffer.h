@@ -20,6 +20,13 @@ class ReadWriteBuffer {
 	void	 clear();
 	unsigned size();
 
+	/// Read directly from memory owned by someone else, without copying it.
+	/// The memory must outlive the reads. clear() drops the view, and any write copies it in first.
+	void setReadView(const char* buffer, unsigned size);
+	bool isReadView() const { return mView != nullptr; }
+	/// Everything written so far, from the start
+	const char* data() const { return mView ? mView : mBuffer; }
+
 	unsigned getReadPosition() const;
 	void	 setReadPosition(const unsigned& position);
 	void	 setReadPosition(const Postions& position);
@@ -30,8 +37,10 @@ class ReadWriteBuffer {
 
   private:
 	void grow(unsigned size);
+	void detachView();
 
-	char*	 mBuffer;
+	char*		mBuffer;
+	const char* mView;
 	unsigned mSize;
 	unsigned mBufferReadPosition;
 	unsigned mBufferWritePosition;
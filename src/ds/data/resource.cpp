@@ -483,14 +483,13 @@ bool Resource::query(const Resource::Id& id) {
 	const std::string& dbPath = id.getDatabasePath();
 	if (dbPath.empty()) return false;
 
-	std::stringstream buf;
-	buf.str("");
-	buf << "SELECT "
-		   "resourcestype,resourcesduration,resourceswidth,resourcesheight,resourcesfilename,resourcespath,"
-		   "resourcesthumbid FROM Resources WHERE resourcesid = "
-		<< id.mValue;
+	// The same sql for every id, so every lookup shares one prepared statement
+	static const std::string SELECT_RESOURCE(
+		"SELECT "
+		"resourcestype,resourcesduration,resourceswidth,resourcesheight,resourcesfilename,resourcespath,"
+		"resourcesthumbid FROM Resources WHERE resourcesid = ?");
 	query::Result r;
-	if (!query::Client::query(dbPath, buf.str(), r) || r.rowsAreEmpty()) {
+	if (!query::Client::query(dbPath, SELECT_RESOURCE, {id.mValue}, r) || r.rowsAreEmpty()) {
 		return false;
 	}
 
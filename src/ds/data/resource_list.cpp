@@ -27,13 +27,11 @@ bool ResourceList::get(const Resource::Id& id, Resource& ans) {
 bool ResourceList::query(const Resource::Id& id, Resource& ans) {
 	const std::string& dbPath = id.getDatabasePath();
 	if (dbPath.empty()) return false;
-	std::stringstream buf;
-	buf.str("");
-	buf << "SELECT resourcestype,resourcesduration,resourceswidth,resourcesheight,resourcesfilename,resourcespath FROM "
-		   "Resources WHERE resourcesid = "
-		<< id.mValue;
+	static const std::string SELECT_RESOURCE(
+		"SELECT resourcestype,resourcesduration,resourceswidth,resourcesheight,resourcesfilename,resourcespath FROM "
+		"Resources WHERE resourcesid = ?");
 	query::Result r;
-	if (!query::Client::query(dbPath, buf.str(), r) || r.rowsAreEmpty()) return false;
+	if (!query::Client::query(dbPath, SELECT_RESOURCE, {id.mValue}, r) || r.rowsAreEmpty()) return false;
 
 	query::Result::RowIterator it(r);
 	if (!it.hasValue()) return false;
@@ -70,7 +70,9 @@ namespace ds { namespace ui {
 	void AppHostStatsView::updateText() {
 
 		if (mText) {
-			mText->setText("<span weight='bold'>DSAppHost Status: </span>" + mStatus + "<br>");
+			mText->setText("<span weight='bold'>DSAppHost Status: </span>" + mStatus + "<br>" +
+						   "<span weight='bold'>Sprites Updated: </span>" + std::to_string(mEngine.getSpritesUpdated()) +
+						   " / " + std::to_string(mEngine.getSpriteCount()) + "<br>");
 		}
 
 		runLayout();
@@ -2,7 +2,9 @@
 #ifndef DS_NETWORK_NETCONNECTION_H
 #define DS_NETWORK_NETCONNECTION_H
 
+#include <chrono>
 #include <string>
+#include <thread>
 
 namespace ds {
 
@@ -20,6 +22,16 @@ class NetConnection {
 	virtual bool sendMessage(const char* data, int size) = 0;
 
 	virtual int recvMessage(std::string& msg) = 0;
+	/// Receive without copying: points data at the connection's own receive buffer,
+	/// which is only valid until the next receive. Answers the size.
+	virtual int recvMessage(const char*& data) = 0;
+
+	/// Blocks until there's something to receive or timeoutMs passes, for readers on their own thread.
+	/// Answers false if it timed out. Connections that can't wait on their socket just pause briefly.
+	virtual bool waitForData(const int timeoutMs) {
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		return true;
+	}
 
 	virtual bool isServer() const = 0;
 
@@ -160,6 +160,27 @@ int UdpReceiver::recvMessage(std::string& msg) {
 	return 0;
 }
 
+int UdpReceiver::recvMessage(const char*& data) {
+	data = nullptr;
+	if (!mInitialized) return 0;
+
+	try {
+		if (mSocket.available() <= 0) {
+			return 0;
+		}
+
+		int size = mSocket.receiveBytes(mReceiveBuffer.data(), static_cast<int>(mReceiveBuffer.alloc()));
+		if (size > 0) {
+			data = mReceiveBuffer.data();
+			return size;
+		}
+	} catch (std::exception& e) {
+		std::cout << e.what() << std::endl;
+	}
+
+	return 0;
+}
+
 bool UdpReceiver::canRecv() const {
 	if (!mInitialized) return 0;
 
@@ -30,6 +30,7 @@ class UdpReceiver : public NetConnection {
 	virtual bool sendMessage(const char* data, int size) override;
 
 	virtual int recvMessage(std::string& msg) override;
+	virtual int recvMessage(const char*& data) override;
 
 	/// Answer true if I have more data to receive, false otherwise.
 	bool canRecv() const;
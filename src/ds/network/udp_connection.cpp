@@ -3,8 +3,10 @@
 #include "ds/util/string_util.h"
 #include "udp_connection.h"
 #include <Poco/Net/NetException.h>
+#include <chrono>
 #include <ds/debug/logger.h>
 #include <iostream>
+#include <thread>
 
 const unsigned int ds::NET_MAX_UDP_PACKET_SIZE = 2000000;
 
@@ -139,8 +141,8 @@ int UdpConnection::recvMessage(std::string& msg) {
 		int size = mSocket.receiveBytes(mReceiveBuffer.data(), static_cast<int>(mReceiveBuffer.alloc()));
 		if (size > 0) {
 			msg.assign(mReceiveBuffer.data(), size);
+			mReccBytes += size;
 		}
-		mReccBytes += size;
 		return size;
 	} catch (Poco::Net::NetException& e) {
 		DS_LOG_WARNING("UdpConnection::recvMessage() error " << e.message());
@@ -151,6 +153,47 @@ int UdpConnection::recvMessage(std::string& msg) {
 	return 0;
 }
 
+bool UdpConnection::waitForData(const int timeoutMs) {
+	if (!mInitialized) {
+		std::this_thread::sleep_for(std::chrono::milliseconds(timeoutMs));
+		return false;
+	}
+
+	try {
+		return mSocket.poll(Poco::Timespan(static_cast<long>(timeoutMs) * 1000), Poco::Net::Socket::SELECT_READ);
+	} catch (Poco::Net::NetException& e) {
+		DS_LOG_WARNING("UdpConnection::waitForData() error " << e.message());
+	} catch (std::exception& e) {
+		DS_LOG_WARNING("UdpConnection::waitForData() std::exception: " << e.what());
+	}
+
+	return false;
+}
+
+int UdpConnection::recvMessage(const char*& data) {
+	data = nullptr;
+	if (!mInitialized) return 0;
+
+	try {
+		if (mSocket.available() <= 0) {
+			return 0;
+		}
+
+		int size = mSocket.receiveBytes(mReceiveBuffer.data(), static_cast<int>(mReceiveBuffer.alloc()));
+		if (size > 0) {
+			data = mReceiveBuffer.data();
+			mReccBytes += size;
+			return size;
+		}
+	} catch (Poco::Net::NetException& e) {
+		DS_LOG_WARNING("UdpConnection::recvMessage() error " << e.message());
+	} catch (std::exception& e) {
+		DS_LOG_WARNING("UdpConnection::recvMessage() std::exception: " << e.what());
+	}
+
+	return 0;
+}
+
 bool UdpConnection::canRecv() const {
 	if (!mInitialized) return 0;
 
@@ -174,9 +217,7 @@ bool UdpConnection::initialized() const {
 }
 
 int UdpConnection::getReceivedBytes() {
-	int returnAmount = mReccBytes;
-	mReccBytes		 = 0;
-	return returnAmount;
+	return static_cast<int>(mReccBytes.exchange(0));
 }
 
 int UdpConnection::getSentBytes() {
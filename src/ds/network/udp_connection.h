@@ -5,6 +5,7 @@
 #include "ds/network/net_connection.h"
 #include "ds/query/recycle_array.h"
 #include <Poco/Net/MulticastSocket.h>
+#include <atomic>
 #include <memory>
 
 namespace ds {
@@ -25,6 +26,9 @@ class UdpConnection : public NetConnection {
 	bool sendMessage(const char* data, int size);
 
 	int recvMessage(std::string& msg);
+	int recvMessage(const char*& data);
+	/// Polls the socket, so a receive thread sleeps until a packet arrives
+	bool waitForData(const int timeoutMs) override;
 	/// Answer true if I have more data to receive, false otherwise.
 	bool canRecv() const;
 
@@ -39,7 +43,8 @@ class UdpConnection : public NetConnection {
   private:
 	Poco::Net::MulticastSocket mSocket;
 	int						   mSentBytes;
-	int						   mReccBytes;
+	/// Counted on the receive thread, if there is one, and read on the main thread
+	std::atomic<size_t>		   mReccBytes;
 	bool					   mInitialized;
 	int						   mReceiveBufferMaxSize;
 	RecycleArray<char>		   mReceiveBuffer;
@@ -3,17 +3,21 @@
 #include "ds/query/query_client.h"
 
 #include "ds/debug/debug_defines.h"
-#include "ds/query/sql_database.h"
 #include "ds/query/sql_query_result_builder.h"
 #include "ds/thread/work_manager.h"
 #include "ds/util/memory_ds.h"
 
-static bool run_query(ds::query::SqlDatabase& db, const std::string& select, ds::query::Result& qr,
-					  const int flags = 0) {
+static const std::vector<ds::query::SqlParam> NO_PARAMS;
+
+static bool run_query(ds::query::SqlConnection& db, const std::string& select,
+					  const std::vector<ds::query::SqlParam>& params, ds::query::Result& qr, const int flags = 0) {
 	qr.clear();
 	if (select.empty()) return false;
 
-	ds::query::SqlResultBuilder qrb(qr, db.rawSelect(select));
+	ds::query::SqlStatement statement = db.prepare(select);
+	if (!statement.bind(params)) return false;
+
+	ds::query::SqlResultBuilder qrb(qr, statement.get(), false);
 	qrb.build((flags & ds::query::Client::INCLUDE_COLUMN_NAMES_F) != 0);
 	return qrb.isValid();
 }
@@ -21,23 +25,26 @@ static bool run_query(ds::query::SqlDatabase& db, const std::string& select, ds:
 namespace ds { namespace query {
 
 	bool Client::query(const std::string& database, const std::string& select, Result& qr, const int flags) {
+		return query(database, select, NO_PARAMS, qr, flags);
+	}
+
+	bool Client::query(const std::string& database, const std::string& select, const std::vector<SqlParam>& params,
+					   Result& qr, const int flags) {
 		qr.clear();
 		if (database.empty() || select.empty()) return false;
 
-		int			errorCode = 0;
-		SqlDatabase sqlDb(database, SQLITE_OPEN_READONLY, &errorCode);
-		if (errorCode != SQLITE_OK) return false;
-		return run_query(sqlDb, select, qr, flags);
+		SqlConnection db = SqlConnectionPool::acquire(database, SQLITE_OPEN_READONLY);
+		if (!db) return false;
+		return run_query(db, select, params, qr, flags);
 	}
 
 	bool Client::queryWrite(const std::string& database, const std::string& select, Result& qr) {
 		qr.clear();
 		if (database.empty()) return false;
 
-		int			errorCode = 0;
-		SqlDatabase sqlDb(database, SQLITE_OPEN_READWRITE, &errorCode);
-		if (errorCode != SQLITE_OK) return false;
-		return run_query(sqlDb, select, qr);
+		SqlConnection db = SqlConnectionPool::acquire(database, SQLITE_OPEN_READWRITE);
+		if (!db) return false;
+		return run_query(db, select, NO_PARAMS, qr);
 	}
 
 	/**
@@ -88,13 +95,14 @@ namespace ds { namespace query {
 	}
 
 	void Client::Request::run() {
-		int			errorCode = 0;
-		SqlDatabase resourceDB(mDatabase, SQLITE_OPEN_READONLY, &errorCode);
-		if (errorCode != SQLITE_OK) {
+		int			  errorCode	 = 0;
+		SqlConnection resourceDB = SqlConnectionPool::acquire(mDatabase, SQLITE_OPEN_READONLY, &errorCode);
+		if (!resourceDB) {
 			DS_LOG_WARNING("ds::query::Client::Request: Unable to access the resource database (SQLite error "
 						   << errorCode << ").");
 		} else {
-			SqlResultBuilder qrb(mResult, resourceDB.rawSelect(mQuery));
+			SqlStatement	 statement = resourceDB.prepare(mQuery);
+			SqlResultBuilder qrb(mResult, statement.get(), false);
 			qrb.build();
 
 			ResultBuilder::setRequestTime(mResult, mRequestTime);
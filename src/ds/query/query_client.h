@@ -4,6 +4,7 @@
 
 #include "ds/query/query_result.h"
 #include "ds/query/query_talkback.h"
+#include "ds/query/sql_connection_pool.h"
 #include "ds/thread/work_client.h"
 #include "ds/thread/work_request_list.h"
 #include <functional>
@@ -33,6 +34,13 @@ namespace ds { namespace query {
 		*/
 		static bool query(const std::string& database, const std::string& query, Result& result, const int flags = 0);
 
+		/** \brief Run a synchronous query in read-only mode, binding params to the ? parameters in the query.
+					Queries that only differ by their params share one prepared statement, so prefer this for
+					lookups that run over and over, like a row by id.
+		*/
+		static bool query(const std::string& database, const std::string& query, const std::vector<SqlParam>& params,
+						  Result& result, const int flags = 0);
+
 		/** \brief Run a synchronous query in write mode. Only use this method over "query()" if you need to commit
 		   something to the db. \param database The filepath of the sqlite db to query \param query The string of the
 		   query statement to run on the db. E.g. "SELECT * FROM tablename" \param result The result of the query. See
@@ -0,0 +1,321 @@
+#include "stdafx.h"
+
+#include "ds/query/sql_connection_pool.h"
+
+#include <chrono>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+
+#include "ds/query/sql_database.h"
+#include "ds/util/file_meta_data.h"
+
+namespace ds { namespace query {
+
+	namespace {
+		typedef std::chrono::steady_clock steady_clock;
+
+		/// Statements each connection keeps prepared
+		const size_t MAX_STATEMENTS = 32;
+		/// Idle connections kept for each database
+		const size_t MAX_IDLE = 4;
+		/// How long an idle connection stays open
+		const auto MAX_IDLE_TIME = std::chrono::seconds(2);
+		/// Connections are closed after this long, so a replaced database file gets picked up
+		const auto MAX_AGE = std::chrono::seconds(30);
+	} // namespace
+
+	/**
+	 * \class SqlParam
+	 */
+	SqlParam::SqlParam(const int i)
+	  : mType(INTEGER_TYPE)
+	  , mInteger(i)
+	  , mReal(0.0) {}
+
+	SqlParam::SqlParam(const int64_t i)
+	  : mType(INTEGER_TYPE)
+	  , mInteger(i)
+	  , mReal(0.0) {}
+
+	SqlParam::SqlParam(const double d)
+	  : mType(REAL_TYPE)
+	  , mInteger(0)
+	  , mReal(d) {}
+
+	SqlParam::SqlParam(const std::string& s)
+	  : mType(TEXT_TYPE)
+	  , mInteger(0)
+	  , mReal(0.0)
+	  , mText(s) {}
+
+	SqlParam::SqlParam(const char* s)
+	  : mType(TEXT_TYPE)
+	  , mInteger(0)
+	  , mReal(0.0)
+	  , mText(s ? s : "") {}
+
+	int SqlParam::bind(sqlite3_stmt* statement, const int index) const {
+		if (mType == INTEGER_TYPE) return sqlite3_bind_int64(statement, index, mInteger);
+		if (mType == REAL_TYPE) return sqlite3_bind_double(statement, index, mReal);
+		return sqlite3_bind_text(statement, index, mText.c_str(), static_cast<int>(mText.size()), SQLITE_TRANSIENT);
+	}
+
+	/**
+	 * \class SqlStatement
+	 */
+	SqlStatement::SqlStatement()
+	  : mStatement(nullptr)
+	  , mInUse(nullptr) {}
+
+	SqlStatement::SqlStatement(sqlite3_stmt* statement, bool* inUse)
+	  : mStatement(statement)
+	  , mInUse(inUse) {}
+
+	SqlStatement::SqlStatement(SqlStatement&& o)
+	  : mStatement(o.mStatement)
+	  , mInUse(o.mInUse) {
+		o.mStatement = nullptr;
+		o.mInUse	 = nullptr;
+	}
+
+	SqlStatement& SqlStatement::operator=(SqlStatement&& o) {
+		if (this != &o) {
+			release();
+			mStatement	 = o.mStatement;
+			mInUse		 = o.mInUse;
+			o.mStatement = nullptr;
+			o.mInUse	 = nullptr;
+		}
+		return *this;
+	}
+
+	SqlStatement::~SqlStatement() {
+		release();
+	}
+
+	bool SqlStatement::bind(const std::vector<SqlParam>& params) {
+		if (!mStatement) return false;
+
+		for (size_t k = 0; k < params.size(); ++k) {
+			if (params[k].bind(mStatement, static_cast<int>(k + 1)) != SQLITE_OK) return false;
+		}
+		return true;
+	}
+
+	void SqlStatement::release() {
+		if (!mStatement) return;
+
+		if (mInUse) {
+			sqlite3_reset(mStatement);
+			sqlite3_clear_bindings(mStatement);
+			*mInUse = false;
+		} else {
+			sqlite3_finalize(mStatement);
+		}
+		mStatement = nullptr;
+		mInUse	   = nullptr;
+	}
+
+	/**
+	 * \class SqlConnection
+	 */
+	struct SqlConnection::Pooled {
+		struct Cached {
+			Cached(const std::string& sql, sqlite3_stmt* statement)
+			  : mSql(sql)
+			  , mStatement(statement)
+			  , mInUse(true) {}
+
+			std::string	  mSql;
+			sqlite3_stmt* mStatement;
+			bool		  mInUse;
+		};
+
+		Pooled(const std::string& key, std::unique_ptr<SqlDatabase> db)
+		  : mKey(key)
+		  , mDatabase(std::move(db))
+		  , mOpened(steady_clock::now()) {}
+
+		~Pooled() {
+			// The database won't close while it still has statements
+			for (auto it = mStatements.begin(), end = mStatements.end(); it != end; ++it) {
+				sqlite3_finalize(it->mStatement);
+			}
+		}
+
+		/// Make room for one more statement, dropping the least recently used ones nobody is holding
+		void trim() {
+			auto it = mStatements.end();
+			while (mStatements.size() >= MAX_STATEMENTS && it != mStatements.begin()) {
+				--it;
+				if (it->mInUse) continue;
+				mStatementIndex.erase(it->mSql);
+				sqlite3_finalize(it->mStatement);
+				it = mStatements.erase(it);
+			}
+		}
+
+		const std::string			 mKey;
+		std::unique_ptr<SqlDatabase> mDatabase;
+		/// Most recently used first
+		std::list<Cached>											 mStatements;
+		std::unordered_map<std::string, std::list<Cached>::iterator> mStatementIndex;
+		const steady_clock::time_point								 mOpened;
+		steady_clock::time_point									 mReleased;
+	};
+
+	SqlConnection::SqlConnection() {}
+
+	SqlConnection::SqlConnection(std::unique_ptr<Pooled> pooled)
+	  : mPooled(std::move(pooled)) {}
+
+	SqlConnection::SqlConnection(SqlConnection&& o)
+	  : mPooled(std::move(o.mPooled)) {}
+
+	SqlConnection& SqlConnection::operator=(SqlConnection&& o) {
+		if (this != &o) {
+			SqlConnectionPool::release(mPooled);
+			mPooled = std::move(o.mPooled);
+		}
+		return *this;
+	}
+
+	SqlConnection::~SqlConnection() {
+		SqlConnectionPool::release(mPooled);
+	}
+
+	sqlite3* SqlConnection::get() const {
+		if (!mPooled) return nullptr;
+		return mPooled->mDatabase->getHandle();
+	}
+
+	SqlStatement SqlConnection::prepare(const std::string& sql) {
+		if (!mPooled) return SqlStatement();
+
+		Pooled& p	  = *mPooled;
+		auto	found = p.mStatementIndex.find(sql);
+		if (found != p.mStatementIndex.end()) {
+			auto it = found->second;
+			// Someone further up the stack is still stepping through the cached one
+			if (it->mInUse) return SqlStatement(p.mDatabase->rawSelect(sql), nullptr);
+
+			p.mStatements.splice(p.mStatements.begin(), p.mStatements, it);
+			it->mInUse = true;
+			return SqlStatement(it->mStatement, &it->mInUse);
+		}
+
+		sqlite3_stmt* statement = p.mDatabase->rawSelect(sql);
+		if (!statement) return SqlStatement();
+
+		p.trim();
+		p.mStatements.push_front(Pooled::Cached(sql, statement));
+		p.mStatementIndex[sql] = p.mStatements.begin();
+		return SqlStatement(statement, &p.mStatements.front().mInUse);
+	}
+
+	/**
+	 * \class SqlConnectionPool
+	 */
+	struct SqlConnectionPool::State {
+		State()
+		  : mIdleCount(0) {}
+
+		std::mutex mMutex;
+		/// Most recently released last
+		std::unordered_map<std::string, std::vector<std::unique_ptr<SqlConnection::Pooled>>> mIdle;
+		size_t																				 mIdleCount;
+	};
+
+	SqlConnectionPool::State& SqlConnectionPool::getState() {
+		static State STATE;
+		return STATE;
+	}
+
+	SqlConnection SqlConnectionPool::acquire(const std::string& database, const int flags, int* errorCode) {
+		if (errorCode) *errorCode = SQLITE_OK;
+		const std::string key = std::to_string(flags) + ":" + ds::getNormalizedPath(database);
+
+		{
+			State&						state = getState();
+			std::lock_guard<std::mutex> lock(state.mMutex);
+			auto						found = state.mIdle.find(key);
+			if (found != state.mIdle.end() && !found->second.empty()) {
+				std::unique_ptr<SqlConnection::Pooled> pooled(std::move(found->second.back()));
+				found->second.pop_back();
+				--state.mIdleCount;
+				return SqlConnection(std::move(pooled));
+			}
+		}
+
+		int							 result = SQLITE_OK;
+		std::unique_ptr<SqlDatabase> db(new SqlDatabase(database, flags, &result));
+		if (errorCode) *errorCode = result;
+		if (result != SQLITE_OK) return SqlConnection();
+
+		return SqlConnection(std::unique_ptr<SqlConnection::Pooled>(new SqlConnection::Pooled(key, std::move(db))));
+	}
+
+	void SqlConnectionPool::release(std::unique_ptr<SqlConnection::Pooled>& pooled) {
+		if (!pooled) return;
+
+		const auto now = steady_clock::now();
+		if (now - pooled->mOpened < MAX_AGE) {
+			pooled->mReleased = now;
+
+			State&						state = getState();
+			std::lock_guard<std::mutex> lock(state.mMutex);
+			auto&						idle = state.mIdle[pooled->mKey];
+			if (idle.size() < MAX_IDLE) {
+				idle.push_back(std::move(pooled));
+				++state.mIdleCount;
+				return;
+			}
+		}
+
+		// Closed outside the lock
+		pooled.reset();
+	}
+
+	void SqlConnectionPool::closeIdle() {
+		std::vector<std::unique_ptr<SqlConnection::Pooled>> closing;
+		{
+			State&						state = getState();
+			std::lock_guard<std::mutex> lock(state.mMutex);
+			if (state.mIdleCount < 1) return;
+
+			const auto now = steady_clock::now();
+			for (auto it = state.mIdle.begin(); it != state.mIdle.end();) {
+				auto&  idle	 = it->second;
+				size_t count = 0;
+				while (count < idle.size() && now - idle[count]->mReleased >= MAX_IDLE_TIME) {
+					closing.push_back(std::move(idle[count++]));
+				}
+				idle.erase(idle.begin(), idle.begin() + count);
+				state.mIdleCount -= count;
+
+				if (idle.empty()) {
+					it = state.mIdle.erase(it);
+				} else {
+					++it;
+				}
+			}
+		}
+	}
+
+	void SqlConnectionPool::closeAll() {
+		std::vector<std::unique_ptr<SqlConnection::Pooled>> closing;
+		{
+			State&						state = getState();
+			std::lock_guard<std::mutex> lock(state.mMutex);
+			for (auto it = state.mIdle.begin(), end = state.mIdle.end(); it != end; ++it) {
+				for (auto pit = it->second.begin(), pend = it->second.end(); pit != pend; ++pit) {
+					closing.push_back(std::move(*pit));
+				}
+			}
+			state.mIdle.clear();
+			state.mIdleCount = 0;
+		}
+	}
+
+}} // namespace ds::query
@@ -0,0 +1,128 @@
+#pragma once
+#ifndef DS_QUERY_SQLCONNECTIONPOOL_H_
+#define DS_QUERY_SQLCONNECTIONPOOL_H_
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "ds/query/sqlite/sqlite3.h"
+
+namespace ds { namespace query {
+
+	/**
+	 * \class SqlParam
+	 * \brief A value to bind to one of the ? parameters in a statement.
+	 */
+	class SqlParam {
+	  public:
+		SqlParam(const int);
+		SqlParam(const int64_t);
+		SqlParam(const double);
+		SqlParam(const std::string&);
+		SqlParam(const char*);
+
+		/// Answers the sqlite result code
+		int bind(sqlite3_stmt*, const int index) const;
+
+	  private:
+		enum Type { INTEGER_TYPE, REAL_TYPE, TEXT_TYPE };
+
+		Type		mType;
+		int64_t		mInteger;
+		double		mReal;
+		std::string mText;
+	};
+
+	/**
+	 * \class SqlStatement
+	 * \brief A prepared statement borrowed from an SqlConnection. When it's destroyed it's reset and handed back
+	 * to the connection for the next query with the same sql, so it can't outlive the connection.
+	 */
+	class SqlStatement {
+	  public:
+		SqlStatement();
+		SqlStatement(SqlStatement&&);
+		SqlStatement& operator=(SqlStatement&&);
+		~SqlStatement();
+
+		sqlite3_stmt* get() const { return mStatement; }
+
+		explicit operator bool() const { return mStatement != nullptr; }
+
+		/// Bind params to the statement's parameters, in order. Answers false if any of them fail.
+		bool bind(const std::vector<SqlParam>& params);
+
+	  private:
+		friend class SqlConnection;
+		SqlStatement(sqlite3_stmt*, bool* inUse);
+		SqlStatement(const SqlStatement&);
+		SqlStatement& operator=(const SqlStatement&);
+
+		void release();
+
+		sqlite3_stmt* mStatement;
+		/// The flag on the connection's cached copy, or null if the statement was prepared just for this
+		bool* mInUse;
+	};
+
+	/**
+	 * \class SqlConnection
+	 * \brief An open database borrowed from the SqlConnectionPool. Only one thread uses a connection at a time,
+	 * and it goes back to the pool when this is destroyed.
+	 */
+	class SqlConnection {
+	  public:
+		SqlConnection();
+		SqlConnection(SqlConnection&&);
+		SqlConnection& operator=(SqlConnection&&);
+		~SqlConnection();
+
+		sqlite3* get() const;
+
+		explicit operator bool() const { return mPooled != nullptr; }
+
+		/// Answer a prepared statement for sql, reusing the one from the last time this connection ran the same sql.
+		/// Logs and answers an empty statement if the sql doesn't compile.
+		SqlStatement prepare(const std::string& sql);
+
+	  private:
+		friend class SqlConnectionPool;
+		struct Pooled;
+
+		SqlConnection(std::unique_ptr<Pooled>);
+		SqlConnection(const SqlConnection&);
+		SqlConnection& operator=(const SqlConnection&);
+
+		std::unique_ptr<Pooled> mPooled;
+	};
+
+	/**
+	 * \class SqlConnectionPool
+	 * \brief Keeps sqlite databases open between queries, so looking up a single row doesn't cost an open, a close
+	 * and a fresh prepare. Connections are keyed by file and open flags, and each thread gets its own.
+	 * Idle connections are closed after a couple of seconds, so the files aren't held open for long (on Windows
+	 * that would stop the cms from replacing them), and connections are retired after a while even when busy.
+	 */
+	class SqlConnectionPool {
+	  public:
+		/// Answer an open connection to database, or an empty one if it can't be opened.
+		static SqlConnection acquire(const std::string& database, const int flags, int* errorCode = nullptr);
+
+		/// Close any connections that have been idle too long. The engine calls this every update.
+		static void closeIdle();
+		/// Close every idle connection, for instance before replacing a database file.
+		static void closeAll();
+
+	  private:
+		friend class SqlConnection;
+		struct State;
+
+		static State& getState();
+		static void	  release(std::unique_ptr<SqlConnection::Pooled>&);
+	};
+
+}} // namespace ds::query
+
+#endif // DS_QUERY_SQLCONNECTIONPOOL_H_
@@ -137,7 +137,8 @@ namespace ds { namespace query {
 		const int	  err = sqlite3_prepare_v2(db, rawSqlSelect.c_str(), -1, &statement, 0);
 		if (err != SQLITE_OK) {
 			sqlite3_finalize(statement);
-			DS_LOG_ERROR("SqlDatabase::rawSelect SQL error = " << err << " on select=" << rawSqlSelect << std::endl);
+			DS_LOG_ERROR("SqlDatabase::rawSelect SQL error = " << err << " message=" << sqlite3_errmsg(db)
+															   << " on select=" << rawSqlSelect << std::endl);
 			return NULL;
 		}
 		return statement;
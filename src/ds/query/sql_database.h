@@ -21,6 +21,8 @@ namespace ds { namespace query {
 		/// Client is responsible for finalizing the statement.
 		sqlite3_stmt* rawSelect(const std::string& rawSqlSelect);
 
+		sqlite3* getHandle() const { return db; }
+
 	  private:
 		sqlite3*	db;
 		std::string db_file;
@@ -11,15 +11,16 @@ namespace ds { namespace query {
 	/**
 	 * \class SqlResultBuilder
 	 */
-	SqlResultBuilder::SqlResultBuilder(Result& qr, sqlite3_stmt* stmt)
+	SqlResultBuilder::SqlResultBuilder(Result& qr, sqlite3_stmt* stmt, const bool ownsStatement)
 	  : ResultBuilder(qr)
 	  , mStatement(stmt)
+	  , mOwnsStatement(ownsStatement)
 	  , mStatementResult(SQLITE_ERROR) {
 		next();
 	}
 
 	SqlResultBuilder::~SqlResultBuilder() {
-		if (mStatement) sqlite3_finalize(mStatement);
+		if (mStatement && mOwnsStatement) sqlite3_finalize(mStatement);
 	}
 
 	int SqlResultBuilder::getColumnCount() const {
@@ -14,7 +14,8 @@ namespace ds { namespace query {
 	 */
 	class SqlResultBuilder : public ResultBuilder {
 	  public:
-		SqlResultBuilder(Result&, sqlite3_stmt* = nullptr);
+		/// The statement is finalized when this is done with it, unless it's borrowed from an SqlConnection
+		SqlResultBuilder(Result&, sqlite3_stmt* = nullptr, const bool ownsStatement = true);
 		virtual ~SqlResultBuilder();
 
 		virtual int			getColumnCount() const;
@@ -27,6 +28,7 @@ namespace ds { namespace query {
 
 	  private:
 		sqlite3_stmt* mStatement;
+		const bool	  mOwnsStatement;
 		int			  mStatementResult;
 		/// Reuse our string buffer
 		std::stringstream mStrBuf;
@@ -0,0 +1,82 @@
+#pragma once
+#ifndef DS_THREAD_SPSCQUEUE_H_
+#define DS_THREAD_SPSCQUEUE_H_
+
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+namespace ds {
+
+/**
+ * \class SpscQueue
+ * \brief Lock-free, fixed-capacity queue for exactly one producer thread and one consumer thread.
+ * Entries are moved in and out, so heavy types like std::string can hand their allocations
+ * across threads without copying.
+ */
+template <typename T>
+class SpscQueue {
+  public:
+	/// Capacity is rounded up to a power of two
+	SpscQueue(const size_t capacity = 64);
+
+	/// Producer thread only. Answers false if the queue is full, in which case t is untouched.
+	bool push(T&& t);
+	/// Consumer thread only. Answers false if the queue is empty.
+	bool pop(T& t);
+
+	/// Approximate, since either side may be in the middle of an operation
+	size_t size() const;
+
+  private:
+	SpscQueue(const SpscQueue&);
+	SpscQueue& operator=(const SpscQueue&);
+
+	std::vector<T> mSlots;
+	size_t		   mMask;
+	/// Next slot to pop, written only by the consumer
+	std::atomic<size_t> mHead;
+	/// Next slot to push, written only by the producer
+	std::atomic<size_t> mTail;
+};
+
+template <typename T>
+SpscQueue<T>::SpscQueue(const size_t capacity)
+  : mHead(0)
+  , mTail(0) {
+	size_t size = 2;
+	while (size < capacity) {
+		size <<= 1;
+	}
+	mSlots.resize(size);
+	mMask = size - 1;
+}
+
+template <typename T>
+bool SpscQueue<T>::push(T&& t) {
+	const size_t tail = mTail.load(std::memory_order_relaxed);
+	if (tail - mHead.load(std::memory_order_acquire) > mMask) return false;
+
+	mSlots[tail & mMask] = std::move(t);
+	mTail.store(tail + 1, std::memory_order_release);
+	return true;
+}
+
+template <typename T>
+bool SpscQueue<T>::pop(T& t) {
+	const size_t head = mHead.load(std::memory_order_relaxed);
+	if (head == mTail.load(std::memory_order_acquire)) return false;
+
+	t = std::move(mSlots[head & mMask]);
+	mHead.store(head + 1, std::memory_order_release);
+	return true;
+}
+
+template <typename T>
+size_t SpscQueue<T>::size() const {
+	return mTail.load(std::memory_order_acquire) - mHead.load(std::memory_order_acquire);
+}
+
+} // namespace ds
+
+#endif // DS_THREAD_SPSCQUEUE_H_
@@ -54,6 +54,8 @@ namespace ds { namespace ui {
 	  protected:
 		virtual void			drawClient(const ci::mat4& transformMatrix, const ds::DrawParams& drawParams) override;
 		virtual ds::ui::Sprite* getHit(const ci::vec3& point) override;
+		/// Children are picked through my camera, not my rectangle
+		virtual bool hasPickBounds() const override { return false; }
 
 		void updateCam(const ci::mat4& transform);
 
@@ -2,6 +2,7 @@
 
 #include "load_image_service.h"
 
+#include <cassert>
 #include <chrono>
 
 #include <ds/debug/logger.h>
@@ -44,6 +45,10 @@ using StopWatch			 = GenericStopWatch<>;
 using SystemStopWatch	 = GenericStopWatch<std::chrono::system_clock>;
 using MonotonicStopWatch = GenericStopWatch<std::chrono::steady_clock>;
 
+/// Off-screen images are ranked in steps of a quarter of the screen's diagonal, then by age
+const float PRIORITY_STEP	 = 0.25f;
+const int	HIDDEN_PRIORITY = 1 << 20;
+
 } // anonymous namespace
 
 
@@ -51,6 +56,9 @@ namespace ds::ui {
 
 LoadImageService::LoadImageService(ds::ui::SpriteEngine& eng)
   : ds::AutoUpdate(eng, AutoUpdateType::SERVER | AutoUpdateType::CLIENT)
+  , mWaitTotal(0.0)
+  , mWaitMax(0.0)
+  , mWaitCount(0)
   , mShouldQuit(false)
   , mTextureOnMainThread(false)
   , mCacheEverything(false) {
@@ -102,8 +110,26 @@ void LoadImageService::logCache() {
 	}
 }
 
+size_t LoadImageService::getQueueDepth() const {
+	std::lock_guard<std::mutex> lock(mRequestsMutex);
+	return mRequests.size();
+}
+
+void LoadImageService::getQueueWait(double& averageSeconds, double& maxSeconds) {
+	std::lock_guard<std::mutex> lock(mRequestsMutex);
+	averageSeconds = (mWaitCount > 0 ? mWaitTotal / static_cast<double>(mWaitCount) : 0.0);
+	maxSeconds	   = mWaitMax;
+	mWaitTotal	   = 0.0;
+	mWaitMax	   = 0.0;
+	mWaitCount	   = 0;
+}
+
 void LoadImageService::stopThreads() {
-	mShouldQuit = true;
+	{
+		std::lock_guard<std::mutex> lock(mRequestsMutex);
+		mShouldQuit = true;
+	}
+	mRequestsCondition.notify_all();
 
 	for (auto it : mThreads) {
 		it->join();
@@ -182,6 +208,67 @@ void LoadImageService::update(const ds::UpdateParams&) {
 	}
 
 	newCompletedRequests.clear();
+
+	updatePriorities();
+}
+
+int LoadImageService::getPriority(const std::string& filePath) const {
+	auto findy = mCallbacks.find(filePath);
+	if (findy == mCallbacks.end()) return HIDDEN_PRIORITY;
+
+	const ci::Rectf& screen = mEngine.getSrcRect();
+	const float		 diagonal = glm::length(ci::vec2(screen.getWidth(), screen.getHeight()));
+	const float		 step	  = std::max(1.0f, diagonal * PRIORITY_STEP);
+
+	int priority = HIDDEN_PRIORITY;
+	for (auto it = findy->second.begin(), end = findy->second.end(); it != end; ++it) {
+		const Image* image = static_cast<const Image*>(it->first);
+		if (!image) continue;
+
+		// Anything hidden, or not in a root, won't be seen any time soon
+		bool		  shown = true;
+		const Sprite* top	= image;
+		for (const Sprite* s = image; s; s = s->getParent()) {
+			if (!s->visible()) {
+				shown = false;
+				break;
+			}
+			top = s;
+		}
+		if (!shown || top == image) continue;
+
+		const ci::vec3 local(image->getWidth() * 0.5f, image->getHeight() * 0.5f, 0.0f);
+		const ci::vec3 center = image->localToGlobal(local);
+		const float	   dx	  = std::max(0.0f, std::max(screen.x1 - center.x, center.x - screen.x2));
+		const float	   dy	  = std::max(0.0f, std::max(screen.y1 - center.y, center.y - screen.y2));
+		const float	   off	  = glm::length(ci::vec2(dx, dy));
+		const int	   p	  = (off <= 0.0f ? 0 : 1 + std::min(HIDDEN_PRIORITY - 2, static_cast<int>(off / step)));
+		if (p < priority) priority = p;
+		if (priority == 0) break;
+	}
+	return priority;
+}
+
+void LoadImageService::updatePriorities() {
+	// Only the loads still waiting for a thread can be moved around, so don't rank everything in use
+	std::vector<std::string> queued;
+	{
+		std::lock_guard<std::mutex> lock(mRequestsMutex);
+		if (mRequests.empty()) return;
+		mRequests.getFilePaths(queued);
+	}
+
+	std::vector<int> priorities;
+	priorities.reserve(queued.size());
+	for (auto it = queued.begin(), end = queued.end(); it != end; ++it) {
+		priorities.push_back(getPriority(*it));
+	}
+
+	// Anything a thread took in the meantime is no longer in the queue, and setPriority() skips it
+	std::lock_guard<std::mutex> lock(mRequestsMutex);
+	for (size_t i = 0; i < queued.size(); ++i) {
+		mRequests.setPriority(queued[i], priorities[i]);
+	}
 }
 
 void LoadImageService::acquire(const std::string&    filePath, const int flags, Image* requester,
@@ -223,15 +310,18 @@ void LoadImageService::acquire(const std::string&    filePath, const int flags,
 	mCallbacks[filePath][requester] = loadedCallback;
 
 	// ok, this image isn't cached and it's not currently in use/loading, start a new load request
+	const int priority = getPriority(filePath);
 	{
 		std::lock_guard<std::mutex> lock(mRequestsMutex);
 
-		// Skip if there's already a request for the same image file path
-		const auto it = std::find_if(mRequests.begin(), mRequests.end(), [&filePath](const auto& e) {
-			return e.mLoading == true && e.mFilePath == filePath;
-		});
-		if (it == mRequests.end()) mRequests.push_back(mInUseImages[filePath]);
+		// Skip if there's already a request for the same image file path, but a new requester might want it sooner
+		if (mRequests.contains(filePath)) {
+			mRequests.setPriority(filePath, priority);
+			return;
+		}
+		mRequests.push(mInUseImages[filePath], priority);
 	}
+	mRequestsCondition.notify_one();
 }
 
 
@@ -263,10 +353,7 @@ void LoadImageService::release(const std::string& filePath, Image* referrer) {
 	// Also remove this from the pending mRequests queue so the background thread doesn't try to load it...
 	if (wasRemoved) {
 		std::lock_guard<std::mutex> lock(mRequestsMutex);
-		const auto					requestFind = std::find_if(mRequests.begin(), mRequests.end(),
-															   [&filePath](const auto& e) { return e.mFilePath == filePath; });
-		if (requestFind != mRequests.end()) {
-			mRequests.erase(requestFind);
+		if (mRequests.erase(filePath)) {
 			DS_LOG_VERBOSE(4, "LoadImageService: Removing request for: " << filePath);
 		}
 	}
@@ -300,22 +387,18 @@ void LoadImageService::loadImagesThreadFn(ci::gl::ContextRef context) {
 
 	while (!mShouldQuit) {
 		ImageLoadRequest nextImage;
-		bool			 gotRequest = false;
 
 		{
-			std::lock_guard<std::mutex> lock(mRequestsMutex);
-			if (!mRequests.empty()) {
-				// Get first request from the queue
-				nextImage = mRequests.front();
-				mRequests.erase(mRequests.begin());
-				gotRequest = true;
-			}
-		}
-
-		// there was no filepaths, so wait and try again in a little bit (the time is a guess)
-		if (!gotRequest) {
-			std::this_thread::sleep_for(4ms);
-			continue;
+			// Sleep until there's something to load
+			std::unique_lock<std::mutex> lock(mRequestsMutex);
+			mRequestsCondition.wait(lock, [this] { return mShouldQuit || !mRequests.empty(); });
+			if (mShouldQuit) break;
+
+			double waited = 0.0;
+			mRequests.pop(nextImage, waited);
+			mWaitTotal += waited;
+			mWaitMax = std::max(mWaitMax, waited);
+			mWaitCount++;
 		}
 
 		// Setup texture format
@@ -453,8 +536,9 @@ void LoadImageService::loadImagesThreadFn(ci::gl::ContextRef context) {
 																		 << std::this_thread::get_id());
 				{
 					std::lock_guard<std::mutex> lock(mRequestsMutex);
-					mRequests.push_back(nextImage);
+					if (!mRequests.contains(nextImage.mFilePath)) mRequests.push(nextImage, HIDDEN_PRIORITY - 1);
 				}
+				mRequestsCondition.notify_one();
 			}
 		} catch (std::exception& exc) {
 			nextImage.mError = true;
@@ -477,4 +561,118 @@ void LoadImageService::loadImagesThreadFn(ci::gl::ContextRef context) {
 	// DS_LOG_VERBOSE(1, "Exiting load thread " << std::this_thread::get_id());
 }
 
+/**
+ * LoadImageService::RequestQueue
+ */
+LoadImageService::RequestQueue::RequestQueue()
+  : mSequence(0) {}
+
+bool LoadImageService::RequestQueue::contains(const std::string& filePath) const {
+	return mIndex.find(filePath) != mIndex.end();
+}
+
+void LoadImageService::RequestQueue::push(const ImageLoadRequest& request, const int priority) {
+	Entry e;
+	e.mRequest	  = request;
+	e.mPriority	  = priority;
+	e.mSequence	  = mSequence++;
+	e.mQueuedTime = Clock::now();
+	mHeap.push_back(std::move(e));
+	mIndex[request.mFilePath] = mHeap.size() - 1;
+	siftUp(mHeap.size() - 1);
+}
+
+bool LoadImageService::RequestQueue::pop(ImageLoadRequest& request, double& waitSeconds) {
+	if (mHeap.empty()) return false;
+
+	waitSeconds = std::chrono::duration<double>(Clock::now() - mHeap.front().mQueuedTime).count();
+	// Copied, not moved: removeAt() finds the index entry by the request's path
+	request = mHeap.front().mRequest;
+	removeAt(0);
+	return true;
+}
+
+bool LoadImageService::RequestQueue::erase(const std::string& filePath) {
+	auto findy = mIndex.find(filePath);
+	if (findy == mIndex.end()) return false;
+
+	removeAt(findy->second);
+	return true;
+}
+
+void LoadImageService::RequestQueue::setPriority(const std::string& filePath, const int priority) {
+	auto findy = mIndex.find(filePath);
+	if (findy == mIndex.end()) return;
+
+	const size_t i	 = findy->second;
+	const int	 old = mHeap[i].mPriority;
+	if (old == priority) return;
+
+	mHeap[i].mPriority = priority;
+	if (priority < old) {
+		siftUp(i);
+	} else {
+		siftDown(i);
+	}
+}
+
+void LoadImageService::RequestQueue::getFilePaths(std::vector<std::string>& filePaths) const {
+	filePaths.reserve(filePaths.size() + mHeap.size());
+	for (auto it = mHeap.begin(), end = mHeap.end(); it != end; ++it) {
+		filePaths.push_back(it->mRequest.mFilePath);
+	}
+}
+
+bool LoadImageService::RequestQueue::before(const size_t a, const size_t b) const {
+	if (mHeap[a].mPriority != mHeap[b].mPriority) return mHeap[a].mPriority < mHeap[b].mPriority;
+	return mHeap[a].mSequence < mHeap[b].mSequence;
+}
+
+void LoadImageService::RequestQueue::swapEntries(const size_t a, const size_t b) {
+	std::swap(mHeap[a], mHeap[b]);
+	mIndex[mHeap[a].mRequest.mFilePath] = a;
+	mIndex[mHeap[b].mRequest.mFilePath] = b;
+}
+
+void LoadImageService::RequestQueue::siftUp(size_t i) {
+	while (i > 0) {
+		const size_t parent = (i - 1) / 2;
+		if (!before(i, parent)) return;
+		swapEntries(i, parent);
+		i = parent;
+	}
+}
+
+void LoadImageService::RequestQueue::siftDown(size_t i) {
+	const size_t count = mHeap.size();
+	while (true) {
+		const size_t left  = i * 2 + 1;
+		const size_t right = left + 1;
+		size_t		 first = i;
+		if (left < count && before(left, first)) first = left;
+		if (right < count && before(right, first)) first = right;
+		if (first == i) return;
+		swapEntries(i, first);
+		i = first;
+	}
+}
+
+void LoadImageService::RequestQueue::removeAt(const size_t i) {
+	mIndex.erase(mHeap[i].mRequest.mFilePath);
+
+	const size_t last = mHeap.size() - 1;
+	if (i != last) {
+		mHeap[i] = std::move(mHeap[last]);
+		mIndex[mHeap[i].mRequest.mFilePath] = i;
+	}
+	mHeap.pop_back();
+
+	if (i < mHeap.size()) {
+		siftUp(i);
+		siftDown(i);
+	}
+	// A stale index entry would make contains() hold a popped path back from being queued again
+	assert(mIndex.size() == mHeap.size());
+}
+
 } // namespace ds::ui
@@ -2,6 +2,10 @@
 #ifndef DS_UI_SERVICE_LOAD_IMAGE_SERVICE
 #define DS_UI_SERVICE_LOAD_IMAGE_SERVICE
 
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+
 #include <cinder/Thread.h>
 #include <cinder/gl/Texture.h>
 #include <ds/app/auto_update.h>
@@ -51,6 +55,12 @@ class LoadImageService : public ds::AutoUpdate {
 	/// Logs all in-use and cached images to info
 	void logCache();
 
+	/// Images waiting for a loading thread
+	size_t getQueueDepth() const;
+	/// Seconds the images picked up by the loading threads since the last call spent waiting in the queue.
+	/// Resets the stats each call.
+	void getQueueWait(double& averageSeconds, double& maxSeconds);
+
   private:
 	/// Keeps track of requests for images, in-use images, and cached images
 	struct ImageLoadRequest {
@@ -74,6 +84,45 @@ class LoadImageService : public ds::AutoUpdate {
 	};
 
 
+	typedef std::chrono::steady_clock Clock;
+
+	/// Pending loads, nearest the screen first, then oldest first. A heap with an index by file path,
+	/// so adding, taking, cancelling or reprioritizing a request is O(log n).
+	class RequestQueue {
+	  public:
+		RequestQueue();
+
+		bool   empty() const { return mHeap.empty(); }
+		size_t size() const { return mHeap.size(); }
+		bool   contains(const std::string& filePath) const;
+
+		void push(const ImageLoadRequest&, const int priority);
+		/// Take the first request, and how long it waited
+		bool pop(ImageLoadRequest&, double& waitSeconds);
+		bool erase(const std::string& filePath);
+		void setPriority(const std::string& filePath, const int priority);
+		/// The file paths still waiting, in no particular order
+		void getFilePaths(std::vector<std::string>&) const;
+
+	  private:
+		struct Entry {
+			ImageLoadRequest  mRequest;
+			int				  mPriority;
+			uint64_t		  mSequence;
+			Clock::time_point mQueuedTime;
+		};
+
+		bool before(const size_t a, const size_t b) const;
+		void swapEntries(const size_t a, const size_t b);
+		void siftUp(size_t);
+		void siftDown(size_t);
+		void removeAt(const size_t);
+
+		std::vector<Entry>						mHeap;
+		std::unordered_map<std::string, size_t> mIndex;
+		uint64_t								mSequence;
+	};
+
 	std::unordered_map<std::string, std::unordered_map<void*, LoadedCallback>> mCallbacks;
 
 	virtual void update(const ds::UpdateParams&) override;
@@ -84,17 +133,24 @@ class LoadImageService : public ds::AutoUpdate {
 	std::unordered_map<std::string, ImageLoadRequest> mInUseImages;
 
 	void loadImagesThreadFn(ci::gl::ContextRef context);
+	/// Lower loads sooner: 0 is on screen, farther off screen counts up, hidden is last
+	int	 getPriority(const std::string& filePath) const;
+	void updatePriorities();
 
 	std::vector<std::shared_ptr<std::thread>> mThreads;
 	/// shared between threads
 
-	mutable std::mutex			  mRequestsMutex;
-	std::vector<ImageLoadRequest> mRequests;
+	mutable std::mutex		mRequestsMutex;
+	std::condition_variable mRequestsCondition;
+	RequestQueue			mRequests;
+	double					mWaitTotal;
+	double					mWaitMax;
+	int						mWaitCount;
 
 	mutable std::mutex			  mLoadedMutex;
 	std::vector<ImageLoadRequest> mLoadedRequests;
 
-	bool mShouldQuit;
+	std::atomic<bool> mShouldQuit;
 
 	bool mTextureOnMainThread;
 	bool mCacheEverything;
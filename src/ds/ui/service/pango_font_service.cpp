@@ -4,6 +4,7 @@
 
 #include "ds/app/environment.h"
 #include "ds/debug/logger.h"
+#include "ds/ui/sprite/sprite_engine.h"
 
 #include <algorithm>
 #include <ds/util/file_meta_data.h>
@@ -19,7 +20,9 @@ const ds::BitMask PANGO_FONT_LOG_M = ds::Logger::newModule("pango_font");
 namespace ds { namespace ui {
 
 	PangoFontService::PangoFontService(ds::ui::SpriteEngine& eng)
-	  : mFontMap(nullptr) {
+	  : mEngine(eng)
+	  , mFontMap(nullptr)
+	  , mTextQuit(false) {
 
 
 		// Note: _putenv doesn't work for successfully propagating variables to the pango / fontconfig dll's
@@ -34,6 +37,10 @@ namespace ds { namespace ui {
 		}
 	}
 
+	PangoFontService::~PangoFontService() {
+		stopTextThreads();
+	}
+
 	void PangoFontService::loadFonts() {
 		DS_LOG_INFO_M("Initializing Pango version " << PANGO_VERSION_STRING
 													<< " runtime version: " << pango_version_string(),
@@ -184,4 +191,76 @@ namespace ds { namespace ui {
 		return mFontMap;
 	}
 
+	void PangoFontService::queueTextWork(const std::function<void(PangoContext*)>& work) {
+		if (!work) return;
+
+		std::lock_guard<std::mutex> lock(mTextMutex);
+		if (mTextThreads.empty()) {
+			const int numThreads = std::max(1, mEngine.getEngineSettings().getInt("text:render_threads", 0, 1));
+			for (int i = 0; i < numThreads; ++i) {
+				mTextThreads.emplace_back([this] { textThreadFn(); });
+			}
+		}
+
+		mTextWork.push_back(work);
+		mTextCondition.notify_one();
+	}
+
+	const std::shared_ptr<TextCache>& PangoFontService::getTextCache() {
+		if (!mTextCache) {
+			mTextCache = std::make_shared<TextCache>();
+
+			auto& settings = mEngine.getEngineSettings();
+			if (settings.getBool("text:cache", 0, true)) {
+				const size_t megabytes = std::max(0, settings.getInt("text:cache_megabytes", 0, 64));
+				const size_t entries   = std::max(0, settings.getInt("text:cache_entries", 0, 4096));
+				mTextCache->setLimits(megabytes * 1024 * 1024, entries);
+			}
+		}
+		return mTextCache;
+	}
+
+	bool PangoFontService::getTextMipmap() {
+		if (!mTextMipmap.valid()) mTextMipmap = mEngine.getEngineSettings().getHandle("text_mipmap", 0, "false");
+		return mTextMipmap.getBool();
+	}
+
+	void PangoFontService::textThreadFn() {
+		// Since pango 1.32.6 the default font map belongs to the calling thread
+		PangoContext* context = pango_font_map_create_context(pango_cairo_font_map_get_default());
+		if (!context) {
+			DS_LOG_WARNING_M("Cannot create a pango font context for the text thread.", PANGO_FONT_LOG_M);
+		}
+
+		while (true) {
+			std::function<void(PangoContext*)> work;
+			{
+				std::unique_lock<std::mutex> lock(mTextMutex);
+				mTextCondition.wait(lock, [this] { return mTextQuit || !mTextWork.empty(); });
+				if (mTextQuit) break;
+
+				work = std::move(mTextWork.front());
+				mTextWork.pop_front();
+			}
+
+			work(context);
+		}
+
+		if (context) g_object_unref(context);
+	}
+
+	void PangoFontService::stopTextThreads() {
+		{
+			std::lock_guard<std::mutex> lock(mTextMutex);
+			mTextQuit = true;
+			mTextWork.clear();
+		}
+		mTextCondition.notify_all();
+
+		for (auto& thread : mTextThreads) {
+			if (thread.joinable()) thread.join();
+		}
+		mTextThreads.clear();
+	}
+
 }} // namespace ds::ui
@@ -3,11 +3,21 @@
 #define DS_UI_SERVICE_PANGO_FONT_SERVICE_H_
 
 #include "ds/app/engine/engine_service.h"
+#include "ds/cfg/settings.h"
+#include "ds/ui/service/text_cache.h"
 
+#include <condition_variable>
+#include <deque>
+#include <functional>
 #include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
 #include <vector>
 
+struct _PangoContext;
 struct _PangoFontMap;
+typedef struct _PangoContext PangoContext;
 typedef struct _PangoFontMap PangoFontMap;
 
 namespace ds { namespace ui {
@@ -41,6 +51,7 @@ namespace ds { namespace ui {
 
 	  public:
 		PangoFontService(ds::ui::SpriteEngine& eng);
+		~PangoFontService();
 
 		/// Clears previously-loaded fonts and reloads the fonts installed in Windows
 		void loadFonts();
@@ -65,10 +76,36 @@ namespace ds { namespace ui {
 		/// For creating pango contexts. Check for nullptr before using
 		PangoFontMap* getPangoFontMap();
 
+		/// Runs work on one of the text threads (see the text:render_threads setting), which starts them the first
+		/// time. Font maps and contexts can't be shared between threads, so each thread passes in a context made
+		/// from its own default font map, or nullptr if it couldn't make one. Work still queued when the service is
+		/// destroyed never runs.
+		void queueTextWork(const std::function<void(PangoContext*)>& work);
+
+		/// Rendered text shared by all the text sprites, sized by the text:cache settings the first time it's used.
+		/// Shared, since sprites can outlive the service when the engine shuts down.
+		const std::shared_ptr<TextCache>& getTextCache();
+
+		/// The text_mipmap setting, which every text texture upload checks
+		bool getTextMipmap();
+
 	  private:
+		void textThreadFn();
+		void stopTextThreads();
+
+		ds::ui::SpriteEngine&					 mEngine;
 		PangoFontMap*							 mFontMap;
 		std::map<std::string, DsPangoFontFamily> mLoadedFamilies;
 		std::map<std::string, DsPangoFontFace>	 mLoadedFonts;
+
+		std::vector<std::thread>					   mTextThreads;
+		std::mutex									   mTextMutex;
+		std::condition_variable						   mTextCondition;
+		std::deque<std::function<void(PangoContext*)>> mTextWork;
+		bool										   mTextQuit;
+
+		std::shared_ptr<TextCache> mTextCache;
+		ds::cfg::Settings::Handle  mTextMipmap;
 	};
 
 }} // namespace ds::ui
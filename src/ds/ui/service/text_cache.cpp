@@ -0,0 +1,124 @@
+#include "stdafx.h"
+
+#include "ds/ui/service/text_cache.h"
+
+#include "ds/debug/logger.h"
+
+namespace ds::ui {
+
+/**
+ * \class TextCache
+ */
+TextCache::TextCache()
+  : mMaxBytes(0)
+  , mMaxEntries(0) {}
+
+void TextCache::setLimits(const size_t maxBytes, const size_t maxEntries) {
+	mMaxBytes	= maxBytes;
+	mMaxEntries = maxEntries;
+	evict();
+}
+
+bool TextCache::acquire(const std::string& key, ci::gl::TextureRef& texture, TextLayoutMetrics& metrics) {
+	if (!getEnabled()) return false;
+
+	auto found = mIndex.find(key);
+	if (found == mIndex.end()) {
+		++mStats.mMisses;
+		return false;
+	}
+
+	auto it = found->second;
+	mEntries.splice(mEntries.begin(), mEntries, it);
+	if (it->mRefs++ == 0) ++mStats.mEntriesInUse;
+	++mStats.mHits;
+
+	texture = it->mTexture;
+	metrics = it->mMetrics;
+	return true;
+}
+
+ci::gl::TextureRef TextCache::insert(const std::string& key, const ci::gl::TextureRef& texture,
+									 const TextLayoutMetrics& metrics) {
+	if (!getEnabled() || !texture) return texture;
+
+	auto found = mIndex.find(key);
+	if (found != mIndex.end()) {
+		auto it = found->second;
+		mEntries.splice(mEntries.begin(), mEntries, it);
+		if (it->mRefs++ == 0) ++mStats.mEntriesInUse;
+		return it->mTexture;
+	}
+
+	const size_t pixelBytes = texture->getInternalFormat() == GL_RED ? 1 : 4;
+
+	Entry entry;
+	entry.mKey	   = key;
+	entry.mTexture = texture;
+	entry.mMetrics = metrics;
+	entry.mBytes   = static_cast<size_t>(texture->getWidth() * texture->getHeight()) * pixelBytes;
+	entry.mRefs	   = 1;
+
+	mEntries.push_front(entry);
+	mIndex[key] = mEntries.begin();
+	++mStats.mEntries;
+	++mStats.mEntriesInUse;
+	mStats.mBytes += entry.mBytes;
+
+	evict();
+	return texture;
+}
+
+void TextCache::release(const std::string& key) {
+	if (key.empty()) return;
+
+	auto found = mIndex.find(key);
+	if (found == mIndex.end()) return;
+
+	auto it = found->second;
+	if (it->mRefs > 0 && --it->mRefs == 0) {
+		--mStats.mEntriesInUse;
+		evict();
+	}
+}
+
+void TextCache::clear() {
+	for (auto it = mEntries.begin(); it != mEntries.end();) {
+		if (it->mRefs > 0) {
+			++it;
+			continue;
+		}
+
+		mStats.mBytes -= it->mBytes;
+		--mStats.mEntries;
+		mIndex.erase(it->mKey);
+		it = mEntries.erase(it);
+	}
+}
+
+void TextCache::evict() {
+	// Walk back from the least recently used, skipping whatever's still on screen
+	auto it = mEntries.end();
+	while ((mStats.mBytes > mMaxBytes || mStats.mEntries > mMaxEntries) && it != mEntries.begin()) {
+		--it;
+		if (it->mRefs > 0) continue;
+
+		mStats.mBytes -= it->mBytes;
+		--mStats.mEntries;
+		++mStats.mEvictions;
+		mIndex.erase(it->mKey);
+		it = mEntries.erase(it);
+	}
+}
+
+TextCache::Stats TextCache::getStats() const {
+	return mStats;
+}
+
+void TextCache::logStats() const {
+	DS_LOG_INFO("Text cache: " << mStats.mEntries << " entries (" << mStats.mEntriesInUse << " in use), "
+							   << mStats.mBytes / 1024 << "kb of " << mMaxBytes / 1024 << "kb, " << mStats.mHits
+							   << " hits, " << mStats.mMisses << " misses, " << mStats.mEvictions << " evictions");
+}
+
+} // namespace ds::ui
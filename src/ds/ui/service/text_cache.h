@@ -0,0 +1,119 @@
+#pragma once
+#ifndef DS_UI_SERVICE_TEXT_CACHE_H_
+#define DS_UI_SERVICE_TEXT_CACHE_H_
+
+#include <cstdint>
+#include <list>
+#include <string>
+#include <unordered_map>
+
+#include <cinder/gl/Texture.h>
+
+namespace ds::ui {
+
+/**
+ * \struct TextLayoutMetrics
+ * \brief Where a laid out Text goes and how big it is, so a rendered text can be used without laying it out again.
+ */
+struct TextLayoutMetrics {
+	TextLayoutMetrics()
+	  : mWrapped(false)
+	  , mNumberOfLines(0)
+	  , mPixelOffsetX(0)
+	  , mPixelOffsetY(0)
+	  , mRenderOffset(0.0f, 0.0f)
+	  , mPixelWidth(0)
+	  , mPixelHeight(0)
+	  , mExtentX(0)
+	  , mExtentWidth(0)
+	  , mExtentHeight(0)
+	  , mWidth(0.0f)
+	  , mHeight(0.0f) {}
+
+	bool	 mWrapped;
+	int		 mNumberOfLines;
+	int		 mPixelOffsetX;
+	int		 mPixelOffsetY;
+	ci::vec2 mRenderOffset;
+	int		 mPixelWidth;
+	int		 mPixelHeight;
+	int		 mExtentX;
+	int		 mExtentWidth;
+	int		 mExtentHeight;
+	/// The size of the drawn text, without any white space if it's trimmed
+	float mWidth;
+	float mHeight;
+};
+
+/**
+ * \class TextCache
+ * \brief Rendered text shared between Text sprites. Sprites showing the same text in the same style share one
+ * texture, and text nobody shows anymore stays around for a while, so a recycled list item gets its caption back
+ * without laying it out or rendering it again.
+ * Entries are keyed by everything that goes into the layout and the pixels, and counted by the sprites using them.
+ * Once the cache is over its size or count, unused entries are evicted, least recently used first. Main thread only.
+ */
+class TextCache {
+  public:
+	struct Stats {
+		Stats()
+		  : mEntries(0)
+		  , mEntriesInUse(0)
+		  , mBytes(0)
+		  , mHits(0)
+		  , mMisses(0)
+		  , mEvictions(0) {}
+
+		size_t	 mEntries;
+		size_t	 mEntriesInUse;
+		size_t	 mBytes;
+		uint64_t mHits;
+		uint64_t mMisses;
+		uint64_t mEvictions;
+	};
+
+	TextCache();
+
+	/// A maxBytes or maxEntries of 0 turns the cache off. Evicts down to the new limits.
+	void setLimits(const size_t maxBytes, const size_t maxEntries);
+	bool getEnabled() const { return mMaxBytes > 0 && mMaxEntries > 0; }
+
+	/// If key is cached, adds a reference to it and answers true with its texture and metrics
+	bool acquire(const std::string& key, ci::gl::TextureRef& texture, TextLayoutMetrics& metrics);
+	/// Caches a rendered text under key with one reference, and answers the texture to use. If someone else
+	/// already cached key, their texture is referenced and answered instead.
+	ci::gl::TextureRef insert(const std::string& key, const ci::gl::TextureRef& texture,
+							  const TextLayoutMetrics& metrics);
+	/// Drops a reference from acquire() or insert()
+	void release(const std::string& key);
+
+	/// Drops every entry nobody's using
+	void clear();
+
+	Stats getStats() const;
+	void  logStats() const;
+
+  private:
+	struct Entry {
+		std::string		   mKey;
+		ci::gl::TextureRef mTexture;
+		TextLayoutMetrics  mMetrics;
+		size_t			   mBytes;
+		int				   mRefs;
+	};
+
+	typedef std::list<Entry> EntryList;
+
+	void evict();
+
+	/// Most recently used first
+	EntryList											 mEntries;
+	std::unordered_map<std::string, EntryList::iterator> mIndex;
+	size_t												 mMaxBytes;
+	size_t												 mMaxEntries;
+	Stats												 mStats;
+};
+
+} // namespace ds::ui
+
+#endif // DS_UI_SERVICE_TEXT_CACHE_H_
@@ -11,6 +11,7 @@
 #include "ds/app/blob_reader.h"
 #include "ds/app/blob_registry.h"
 #include "ds/app/camera_utils.h"
+#include "ds/app/engine/engine_replication.h"
 #include "ds/app/environment.h"
 #include "ds/data/data_buffer.h"
 #include "ds/debug/debug_defines.h"
@@ -24,6 +25,7 @@
 #include "ds/util/string_util.h"
 #include "util/clip_plane.h"
 
+#include <cstring>
 #include <numeric>
 
 // #include <glm/gtx/rotate_vector.hpp>
@@ -168,6 +170,9 @@ void Sprite::init(const ds::sprite_id_t id) {
 	mReveal				  = 1.0f;
 	mMultiTouchEnabled	  = false;
 	mCheckBounds		  = false;
+	mWantsUpdates		  = false;
+	mNeedsUpdate		  = false;
+	mActiveChildren		  = 0;
 	mBoundsNeedChecking	  = true;
 	mInBounds			  = true;
 	mDragDestination	  = nullptr;
@@ -184,6 +189,9 @@ void Sprite::init(const ds::sprite_id_t id) {
 	mNeedsBatchUpdate	  = false;
 	mDoSpecialRotation	  = false;
 	mDegree				  = 0.0f;
+	mPickBounded		  = false;
+	mPickBoundsDirty	  = true;
+	mSortedDirty		  = true;
 
 	mLayoutBPad		= 0.0f;
 	mLayoutTPad		= 0.0f;
@@ -244,20 +252,25 @@ Sprite::~Sprite() {
 }
 
 void Sprite::updateClient(const UpdateParams& updateParams) {
+	mEngine.spriteUpdated();
 	mIdleTimer.update();
 
 	if (mCheckBounds) {
 		updateCheckBounds();
 	}
 
+	const bool skipIdle = mEngine.getSkipIdleUpdates();
 	for (auto it = mChildren.begin(), it2 = mChildren.end(); it != it2; ++it) {
-		(*it)->updateClient(updateParams);
+		if (!skipIdle || (*it)->isUpdateActive()) (*it)->updateClient(updateParams);
 	}
 
 	onUpdateClient(updateParams);
+	// The idle timer might have run out
+	checkUpdateActive();
 }
 
 void Sprite::updateServer(const UpdateParams& updateParams) {
+	mEngine.spriteUpdated();
 	mTouchProcess.update(updateParams);
 
 	mIdleTimer.update();
@@ -266,11 +279,35 @@ void Sprite::updateServer(const UpdateParams& updateParams) {
 		updateCheckBounds();
 	}
 
+	const bool skipIdle = mEngine.getSkipIdleUpdates();
 	for (auto it = mChildren.begin(), it2 = mChildren.end(); it != it2; ++it) {
-		(*it)->updateServer(updateParams);
+		if (!skipIdle || (*it)->isUpdateActive()) (*it)->updateServer(updateParams);
 	}
 
 	onUpdateServer(updateParams);
+	// The idle timer might have run out, or a pending tap been sent
+	checkUpdateActive();
+}
+
+void Sprite::setWantsUpdates(const bool wantsUpdates) {
+	mWantsUpdates = wantsUpdates;
+	checkUpdateActive();
+}
+
+void Sprite::checkUpdateActive() {
+	const bool needsUpdate =
+		mWantsUpdates || mCheckBounds || mIdleTimer.isCounting() || mTouchProcess.hasPendingTap();
+	if (needsUpdate == mNeedsUpdate) return;
+
+	const bool wasActive = isUpdateActive();
+	mNeedsUpdate		 = needsUpdate;
+	if (mParent && wasActive != isUpdateActive()) mParent->childUpdateActiveChanged(!wasActive);
+}
+
+void Sprite::childUpdateActiveChanged(const bool active) {
+	const bool wasActive = isUpdateActive();
+	mActiveChildren += (active ? 1 : -1);
+	if (mParent && wasActive != isUpdateActive()) mParent->childUpdateActiveChanged(!wasActive);
 }
 
 void Sprite::drawLocalClientInternal(const ci::mat4& totalTransformation, const DrawParams& drawParams) {
@@ -556,6 +593,7 @@ bool Sprite::getInnerHit(const ci::vec3& p) const {
 void Sprite::doSetPosition(const ci::vec3& pos) {
 	if (mPosition == pos) return;
 
+	if (mPosition.z != pos.z) markParentSortDirty();
 	mPosition			= pos;
 	mUpdateTransform	= true;
 	mBoundsNeedChecking = true;
@@ -752,6 +790,7 @@ void Sprite::addChild(Sprite& child) {
 	}
 
 	mChildren.push_back(&child);
+	mSortedDirty = true;
 	/*
 	//check if the node has a parent. ds_cinder allows moving a child with a parent
 	//but yoga does not. so we have to clear the parent first.
@@ -767,6 +806,8 @@ void Sprite::addChild(Sprite& child) {
 	child.setPerspective(mPerspective);
 	child.setDrawSorted(getDrawSorted());
 	child.setUseDepthBuffer(mUseDepthBuffer);
+	markPickBoundsDirty();
+	if (child.isUpdateActive()) childUpdateActiveChanged(true);
 
 	onChildAdded(child);
 }
@@ -777,8 +818,13 @@ void Sprite::removeChild(Sprite& child) {
 	onChildRemoved(child);
 
 	const auto found = std::find(mChildren.begin(), mChildren.end(), &child);
-	if (found != mChildren.end()) mChildren.erase(found);
+	if (found != mChildren.end()) {
+		mChildren.erase(found);
+		if (child.isUpdateActive()) childUpdateActiveChanged(false);
+	}
+	mSortedDirty = true;
 	YGNodeRemoveChild(mYogaNode, child.mYogaNode);
+	markPickBoundsDirty();
 	if (child.getParent() == this) {
 		child.setParent(nullptr);
 		child.setPerspective(false);
@@ -828,6 +874,11 @@ void Sprite::clearChildren() {
 	if (mChildren.empty()) return;
 	const auto tempList = mChildren;
 	mChildren.clear();
+	mSortedDirty = true;
+	if (mActiveChildren > 0) {
+		mActiveChildren = 0;
+		if (mParent && !isUpdateActive()) mParent->childUpdateActiveChanged(false);
+	}
 
 	for (const auto it : tempList) {
 		it->release();
@@ -1129,6 +1180,58 @@ Sprite* Sprite::getHit(const ci::vec3& point) {
 	return nullptr;
 }
 
+Sprite* Sprite::getIndexedHit(const ci::vec3& point) {
+	if (!isPickPlanar()) return getHit(point);
+
+	updatePickBounds();
+	const ci::vec3 local = globalToLocal(point);
+	if (mPickBounded && !pickBoundsContain(ci::vec2(local))) return nullptr;
+	return getIndexedHit(point, ci::vec2(local));
+}
+
+Sprite* Sprite::getIndexedHit(const ci::vec3& point, const ci::vec2& localPoint) {
+	// Same rules and order as getHit(), except a planar child is skipped outright if the point is outside its bounds
+	if (!visible()) {
+		return nullptr;
+	}
+	if (mScale.x == 0.0f || mScale.y == 0.0f) {
+		return nullptr;
+	}
+	if (getClipping()) {
+		if (!contains(point)) return nullptr;
+	}
+
+	const bool sorted = getFlag(DRAW_SORTED_F, mSpriteFlags);
+	if (sorted) makeSortedChildren();
+	const std::vector<Sprite*>& children = sorted ? mSortedTmp : mChildren;
+
+	auto selfHit = [&point](Sprite* s) {
+		return s->visible() && s->isEnabled() && s->contains(point) && s->getInnerHit(point);
+	};
+	for (auto it = children.rbegin(), it2 = children.rend(); it != it2; ++it) {
+		Sprite* child = *it;
+
+		const bool planar = child->isPickPlanar();
+		ci::vec2   childPoint;
+		if (planar) {
+			child->updatePickBounds();
+			child->buildTransform();
+			const ci::vec4 p = child->mInverseTransform * ci::vec4(localPoint.x, localPoint.y, 0.0f, 1.0f);
+			childPoint		 = ci::vec2(p.x, p.y);
+			if (child->mPickBounded && !child->pickBoundsContain(childPoint)) continue;
+		}
+
+		if (sorted && selfHit(child)) return child;
+		Sprite* hitChild = planar ? child->getIndexedHit(point, childPoint) : child->getHit(point);
+		if (hitChild) return hitChild;
+		if (!sorted && selfHit(child)) return child;
+	}
+
+	if (isEnabled() && contains(point) && getInnerHit(point)) return this;
+
+	return nullptr;
+}
+
 Sprite* Sprite::getPerspectiveHit(CameraPick& pick) {
 	if (!visible()) return nullptr;
 
@@ -1171,9 +1274,11 @@ void Sprite::setProcessTouchCallback(const std::function<void(Sprite*, const Tou
 
 void Sprite::processTouchInfo(const TouchInfo& touchInfo) {
 	mTouchProcess.processTouchInfo(touchInfo);
+	checkUpdateActive();
 }
 
 void Sprite::move(const ci::vec3& delta) {
+	if (delta.z != 0.0f) markParentSortDirty();
 	mPosition += delta;
 	mUpdateTransform	= true;
 	mBoundsNeedChecking = true;
@@ -1185,6 +1290,7 @@ void Sprite::move(const ci::vec3& delta) {
 }
 
 void Sprite::move(float deltaX, float deltaY, float deltaZ) {
+	if (deltaZ != 0.0f) markParentSortDirty();
 	mPosition += ci::vec3(deltaX, deltaY, deltaZ);
 	mUpdateTransform	= true;
 	mBoundsNeedChecking = true;
@@ -1297,6 +1403,7 @@ void Sprite::setTapCallback(const std::function<void(Sprite*, const ci::vec3&)>&
 
 void Sprite::setDoubleTapCallback(const std::function<void(Sprite*, const ci::vec3&)>& func) {
 	mDoubleTapCallback = func;
+	checkUpdateActive();
 }
 
 void Sprite::enableMultiTouch(const BitMask& constraints) {
@@ -1431,6 +1538,7 @@ void Sprite::setCheckBounds(bool checkBounds) {
 	mInBounds			= !mCheckBounds;
 	mBoundsNeedChecking = checkBounds;
 	markAsDirty(CHECKBOUNDS_DIRTY);
+	checkUpdateActive();
 }
 
 bool Sprite::getCheckBounds() const {
@@ -1483,12 +1591,20 @@ bool Sprite::isDirty() const {
 }
 
 void Sprite::writeTo(ds::DataBuffer& buf) {
-	if ((mSpriteFlags & NO_REPLICATION_F) != 0) return;
-	if (mDirty.isEmpty()) return;
+	if (!writeSelfTo(buf)) return;
+
+	for (auto it = mChildren.begin(), end = mChildren.end(); it != end; ++it) {
+		(*it)->writeTo(buf);
+	}
+}
+
+bool Sprite::writeSelfTo(ds::DataBuffer& buf) {
+	if ((mSpriteFlags & NO_REPLICATION_F) != 0) return false;
+	if (mDirty.isEmpty()) return false;
 	if (mId == ds::EMPTY_SPRITE_ID) {
 		// This shouldn't be possible
 		DS_LOG_WARNING_M("Sprite::writeTo() on empty sprite ID", SPRITE_LOG);
-		return;
+		return false;
 	}
 
 	buf.add(mBlobType);
@@ -1500,9 +1616,35 @@ void Sprite::writeTo(ds::DataBuffer& buf) {
 	buf.add(ds::TERMINATOR_CHAR);
 	// If I wrote any attributes then make sure to terminate the block
 	mDirty.clear();
+	return true;
+}
+
+void Sprite::writeDeltaTo(ds::DataBuffer& buf, ds::EngineReplicationHistory& history, const bool keyframe) {
+	if ((mSpriteFlags & NO_REPLICATION_F) != 0) return;
+	const DirtyState pending = history.getPending(mId);
+	if (!keyframe && mDirty.isEmpty() && pending.isEmpty()) return;
+	if (mId == ds::EMPTY_SPRITE_ID) {
+		DS_LOG_WARNING_M("Sprite::writeDeltaTo() on empty sprite ID", SPRITE_LOG);
+		return;
+	}
+
+	history.record(mId, mDirty);
+	if (keyframe) {
+		mDirty.fill();
+	} else {
+		mDirty |= pending;
+	}
+
+	buf.add(mBlobType);
+	buf.add(SPRITE_ID_ATTRIBUTE);
+	buf.add(mId);
+
+	writeAttributesTo(buf);
+	buf.add(ds::TERMINATOR_CHAR);
+	mDirty.clear();
 
 	for (auto it = mChildren.begin(), end = mChildren.end(); it != end; ++it) {
-		(*it)->writeTo(buf);
+		(*it)->writeDeltaTo(buf, history, keyframe);
 	}
 }
 
@@ -1637,7 +1779,9 @@ void Sprite::readAttributesFrom(ds::DataBuffer& buf) {
 		} else if (id == POSITION_ATT) {
 			mPosition.x		 = buf.read<float>();
 			mPosition.y		 = buf.read<float>();
-			mPosition.z		 = buf.read<float>();
+			const float z	 = buf.read<float>();
+			if (mPosition.z != z) markParentSortDirty();
+			mPosition.z		 = z;
 			transformChanged = true;
 		} else if (id == CHECKBOUNDS_ATT) {
 			const bool checkBounds = buf.read<bool>();
@@ -1694,6 +1838,48 @@ void Sprite::readAttributesFrom(ds::DataBuffer& buf) {
 	}
 }
 
+int Sprite::getAttributeValueSize(const char id, const char* data, const size_t available) {
+	size_t size = 0;
+	if (id == PARENT_ATT) {
+		size = sizeof(sprite_id_t);
+	} else if (id == SIZE_ATT || id == POSITION_ATT || id == CENTER_ATT || id == SCALE_ATT || id == COLOR_ATT ||
+			   id == ROTATION_ATT) {
+		size = 3 * sizeof(float);
+	} else if (id == OPACITY_ATT || id == CORNERRADIUS_ATT) {
+		size = sizeof(float);
+	} else if (id == BLEND_ATT) {
+		size = sizeof(BlendMode);
+	} else if (id == CLIP_BOUNDS_ATT) {
+		size = 4 * sizeof(float);
+	} else if (id == CHECKBOUNDS_ATT) {
+		size = sizeof(bool);
+	} else if (id == FLAGS_ATT) {
+		// The flags, then the shader location and name, each prefixed with its length
+		size = sizeof(int);
+		for (int k = 0; k < 2; ++k) {
+			unsigned length = 0;
+			if (available < size + sizeof(length)) return -1;
+			std::memcpy(&length, data + size, sizeof(length));
+			size += sizeof(length) + length;
+		}
+	} else if (id == SORTORDER_ATT) {
+		int32_t count = 0;
+		if (available < sizeof(count)) return -1;
+		std::memcpy(&count, data, sizeof(count));
+		if (count < 0) return -1;
+		size = sizeof(count) + static_cast<size_t>(count) * sizeof(sprite_id_t);
+	} else {
+		return -1;
+	}
+
+	if (size > available) return -1;
+	return static_cast<int>(size);
+}
+
+bool Sprite::isHierarchyAttribute(const char id) {
+	return id == PARENT_ATT || id == SORTORDER_ATT;
+}
+
 void Sprite::setSpriteId(const ds::sprite_id_t& id) {
 	if (mId == id) return;
 
@@ -1956,6 +2142,7 @@ void Sprite::computeClippingBounds(ds::ui::Sprite* clippingParent) {
 
 void Sprite::dimensionalStateChanged() {
 	markClippingDirty();
+	markPickBoundsDirty();
 	if (mLastWidth != mWidth || mLastHeight != mHeight || mLastDepth != mDepth) {
 		mLastWidth	= mWidth;
 		mLastHeight = mHeight;
@@ -1966,6 +2153,55 @@ void Sprite::dimensionalStateChanged() {
 	setupFinalRenderBuffer();
 }
 
+void Sprite::markPickBoundsDirty() {
+	for (Sprite* s = this; s && !s->mPickBoundsDirty; s = s->mParent) {
+		s->mPickBoundsDirty = true;
+	}
+}
+
+void Sprite::updatePickBounds() {
+	if (!mPickBoundsDirty) return;
+	mPickBoundsDirty = false;
+
+	mPickBounds = ci::Rectf(0.0f, 0.0f, mWidth, mHeight);
+	mPickBounds.canonicalize();
+	// A sprite that picks outside its own rectangle can't be bounded by it, and neither can anything holding it
+	mPickBounded = hasPickBounds();
+	for (auto it = mChildren.begin(), end = mChildren.end(); it != end; ++it) {
+		Sprite* child = *it;
+
+		// Clean every child, even the ones that can't be bounded, or a later change under one of them would stop at
+		// its stale dirty flag and never reach me
+		child->updatePickBounds();
+		if (!child->isPickPlanar() || !child->mPickBounded) {
+			mPickBounded = false;
+			continue;
+		}
+
+		child->buildTransform();
+		const ci::Rectf& b			= child->mPickBounds;
+		const ci::vec2	 corners[4] = {b.getUpperLeft(), b.getUpperRight(), b.getLowerRight(), b.getLowerLeft()};
+		for (int k = 0; k < 4; ++k) {
+			const ci::vec4 p = child->mTransformation * ci::vec4(corners[k].x, corners[k].y, 0.0f, 1.0f);
+			mPickBounds.include(ci::vec2(p.x, p.y));
+		}
+	}
+}
+
+bool Sprite::isPickPlanar() const {
+	if (!hasPickBounds() || mDoSpecialRotation) return false;
+	if (mRotation.x != 0.0f || mRotation.y != 0.0f) return false;
+	// The inverse transform is garbage with a scale of zero
+	return mScale.x != 0.0f && mScale.y != 0.0f && mScale.z != 0.0f;
+}
+
+bool Sprite::pickBoundsContain(const ci::vec2& localPoint) const {
+	// contains() does its own math, so leave some slack for rounding
+	const float pad = 0.001f * (mPickBounds.getWidth() + mPickBounds.getHeight()) + 0.001f;
+	return localPoint.x >= mPickBounds.x1 - pad && localPoint.x <= mPickBounds.x2 + pad &&
+		   localPoint.y >= mPickBounds.y1 - pad && localPoint.y <= mPickBounds.y2 + pad;
+}
+
 void Sprite::markClippingDirty() {
 	mClippingBoundsDirty = true;
 	for (auto it = mChildren.begin(), end = mChildren.end(); it != end; ++it) {
@@ -1975,13 +2211,22 @@ void Sprite::markClippingDirty() {
 }
 
 void Sprite::makeSortedChildren() {
+	if (!mSortedDirty) return;
+
 	mSortedTmp = mChildren;
-	std::sort(mSortedTmp.begin(), mSortedTmp.end(),
-			  [](Sprite* i, Sprite* j) { return i->getPosition().z < j->getPosition().z; });
+	// Stable, so children at the same z keep their child order from one rebuild to the next
+	std::stable_sort(mSortedTmp.begin(), mSortedTmp.end(),
+					 [](Sprite* i, Sprite* j) { return i->getPosition().z < j->getPosition().z; });
+	mSortedDirty = false;
+}
+
+void Sprite::markParentSortDirty() {
+	if (mParent) mParent->mSortedDirty = true;
 }
 
 void Sprite::setSecondBeforeIdle(const double idleTime) {
 	mIdleTimer.setSecondBeforeIdle(idleTime);
+	checkUpdateActive();
 }
 
 double Sprite::secondsToIdle() const {
@@ -1994,14 +2239,17 @@ bool Sprite::isIdling() const {
 
 void Sprite::startIdling() {
 	mIdleTimer.startIdling();
+	checkUpdateActive();
 }
 
 void Sprite::resetIdleTimer() {
 	mIdleTimer.resetIdleTimer();
+	checkUpdateActive();
 }
 
 void Sprite::clearIdleTimer() {
 	mIdleTimer.clear();
+	checkUpdateActive();
 }
 
 void Sprite::setNoReplicationOptimization(const bool on) {
@@ -2043,6 +2291,7 @@ void Sprite::sendSpriteToFront(Sprite& sprite) {
 
 	mChildren.erase(found);
 	mChildren.push_back(&sprite);
+	mSortedDirty = true;
 
 	markAsDirty(SORTORDER_DIRTY);
 
@@ -2056,6 +2305,7 @@ void Sprite::sendSpriteToBack(Sprite& sprite) {
 
 	mChildren.erase(found);
 	mChildren.insert(mChildren.begin(), &sprite);
+	mSortedDirty = true;
 
 	markAsDirty(SORTORDER_DIRTY);
 
@@ -2103,6 +2353,7 @@ void Sprite::setSpriteOrder(const std::vector<sprite_id_t>& order) {
 			Sprite* s(*found);
 			mChildren.erase(found);
 			mChildren.push_back(s);
+			mSortedDirty = true;
 		}
 	}
 
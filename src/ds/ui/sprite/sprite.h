@@ -41,6 +41,7 @@ class BlobRegistry;
 class CameraPick;
 class DrawParams;
 class Engine;
+class EngineReplicationHistory;
 class EngineRoot;
 class Event;
 class UpdateParams;
@@ -133,6 +134,15 @@ namespace ui {
 		that function \param updateParams UpdateParams containing some conveniences such as delta time.		*/
 		virtual void onUpdateServer(const ds::UpdateParams& updateParams) {}
 
+		/** With the engine's update:skip_idle_sprites setting on, updateServer() and updateClient() skip any branch
+			that doesn't contain a sprite that needs updates. Sprites that do work in onUpdateServer() or
+			onUpdateClient() should turn this on while they need it. Checking bounds, a running idle timer and a
+			pending double tap keep a sprite updating on their own.		*/
+		void setWantsUpdates(const bool wantsUpdates);
+		bool getWantsUpdates() const { return mWantsUpdates; }
+		/// If I or anything below me needs updateServer() / updateClient() called
+		bool isUpdateActive() const { return mNeedsUpdate || mActiveChildren > 0; }
+
 		/** Draw function for when this app is set to be a client.
 			In most cases, you'll want to override drawLocalClient() to do custom drawing, as this function handles
 		   drawing for children as well. \param transformMatrix The transform matrix of the parent. \param drawParams
@@ -625,6 +635,13 @@ namespace ui {
 		   there was no valid pick.*/
 		virtual Sprite* getHit(const ci::vec3& point);
 
+		/** Same pick as getHit(), but skips any branch whose bounds don't contain the point. The bounds of every
+		   branch are cached and only rebuilt along branches that moved, resized or changed children since the last
+		   pick. Branches rotated out of the screen plane, and sprites that answer false from hasPickBounds(), are
+		   picked with getHit(). Call this on a root, which is what roots built with RootList::pickIndexed() do.
+		   \param point The global point to check. */
+		Sprite* getIndexedHit(const ci::vec3& point);
+
 		/** Recursively checks the Sprite hierarchy list for an enabled, visible sprite with a scale > 0.0 and any size
 		   for touch picking. This is for Perspective Sprites. Ortho Sprites use getHit() \param pick Some parameters
 		   for perspective picking. \return The Sprite that is the best candidate for touch picking. Can return nullptr
@@ -721,6 +738,11 @@ namespace ui {
 			This is if any properties have been modified since the last frame. */
 		bool isDirty() const;
 		void writeTo(ds::DataBuffer&);
+		/// Write only my own blob, not my children. Answers false if none of my children have anything to write.
+		bool writeSelfTo(ds::DataBuffer&);
+		/// Delta replication: write my dirty attributes plus anything sent since the history's baseline frame.
+		/// A keyframe writes every attribute of the whole tree, but only records the real changes.
+		void writeDeltaTo(ds::DataBuffer&, ds::EngineReplicationHistory&, const bool keyframe);
 		void readFrom(ds::BlobReader&);
 		/// Only used when running in client mode
 		void writeClientTo(ds::DataBuffer&);
@@ -903,6 +925,9 @@ namespace ui {
 		/// stage that allows the sprite itself to determine if the point is interior,
 		/// in the case that the sprite has transparency or other special rules.
 		virtual bool getInnerHit(const ci::vec3&) const;
+		/// Sprites that override getHit() or contains() to pick outside their own rectangle answer false,
+		/// so getIndexedHit() never skips them.
+		virtual bool hasPickBounds() const { return true; }
 
 		virtual void doSetPosition(const ci::vec3&);
 		virtual void doSetScale(const ci::vec3&);
@@ -1013,9 +1038,17 @@ namespace ui {
 
 		Sprite*				 mParent;
 		std::vector<Sprite*> mChildren;
-		/// A cache for when I need to sort my children. This could be
-		/// a lot more efficient, only running the sort when Z changes.
+		/// My children sorted by z, rebuilt only when a child is added, removed,
+		/// reordered or changes z.
 		std::vector<Sprite*> mSortedTmp;
+		bool				 mSortedDirty;
+
+		/// Everything I and my children can be picked in, in my local space.
+		/// Only meaningful if mPickBounded, which it isn't if I answer false from hasPickBounds(), or if any of my
+		/// children aren't planar or aren't bounded themselves.
+		ci::Rectf mPickBounds;
+		bool	  mPickBounded;
+		bool	  mPickBoundsDirty;
 
 		/// Class-unique key for this type.  Subclasses can replace.
 		char	   mBlobType;
@@ -1043,6 +1076,11 @@ namespace ui {
 		bool	  mCheckBounds;
 		Sprite*	  mDragDestination;
 		IdleTimer mIdleTimer;
+		bool	  mWantsUpdates;
+		/// I need updates myself, for any reason
+		bool mNeedsUpdate;
+		/// How many of my children have a branch that needs updates
+		int mActiveChildren;
 		bool	  mUseDepthBuffer;
 		float	  mCornerRadius;
 		/// For clients that do their own drawing -- this is the current parent * me opacity.
@@ -1072,9 +1110,21 @@ namespace ui {
 		void dimensionalStateChanged();
 		/// Applies to all children, too.
 		void markClippingDirty();
-		/// Store all children in mSortedTmp by z order.
-		/// XXX Need to optimize this so only built when needed.
+		/// Applies to all parents, too.
+		void markPickBoundsDirty();
+		/// Rebuild mPickBounds, and those of any children that need it
+		void updatePickBounds();
+		/// If my transform keeps me in my parent's plane, a 2D point in my parent can be carried into my local space
+		bool	isPickPlanar() const;
+		bool	pickBoundsContain(const ci::vec2& localPoint) const;
+		Sprite* getIndexedHit(const ci::vec3& point, const ci::vec2& localPoint);
+		/// Store all children in mSortedTmp by z order, if they might have changed since the last time.
 		void makeSortedChildren();
+		/// My z changed, so my parent's sorted children are out of date.
+		void markParentSortDirty();
+		/// Work out whether I need updates, and tell my parent if that changed whether my branch does.
+		void checkUpdateActive();
+		void childUpdateActiveChanged(const bool active);
 		/// calls removeParent then addChild to parent.
 		/// setParent was previously public, but calling it by itself can cause an infinite loop
 		/// Use addChild() from outside sprite.cpp
@@ -1121,6 +1171,13 @@ namespace ui {
 		static void installAsServer(ds::BlobRegistry&);
 		static void installAsClient(ds::BlobRegistry&);
 
+		/// Used to merge queued frames on a client that fell behind. The size in bytes of the value that
+		/// follows attribute id in a sprite blob, or -1 if id isn't a base Sprite attribute or the value
+		/// doesn't fit in available. Subclass attributes are opaque, since only the subclass can read them.
+		static int getAttributeValueSize(const char id, const char* data, const size_t available);
+		/// Attributes that refer to other sprites by id, so they can't be applied any earlier than they were sent.
+		static bool isHierarchyAttribute(const char id);
+
 		template <typename T>
 		static void handleBlobFromServer(ds::BlobReader&);
 		static void handleBlobFromClient(ds::BlobReader&);
@@ -18,6 +18,9 @@ SpriteEngine::SpriteEngine(ds::EngineData& ed, const int appMode)
   , mRegisteredEntryField(nullptr)
   , mAppMode(appMode)
   , mRestartAfterUpdate(false)
+  , mSkipIdleUpdates(false)
+  , mSpritesUpdating(0)
+  , mSpritesUpdated(0)
   , mCallbackId(0) {
 	mComputerInfo = new ds::ComputerInfo();
 }
@@ -214,9 +214,23 @@ class SpriteEngine {
 
 	/// Get the sprite at the global touch point. NOTE: performance intensive. Use carefully.
 	virtual ds::ui::Sprite* getHit(const ci::vec3& point) = 0;
+	/// Every sprite registered with the engine
+	virtual size_t getSpriteCount() const = 0;
 
-	virtual int getBytesRecieved() = 0;
-	virtual int getBytesSent()	   = 0;
+	/// With the update:skip_idle_sprites setting on, sprites only update the branches below them
+	/// that contain a sprite that wants updates. See Sprite::setWantsUpdates()
+	bool getSkipIdleUpdates() const { return mSkipIdleUpdates; }
+	/// Sprites visited by the last update, out of getSpriteCount()
+	int getSpritesUpdated() const { return mSpritesUpdated; }
+	/// Called by each sprite as it updates
+	void spriteUpdated() { ++mSpritesUpdating; }
+
+	virtual int getBytesRecieved()		 = 0;
+	virtual int getBytesSent()			 = 0;
+	/// Average payload bytes the receive path copied per frame since the last call
+	virtual int getBytesCopiedPerFrame() = 0;
+	/// Total frames a client merged into a later frame because it fell behind
+	virtual int getFramesCoalesced()	 = 0;
 
 
 	static const int CLIENT_MODE	   = 0;
@@ -308,6 +322,10 @@ class SpriteEngine {
 
 	bool mRestartAfterUpdate;
 
+	bool mSkipIdleUpdates;
+	int	 mSpritesUpdating;
+	int	 mSpritesUpdated;
+
 	std::unordered_map<std::string, std::function<ds::ui::Sprite*(ds::ui::SpriteEngine&)>> mImporterMap;
 	std::unordered_map<std::string, std::function<void(ds::ui::Sprite& theSprite, const std::string& theValue,
 													   const std::string& fileRefferer)>>
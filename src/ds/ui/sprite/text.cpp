@@ -12,6 +12,7 @@
 #include "fontconfig/fontconfig.h"
 #include "pango/pangocairo.h"
 
+#include <atomic>
 #include <pango/pango-font.h>
 #include <regex>
 
@@ -122,8 +123,105 @@ namespace {
 	const char FONTNAME_ATT = 80;
 	const char TEXT_ATT		= 81;
 	const char LAYOUT_ATT	= 82;
+
+	void set_font_options(PangoContext* context, cairo_font_options_t* options) {
+		// TODO, expose these?
+		cairo_font_options_set_antialias(options, CAIRO_ANTIALIAS_SUBPIXEL);
+		cairo_font_options_set_hint_style(options, CAIRO_HINT_STYLE_DEFAULT);
+		cairo_font_options_set_hint_metrics(options, CAIRO_HINT_METRICS_ON);
+		cairo_font_options_set_subpixel_order(options, CAIRO_SUBPIXEL_ORDER_BGR);
+
+		pango_cairo_context_set_font_options(context, options);
+	}
 } // namespace
 
+struct Text::LayoutOptions {
+	LayoutOptions()
+	  : mMarkup(false)
+	  , mHadMarkup(false)
+	  , mFontSize(0.0)
+	  , mResizeLimitWidth(-1.0f)
+	  , mResizeLimitHeight(-1.0f)
+	  , mAlignment(Alignment::kLeft)
+	  , mWrapMode(WrapMode::kWrapModeWordChar)
+	  , mEllipsizeMode(EllipsizeMode::kEllipsizeNone)
+	  , mSpacing(0)
+	  , mLetterSpacing(0.0)
+	  , mTrimWhiteSpace(false)
+	  , mPreserveSpanColors(false) {}
+
+	/// Everything that changes the layout or the pixels. Without span colors the text color is applied when it's drawn.
+	std::string getCacheKey() const {
+		std::string key = mFont;
+		key += "|" + std::to_string(mFontSize) + "|" + std::to_string(mResizeLimitWidth) + "|" +
+			   std::to_string(mResizeLimitHeight) + "|" + std::to_string((int)mAlignment) + "|" +
+			   std::to_string((int)mWrapMode) + "|" + std::to_string((int)mEllipsizeMode) + "|" +
+			   std::to_string(mSpacing) + "|" + std::to_string(mLetterSpacing) + "|" + (mTrimWhiteSpace ? "t" : "f") +
+			   (mMarkup ? "m" : "p");
+		if (mPreserveSpanColors) {
+			key += "|" + std::to_string(mColor.r) + "," + std::to_string(mColor.g) + "," + std::to_string(mColor.b);
+		}
+		key += "|" + mText;
+		return key;
+	}
+
+	std::string		mText;
+	bool			mMarkup;
+	bool			mHadMarkup;
+	std::string		mFont;
+	double			mFontSize;
+	float			mResizeLimitWidth;
+	float			mResizeLimitHeight;
+	Alignment::Enum mAlignment;
+	WrapMode		mWrapMode;
+	EllipsizeMode	mEllipsizeMode;
+	int				mSpacing;
+	double			mLetterSpacing;
+	bool			mTrimWhiteSpace;
+	ci::Color		mColor;
+	bool			mPreserveSpanColors;
+};
+
+struct Text::AsyncRender {
+	AsyncRender()
+	  : mSurface(nullptr)
+	  , mDone(false)
+	  , mCancelled(false)
+	  , mApplied(false) {}
+
+	~AsyncRender() {
+		if (mSurface) cairo_surface_destroy(mSurface);
+	}
+
+	/// Runs on a text thread
+	void run(PangoContext* context) {
+		if (context && !mCancelled) {
+			cairo_font_options_t* fontOptions = cairo_font_options_create();
+			set_font_options(context, fontOptions);
+			cairo_font_options_destroy(fontOptions);
+
+			PangoLayout* layout = pango_layout_new(context);
+			configureFont(layout, mOptions);
+			configureLayout(layout, mOptions);
+			measureLayout(layout, mOptions, mMetrics);
+			if (!mCancelled && mMetrics.mPixelWidth > 0 && mMetrics.mPixelHeight > 0) {
+				mSurface = rasterizeLayout(layout, mOptions, mMetrics);
+			}
+			g_object_unref(layout);
+		}
+		mDone = true;
+	}
+
+	LayoutOptions	 mOptions;
+	LayoutMetrics	 mMetrics;
+	cairo_surface_t* mSurface;
+	/// Set by the text thread once the metrics and surface are filled in
+	std::atomic<bool> mDone;
+	std::atomic<bool> mCancelled;
+	/// The metrics have sized the sprite, and the surface is waiting for the next render batch
+	bool mApplied;
+};
+
 
 void Text::installAsServer(ds::BlobRegistry& registry) {
 	BLOB_TYPE = registry.add([](BlobReader& r) { Sprite::handleBlobFromClient(r); });
@@ -167,10 +265,15 @@ Text::Text(ds::ui::SpriteEngine& eng)
   , mPixelHeight(-1)
   , mPixelOffsetX(0)
   , mPixelOffsetY(0)
-  , mCairoFontOptions(nullptr) {
+  , mCairoFontOptions(nullptr)
+  , mAsyncRender(false)
+  , mLayoutBehind(false) {
+	setWantsUpdates(true);
 	mBlobType = BLOB_TYPE;
 
 	mEngineFontScale = mEngine.getEngineSettings().getFloat("font_scale", 0, 4.0f / 3.0f);
+	mAsyncRender	 = mEngine.getEngineSettings().getBool("text:async_render", 0, false);
+	mTextCache		 = mEngine.getPangoFontService().getTextCache();
 
 	if (!mEngine.getPangoFontService().getPangoFontMap()) {
 		DS_LOG_WARNING("Cannot create the pango font map, nothing will render for this pango text sprite.");
@@ -208,6 +311,9 @@ Text::Text(ds::ui::SpriteEngine& eng)
 }
 
 Text::~Text() {
+	cancelAsyncRender();
+	releaseCachedText();
+
 	if (mCairoFontOptions) {
 		cairo_font_options_destroy(mCairoFontOptions);
 		mCairoFontOptions = nullptr;
@@ -596,7 +702,9 @@ void Text::onBuildRenderBatch() {
 }
 
 void Text::setFlexboxAutoSizes() {
-	measurePangoText();
+	// Async text reports the size of its last render until the next one is in, and text from the cache already
+	// has its size
+	if (!isAsyncRender() && needsLayout()) measurePangoText();
 	Sprite::setFlexboxAutoSizes();
 }
 
@@ -841,6 +949,17 @@ void Text::setAllowMarkup(const bool allow) {
 	markAsDirty(TEXT_DIRTY);
 }
 
+void Text::setAsyncRender(const bool async) {
+	if (mAsyncRender == async) return;
+
+	mAsyncRender = async;
+	if (!mAsyncRender && mAsyncJob) {
+		// Whatever it was going to render gets rendered here instead
+		cancelAsyncRender();
+		mNeedsTextRender = true;
+	}
+}
+
 void Text::setPreserveSpanColors(const bool preserve) {
 	mPreserveSpanColors = preserve;
 	if (mPreserveSpanColors) {
@@ -860,14 +979,29 @@ void Text::setTrimWhiteSpace(const bool trim) {
 }
 
 void Text::onUpdateClient(const UpdateParams&) {
-	measurePangoText();
+	if (isAsyncRender()) {
+		updateAsyncRender();
+	} else {
+		updateSyncLayout();
+	}
 }
 
 void Text::onUpdateServer(const UpdateParams&) {
-	measurePangoText();
+	if (isAsyncRender()) {
+		updateAsyncRender();
+	} else {
+		updateSyncLayout();
+	}
 	YGNodeMarkDirty(mYogaNode);
 }
 
+void Text::updateSyncLayout() {
+	if (applyCachedText()) return;
+	// The size and texture from the cache are still good
+	if (mLayoutBehind && !needsLayout() && !mNeedsTextRender) return;
+	measurePangoText();
+}
+
 
 void Text::findFitFontSize() {
 
@@ -1184,9 +1318,277 @@ bool Text::parseLists() {
 	return true;
 }
 
+bool Text::detectMarkup() {
+	bool hadMarkup = mProbablyHasMarkup;
+
+	// Pango doesn't support HTML-esque line-break tags, so
+	// find break marks and replace with newlines, e.g. <br>, <BR>, <br />, <BR />
+	std::regex e("<br\\s?/?>", std::regex_constants::icase);
+	mProcessedText = std::regex_replace(mText, e, "\n");
+
+	if (mAllowMarkup) {
+		// Let's also decide and flag if there's markup in this string
+		// Faster to use pango_layout_set_text than pango_layout_set_markup later on if
+		// there's no markup to bother with.
+		// Be pretty liberal, there's more harm in false-postives than false-negatives
+		bool hasAmps	   = mProcessedText.find("&amp;") != std::string::npos;
+		mProbablyHasMarkup = ((mProcessedText.find("<") != std::string::npos) &&
+							  (mProcessedText.find(">") != std::string::npos)) ||
+							 hasAmps;
+
+		// parse any lists
+		if (mProbablyHasMarkup) {
+			mHasLists		  = false;
+			bool hasMoreLists = true;
+			while (hasMoreLists) {
+				hasMoreLists = parseLists();
+				if (hasMoreLists) {
+					mHasLists = true;
+				}
+			}
+
+			if (!hasAmps && mProcessedText.find("&") != std::string::npos) {
+				ds::replace(mProcessedText, "&", "&amp;");
+			}
+		}
+	} else {
+		hadMarkup		   = false;
+		mProbablyHasMarkup = false;
+	}
+
+	mNeedsMarkupDetection = false;
+	return hadMarkup;
+}
+
+Text::LayoutOptions Text::getLayoutOptions(const double textSize, const bool hadMarkup) const {
+	LayoutOptions options;
+	options.mText				= mProcessedText;
+	options.mMarkup				= mProbablyHasMarkup;
+	options.mHadMarkup			= hadMarkup;
+	options.mFont				= mStyle.mFont;
+	options.mFontSize			= textSize * mEngineFontScale * 1024.0;
+	options.mResizeLimitWidth	= mResizeLimitWidth;
+	options.mResizeLimitHeight	= mResizeLimitHeight;
+	options.mAlignment			= mStyle.mAlignment;
+	options.mWrapMode			= mWrapMode;
+	options.mEllipsizeMode		= mEllipsizeMode;
+	options.mSpacing			= (int)(textSize * (mStyle.mLeading - 1.0f)) * PANGO_SCALE;
+	options.mLetterSpacing		= mStyle.mLetterSpacing;
+	options.mTrimWhiteSpace		= mTrimWhiteSpace;
+	options.mColor				= mStyle.mColor;
+	options.mPreserveSpanColors = mPreserveSpanColors;
+	return options;
+}
+
+void Text::configureFont(PangoLayout* layout, const LayoutOptions& options) {
+	PangoFontDescription* fontDescription = pango_font_description_from_string(options.mFont.c_str());
+	pango_font_description_set_absolute_size(fontDescription, options.mFontSize);
+	pango_layout_set_font_description(layout, fontDescription);
+	pango_font_description_free(fontDescription);
+}
+
+void Text::configureLayout(PangoLayout* layout, const LayoutOptions& options) {
+	pango_layout_set_width(layout, (int)options.mResizeLimitWidth * PANGO_SCALE);
+	if (options.mWrapMode == WrapMode::kWrapModeOff) {
+		if (options.mEllipsizeMode == EllipsizeMode::kEllipsizeNone) {
+			pango_layout_set_width(layout, -1);
+		}
+		pango_layout_set_height(layout, (int)0);
+	} else if (options.mResizeLimitHeight < 0) {
+		pango_layout_set_height(layout, (int)options.mResizeLimitHeight);
+	} else {
+		pango_layout_set_height(layout, (int)options.mResizeLimitHeight * PANGO_SCALE);
+	}
+
+	// Pango separates alignment and justification... I prefer a simpler API here to handling certain edge
+	// cases.
+	if (options.mAlignment == Alignment::kJustify) {
+		pango_layout_set_justify(layout, true);
+		pango_layout_set_alignment(layout, PANGO_ALIGN_LEFT);
+	} else {
+		PangoAlignment aligny = PANGO_ALIGN_LEFT;
+		if (options.mAlignment == Alignment::kCenter) {
+			aligny = PANGO_ALIGN_CENTER;
+		} else if (options.mAlignment == Alignment::kRight) {
+			aligny = PANGO_ALIGN_RIGHT;
+		} else if (options.mAlignment == Alignment::kJustify) { // handled above, but just to be safe
+			aligny = PANGO_ALIGN_LEFT;
+		}
+
+		pango_layout_set_justify(layout, false);
+		pango_layout_set_alignment(layout, aligny);
+	}
+
+	if (options.mWrapMode == WrapMode::kWrapModeChar) {
+		pango_layout_set_wrap(layout, PANGO_WRAP_CHAR);
+	} else if (options.mWrapMode == WrapMode::kWrapModeWord) {
+		pango_layout_set_wrap(layout, PANGO_WRAP_WORD);
+	} else {
+		pango_layout_set_wrap(layout, PANGO_WRAP_WORD_CHAR);
+	}
+
+	PangoEllipsizeMode elipsizeMode = PANGO_ELLIPSIZE_NONE;
+	if (options.mEllipsizeMode == EllipsizeMode::kEllipsizeEnd) {
+		elipsizeMode = PANGO_ELLIPSIZE_END;
+	} else if (options.mEllipsizeMode == EllipsizeMode::kEllipsizeMiddle) {
+		elipsizeMode = PANGO_ELLIPSIZE_MIDDLE;
+	} else if (options.mEllipsizeMode == EllipsizeMode::kEllipsizeStart) {
+		elipsizeMode = PANGO_ELLIPSIZE_START;
+	}
+
+	pango_layout_set_ellipsize(layout, elipsizeMode);
+	pango_layout_set_spacing(layout, options.mSpacing);
+
+	// Set text, use the fastest method depending on what we found in the text
+	const std::string& text			  = options.mText;
+	int				   newPixelWidth  = 0;
+	int				   newPixelHeight = 0;
+	if (options.mMarkup) {
+		pango_layout_set_markup(layout, text.c_str(), static_cast<int>(text.size()));
+
+		// check the pixel size, if it's empty, then we can try again without markup
+		pango_layout_get_pixel_size(layout, &newPixelWidth, &newPixelHeight);
+	}
+
+	if (!options.mMarkup || newPixelWidth < 1) {
+		if (options.mHadMarkup) {
+			pango_layout_set_markup(layout, text.c_str(), static_cast<int>(text.size()));
+		}
+
+		pango_layout_set_text(layout, text.c_str(), -1);
+	}
+
+	if (options.mLetterSpacing != 0.0f) {
+		auto attrs		= pango_layout_get_attributes(layout);
+		bool createdNew = false;
+		if (attrs == nullptr) {
+			attrs	   = pango_attr_list_new();
+			createdNew = true;
+		}
+
+		// Set letter spacing: 0.0f=normal; 1.0f = 1pt extra spacing;
+		pango_attr_list_insert(attrs, pango_attr_letter_spacing_new((int)(options.mLetterSpacing * PANGO_SCALE)));
+
+		// Enable ligatures, kerning, and auto-conversion of simple fractions to a single character
+		// representation
+		// pango_attr_list_insert(attrs, pango_attr_font_features_new("liga=1, -kern, afrc on, frac on"));
+
+		pango_layout_set_attributes(layout, attrs);
+
+		if (createdNew) {
+			pango_attr_list_unref(attrs);
+		}
+	}
+}
+
+void Text::measureLayout(PangoLayout* layout, const LayoutOptions& options, LayoutMetrics& metrics) {
+	metrics.mWrapped	   = pango_layout_is_wrapped(layout) != FALSE;
+	metrics.mNumberOfLines = pango_layout_get_line_count(layout);
+
+	// use this instead: pango_layout_get_pixel_extents
+	PangoRectangle extentRect = PangoRectangle();
+	PangoRectangle inkRect	  = PangoRectangle();
+	pango_layout_get_pixel_extents(layout, &inkRect, &extentRect);
+
+	// The offset for rendering to the cairo surface
+	metrics.mPixelOffsetX = -extentRect.x;
+	metrics.mPixelOffsetY = -extentRect.y;
+
+	// Instead of making the image textue larger, we will offset the drawing to the correct position
+	metrics.mRenderOffset = ci::vec2(extentRect.x, extentRect.y);
+
+	// To account for the case where the inkRect goes outside of the extentRect:
+	//   move the cairo & render offsets appropriately by opposite amounts
+	if (inkRect.x < extentRect.x) {
+		metrics.mRenderOffset.x -= extentRect.x - inkRect.x;
+		metrics.mPixelOffsetX += extentRect.x - inkRect.x;
+	}
+
+	if (inkRect.y < extentRect.y) {
+		metrics.mRenderOffset.y -= extentRect.y - inkRect.y;
+		metrics.mPixelOffsetY += extentRect.y - inkRect.y;
+	}
+
+	// DS_LOG_INFO("Ink rect: " << inkRect.x << " " << inkRect.y << " " << inkRect.width << " " <<
+	// inkRect.height); DS_LOG_INFO("Ext rect: " << extentRect.x << " " << extentRect.y << " " <<
+	// extentRect.width << " " << extentRect.height << "\n");
+
+	// Set the final width/height for the texture, handling the case where inkRect is larger than extentRect
+	metrics.mPixelWidth	 = std::max(extentRect.width, inkRect.width);
+	metrics.mPixelHeight = std::max(extentRect.height, inkRect.height);
+
+	// Adjust size and render offset when trimming white space
+	if (options.mTrimWhiteSpace) {
+		switch (options.mAlignment) {
+		case Alignment::kCenter:
+			metrics.mRenderOffset -=
+				ci::vec2(inkRect.x + inkRect.width / 2 - (extentRect.x + extentRect.width / 2), inkRect.y);
+			break;
+		case Alignment::kRight:
+			metrics.mRenderOffset -= ci::vec2(inkRect.x + inkRect.width - (extentRect.x + extentRect.width), inkRect.y);
+			break;
+		case Alignment::kLeft:
+		case Alignment::kJustify:
+			metrics.mRenderOffset -= ci::vec2(inkRect.x, inkRect.y);
+			break;
+		}
+	}
+
+	metrics.mExtentX	  = extentRect.x;
+	metrics.mExtentWidth  = extentRect.width;
+	metrics.mExtentHeight = extentRect.height;
+	metrics.mWidth		  = float(options.mTrimWhiteSpace ? inkRect.width : metrics.mPixelWidth);
+	metrics.mHeight		  = float(options.mTrimWhiteSpace ? inkRect.height : metrics.mPixelHeight);
+}
+
+void Text::applyLayoutMetrics(const LayoutMetrics& metrics) {
+	mLayoutMetrics = metrics;
+	mWrappedText   = metrics.mWrapped;
+	mNumberOfLines = metrics.mNumberOfLines;
+	mPixelOffsetX  = metrics.mPixelOffsetX;
+	mPixelOffsetY  = metrics.mPixelOffsetY;
+	mRenderOffset  = metrics.mRenderOffset;
+	mPixelWidth	   = metrics.mPixelWidth;
+	mPixelHeight   = metrics.mPixelHeight;
+
+	if ((metrics.mExtentWidth == 0 || metrics.mExtentHeight == 0) && !mText.empty()) {
+		DS_LOG_WARNING("No size detected for pango text size. Font not detected or invalid markup are "
+					   "likely causes. Text: "
+					   << getTextAsString());
+	}
+
+	// This is required to not break combinations of layout align & text align
+	if (metrics.mExtentWidth < (int)mResizeLimitWidth) {
+		if (!mShrinkToBounds) {
+			setSize(mResizeLimitWidth, metrics.mHeight);
+		} else {
+			mRenderOffset.x -= metrics.mExtentX;
+			setSize(metrics.mWidth, metrics.mHeight);
+		}
+	} else {
+		setSize(metrics.mWidth, metrics.mHeight);
+	}
+	YGNodeMarkDirty(mYogaNode);
+}
+
 bool Text::measurePangoText() {
-	if (mNeedsFontUpdate || mNeedsMeasuring || mNeedsMarkupDetection) {
+	// The last async render measured without mPangoLayout, so lay it out again for whoever's asking. The pixels
+	// are already rendered or on the way, unless something else changed since.
+	bool caughtUp	  = false;
+	bool neededRender = mNeedsTextRender;
+	if (mLayoutBehind) {
+		caughtUp = !needsLayout();
+
+		g_object_unref(mPangoLayout);
+		mPangoLayout	 = pango_layout_new(mPangoContext);
+		mNeedsFontUpdate = true;
+		mNeedsMeasuring	 = true;
+		mLayoutBehind	 = false;
+	}
 
+	if (needsLayout()) {
+		// Anything still out on a text thread is out of date now
+		if (!caughtUp) cancelAsyncRender();
 
 		if (mText.empty() || mStyle.mSize <= 0.0f) {
 			if (mWidth > 0.0f || mHeight > 0.0f) {
@@ -1207,70 +1609,24 @@ bool Text::measurePangoText() {
 		bool hadMarkup	 = mProbablyHasMarkup;
 
 		if (mNeedsMarkupDetection) {
-
-			// Pango doesn't support HTML-esque line-break tags, so
-			// find break marks and replace with newlines, e.g. <br>, <BR>, <br />, <BR />
-			std::regex e("<br\\s?/?>", std::regex_constants::icase);
-			mProcessedText = std::regex_replace(mText, e, "\n");
-
-			if (mAllowMarkup) {
-				// Let's also decide and flag if there's markup in this string
-				// Faster to use pango_layout_set_text than pango_layout_set_markup later on if
-				// there's no markup to bother with.
-				// Be pretty liberal, there's more harm in false-postives than false-negatives
-				bool hasAmps	   = mProcessedText.find("&amp;") != std::string::npos;
-				mProbablyHasMarkup = ((mProcessedText.find("<") != std::string::npos) &&
-									  (mProcessedText.find(">") != std::string::npos)) ||
-									 hasAmps;
-
-				// parse any lists
-				if (mProbablyHasMarkup) {
-					mHasLists		  = false;
-					bool hasMoreLists = true;
-					while (hasMoreLists) {
-						hasMoreLists = parseLists();
-						if (hasMoreLists) {
-							mHasLists = true;
-						}
-					}
-
-					if (!hasAmps && mProcessedText.find("&") != std::string::npos) {
-						ds::replace(mProcessedText, "&", "&amp;");
-					}
-				}
-			} else {
-				hadMarkup		   = false;
-				mProbablyHasMarkup = false;
-			}
-
-			mNeedsMarkupDetection = false;
+			hadMarkup = detectMarkup();
 		}
 
 		// First run, and then if the fonts change
 		if (mNeedsFontOptionUpdate) {
-			// TODO, expose these?
-
-			cairo_font_options_set_antialias(mCairoFontOptions, CAIRO_ANTIALIAS_SUBPIXEL);
-			cairo_font_options_set_hint_style(mCairoFontOptions, CAIRO_HINT_STYLE_DEFAULT);
-			cairo_font_options_set_hint_metrics(mCairoFontOptions, CAIRO_HINT_METRICS_ON);
-			cairo_font_options_set_subpixel_order(mCairoFontOptions, CAIRO_SUBPIXEL_ORDER_BGR);
-
-			pango_cairo_context_set_font_options(mPangoContext, mCairoFontOptions);
+			set_font_options(mPangoContext, mCairoFontOptions);
 
 			mNeedsFontOptionUpdate = false;
 		}
 
-		if (mNeedsFontUpdate || mNeedsFontSizeUpdate) {
+		const LayoutOptions options = getLayoutOptions(textSize, hadMarkup);
 
-			PangoFontDescription* fontDescription =
-				pango_font_description_from_string(mStyle.mFont.c_str()); // +" " + std::to_string(textSize)).c_str());
-			pango_font_description_set_absolute_size(fontDescription, textSize * mEngineFontScale * 1024.0);
-			pango_layout_set_font_description(mPangoLayout, fontDescription);
+		if (mNeedsFontUpdate || mNeedsFontSizeUpdate) {
+			configureFont(mPangoLayout, options);
 			if (mNeedsFontUpdate) {
 				pango_font_map_load_font(mEngine.getPangoFontService().getPangoFontMap(), mPangoContext,
-										 fontDescription);
+										 pango_layout_get_font_description(mPangoLayout));
 			}
-			pango_font_description_free(fontDescription);
 
 			mNeedsFontUpdate	 = false;
 			mNeedsFontSizeUpdate = false;
@@ -1278,269 +1634,249 @@ bool Text::measurePangoText() {
 
 		// If the text or the bounds change
 		if (mNeedsMeasuring) {
-			pango_layout_set_width(mPangoLayout, (int)mResizeLimitWidth * PANGO_SCALE);
-			if (mWrapMode == WrapMode::kWrapModeOff) {
-				if (mEllipsizeMode == EllipsizeMode::kEllipsizeNone) {
-					pango_layout_set_width(mPangoLayout, -1);
-				}
-				pango_layout_set_height(mPangoLayout, (int)0);
-			} else if (mResizeLimitHeight < 0) {
-				pango_layout_set_height(mPangoLayout, (int)mResizeLimitHeight);
-			} else {
-				pango_layout_set_height(mPangoLayout, (int)mResizeLimitHeight * PANGO_SCALE);
-			}
-
-			// Pango separates alignment and justification... I prefer a simpler API here to handling certain edge
-			// cases.
-			if (mStyle.mAlignment == Alignment::kJustify) {
-				pango_layout_set_justify(mPangoLayout, true);
-				pango_layout_set_alignment(mPangoLayout, PANGO_ALIGN_LEFT);
-			} else {
-				PangoAlignment aligny = PANGO_ALIGN_LEFT;
-				if (mStyle.mAlignment == Alignment::kCenter) {
-					aligny = PANGO_ALIGN_CENTER;
-				} else if (mStyle.mAlignment == Alignment::kRight) {
-					aligny = PANGO_ALIGN_RIGHT;
-				} else if (mStyle.mAlignment == Alignment::kJustify) { // handled above, but just to be safe
-					aligny = PANGO_ALIGN_LEFT;
-				}
+			configureLayout(mPangoLayout, options);
 
-				pango_layout_set_justify(mPangoLayout, false);
-				pango_layout_set_alignment(mPangoLayout, aligny);
-			}
-
-			if (mWrapMode == WrapMode::kWrapModeChar) {
-				pango_layout_set_wrap(mPangoLayout, PANGO_WRAP_CHAR);
-			} else if (mWrapMode == WrapMode::kWrapModeWord) {
-				pango_layout_set_wrap(mPangoLayout, PANGO_WRAP_WORD);
-			} else {
-				pango_layout_set_wrap(mPangoLayout, PANGO_WRAP_WORD_CHAR);
-			}
-
-			PangoEllipsizeMode elipsizeMode = PANGO_ELLIPSIZE_NONE;
-			if (mEllipsizeMode == EllipsizeMode::kEllipsizeEnd) {
-				elipsizeMode = PANGO_ELLIPSIZE_END;
-			} else if (mEllipsizeMode == EllipsizeMode::kEllipsizeMiddle) {
-				elipsizeMode = PANGO_ELLIPSIZE_MIDDLE;
-			} else if (mEllipsizeMode == EllipsizeMode::kEllipsizeStart) {
-				elipsizeMode = PANGO_ELLIPSIZE_START;
-			}
+			// If we are sizing for limits we do that logic here after all the attributes have be set.
+			// at the end of this only the font size should be changed.
+			findFitFontSize();
 
-			pango_layout_set_ellipsize(mPangoLayout, elipsizeMode);
-			pango_layout_set_spacing(mPangoLayout, (int)(textSize * (mStyle.mLeading - 1.0f)) * PANGO_SCALE);
+			LayoutMetrics metrics;
+			measureLayout(mPangoLayout, options, metrics);
+			applyLayoutMetrics(metrics);
 
-			// Set text, use the fastest method depending on what we found in the text
-			int newPixelWidth  = 0;
-			int newPixelHeight = 0;
-			if (mProbablyHasMarkup) {
-				pango_layout_set_markup(mPangoLayout, mProcessedText.c_str(), static_cast<int>(mProcessedText.size()));
+			mNeedsMeasuring = false;
+		}
 
-				// check the pixel size, if it's empty, then we can try again without markup
-				pango_layout_get_pixel_size(mPangoLayout, &newPixelWidth, &newPixelHeight);
-			}
+		if (caughtUp) {
+			mNeedsTextRender = neededRender;
+		} else {
+			mNeedsBatchUpdate = true;
+		}
+		return !caughtUp;
+	} else {
+		return false;
+	}
+}
 
-			if (!mProbablyHasMarkup || newPixelWidth < 1) {
-				if (hadMarkup) {
-					pango_layout_set_markup(mPangoLayout, mProcessedText.c_str(),
-											static_cast<int>(mProcessedText.size()));
-				}
+cairo_surface_t* Text::rasterizeLayout(PangoLayout* layout, const LayoutOptions& options,
+									   const LayoutMetrics& metrics) {
+	_cairo_format cairoFormat = options.mPreserveSpanColors ? CAIRO_FORMAT_ARGB32 : CAIRO_FORMAT_A8;
 
-				pango_layout_set_text(mPangoLayout, mProcessedText.c_str(), -1);
-			}
+	cairo_surface_t* cairoSurface = cairo_image_surface_create(cairoFormat, metrics.mPixelWidth, metrics.mPixelHeight);
 
-			if (mStyle.mLetterSpacing != 0.0f) {
-				auto attrs		= pango_layout_get_attributes(mPangoLayout);
-				bool createdNew = false;
-				if (attrs == nullptr) {
-					attrs	   = pango_attr_list_new();
-					createdNew = true;
-				}
+	auto cairoSurfaceStatus = cairo_surface_status(cairoSurface);
+	if (CAIRO_STATUS_SUCCESS != cairoSurfaceStatus) {
+		DS_LOG_WARNING("Error creating Cairo surface. Status:" << cairoSurfaceStatus << " w:" << metrics.mPixelWidth
+															   << " h:" << metrics.mPixelHeight
+															   << " text:" << options.mText);
+		cairo_surface_destroy(cairoSurface);
+		return nullptr;
+	}
 
-				// Set letter spacing: 0.0f=normal; 1.0f = 1pt extra spacing;
-				pango_attr_list_insert(attrs,
-									   pango_attr_letter_spacing_new((int)(mStyle.mLetterSpacing * PANGO_SCALE)));
+	// Create context
+	cairo_t* cairoContext = cairo_create(cairoSurface);
 
-				// Enable ligatures, kerning, and auto-conversion of simple fractions to a single character
-				// representation
-				// pango_attr_list_insert(attrs, pango_attr_font_features_new("liga=1, -kern, afrc on, frac on"));
+	auto cairoStatus = cairo_status(cairoContext);
+	if (CAIRO_STATUS_SUCCESS != cairoStatus) {
+		if (CAIRO_STATUS_NO_MEMORY == cairoStatus) {
+			DS_LOG_WARNING("Out of memory, error creating Cairo context");
+		} else {
+			DS_LOG_WARNING("Error creating Cairo context " << cairoStatus);
+		}
+		cairo_destroy(cairoContext);
+		cairo_surface_destroy(cairoSurface);
+		return nullptr;
+	}
 
-				pango_layout_set_attributes(mPangoLayout, attrs);
+	// Draw the text into the buffer
+	cairo_set_source_rgb(cairoContext, options.mColor.r, options.mColor.g, options.mColor.b);
 
-				if (createdNew) {
-					pango_attr_list_unref(attrs);
-				}
-			}
+	// Move the layout into the correct position on the surface/context before drawing!
+	// This removes the need for additional texture padding & fixes clipping ascenders
+	cairo_translate(cairoContext, metrics.mPixelOffsetX, metrics.mPixelOffsetY);
+	pango_cairo_update_layout(cairoContext, layout);
+	pango_cairo_show_layout(cairoContext, layout);
 
-			// If we are sizing for limits we do that logic here after all the attributes have be set.
-			// at the end of this only the font size should be changed.
-			findFitFontSize();
+	//	cairo_surface_write_to_png(cairoSurface, "test_font.png");
 
+	cairo_destroy(cairoContext);
+	cairo_surface_flush(cairoSurface);
+	return cairoSurface;
+}
 
-			mWrappedText   = pango_layout_is_wrapped(mPangoLayout) != FALSE;
-			mNumberOfLines = pango_layout_get_line_count(mPangoLayout);
+void Text::uploadTexture(cairo_surface_t* cairoSurface, const bool preserveSpanColors) {
+	releaseCachedText();
 
-			// use this instead: pango_layout_get_pixel_extents
-			PangoRectangle extentRect = PangoRectangle();
-			PangoRectangle inkRect	  = PangoRectangle();
-			pango_layout_get_pixel_extents(mPangoLayout, &inkRect, &extentRect);
+	// Copy it out to a texture
+	unsigned char* pixels	   = cairo_image_surface_get_data(cairoSurface);
+	const int	   pixelWidth  = cairo_image_surface_get_width(cairoSurface);
+	const int	   pixelHeight = cairo_image_surface_get_height(cairoSurface);
+	const bool	   mipmap	   = mEngine.getPangoFontService().getTextMipmap();
 
-			// The offset for rendering to the cairo surface
-			mPixelOffsetX = -extentRect.x;
-			mPixelOffsetY = -extentRect.y;
+	auto imgWitdh = pixelWidth;
+	if (!preserveSpanColors && imgWitdh % 4 != 0) {
+		imgWitdh += 4 - imgWitdh % 4;
+	}
 
-			// Instead of making the image textue larger, we will offset the drawing to the correct position
-			mRenderOffset = ci::vec2(extentRect.x, extentRect.y);
+	// Refill the texture from last time if it's the same size and nothing else is drawing it
+	if (mTexture && mTexture.use_count() == 1 && !mipmap && mTexture->getWidth() == imgWitdh &&
+		mTexture->getHeight() == pixelHeight && (mTexture->getInternalFormat() == GL_RED) == !preserveSpanColors) {
+		mTexture->update(pixels, preserveSpanColors ? GL_BGRA : GL_RED, GL_UNSIGNED_BYTE, 0, imgWitdh, pixelHeight);
+		return;
+	}
 
-			// To account for the case where the inkRect goes outside of the extentRect:
-			//   move the cairo & render offsets appropriately by opposite amounts
-			if (inkRect.x < extentRect.x) {
-				mRenderOffset.x -= extentRect.x - inkRect.x;
-				mPixelOffsetX += extentRect.x - inkRect.x;
-			}
+	ci::gl::Texture::Format format;
+	format.enableMipmapping(mipmap);
 
-			if (inkRect.y < extentRect.y) {
-				mRenderOffset.y -= extentRect.y - inkRect.y;
-				mPixelOffsetY += extentRect.y - inkRect.y;
-			}
+	if (preserveSpanColors) {
+		mTexture = ci::gl::Texture::create(pixels, GL_BGRA, imgWitdh, pixelHeight, format);
+	} else {
+		format.setInternalFormat(GL_RED);
+		format.setDataType(GL_UNSIGNED_BYTE);
+		mTexture = ci::gl::Texture::create(pixels, GL_RED, imgWitdh, pixelHeight, format);
+	}
 
-			if ((extentRect.width == 0 || extentRect.height == 0) && !mText.empty()) {
-				DS_LOG_WARNING("No size detected for pango text size. Font not detected or invalid markup are "
-							   "likely causes. Text: "
-							   << getTextAsString());
-			}
+	mTexture->setTopDown(true);
+}
 
-			// DS_LOG_INFO("the Text: " << getTextAsString());
-			// DS_LOG_INFO("Ink rect: " << inkRect.x << " " << inkRect.y << " " << inkRect.width << " " <<
-			// inkRect.height); DS_LOG_INFO("Ext rect: " << extentRect.x << " " << extentRect.y << " " <<
-			// extentRect.width << " " << extentRect.height << "\n");
-
-			// Set the final width/height for the texture, handling the case where inkRect is larger than extentRect
-			mPixelWidth	 = std::max(extentRect.width, inkRect.width);
-			mPixelHeight = std::max(extentRect.height, inkRect.height);
-
-			// Adjust size and render offset when trimming white space
-			if (mTrimWhiteSpace) {
-				switch (mStyle.mAlignment) {
-				case Alignment::kCenter:
-					mRenderOffset -=
-						ci::vec2(inkRect.x + inkRect.width / 2 - (extentRect.x + extentRect.width / 2), inkRect.y);
-					break;
-				case Alignment::kRight:
-					mRenderOffset -= ci::vec2(inkRect.x + inkRect.width - (extentRect.x + extentRect.width), inkRect.y);
-					break;
-				case Alignment::kLeft:
-				case Alignment::kJustify:
-					mRenderOffset -= ci::vec2(inkRect.x, inkRect.y);
-					break;
-				}
-			}
+void Text::renderPangoText() {
+	if (mAsyncJob) {
+		// Keep showing the last texture until the text thread is done
+		if (!mAsyncJob->mApplied) return;
+
+		if (mAsyncJob->mSurface) {
+			uploadTexture(mAsyncJob->mSurface, mAsyncJob->mOptions.mPreserveSpanColors);
+			cacheTexture(mAsyncJob->mOptions.getCacheKey());
+		} else if (mAsyncJob->mMetrics.mPixelWidth > 0 && mAsyncJob->mMetrics.mPixelHeight > 0) {
+			// make sure we don't render garbage
+			releaseCachedText();
+			mTexture = nullptr;
+		}
+		mAsyncJob.reset();
+		return;
+	}
 
-			const auto pixelWidth  = float(mTrimWhiteSpace ? inkRect.width : mPixelWidth);
-			const auto pixelHeight = float(mTrimWhiteSpace ? inkRect.height : mPixelHeight);
+	// Async text is rendered on the text threads, and a layout that's behind can't be drawn
+	if (isAsyncRender() || mLayoutBehind) return;
 
-			// This is required to not break combinations of layout align & text align
-			if (extentRect.width < (int)mResizeLimitWidth) {
-				if (!mShrinkToBounds) {
-					setSize(mResizeLimitWidth, pixelHeight);
-				} else {
-					mRenderOffset.x -= extentRect.x;
-					setSize(pixelWidth, pixelHeight);
-				}
-			} else {
-				setSize(pixelWidth, pixelHeight);
-			}
-			YGNodeMarkDirty(mYogaNode);
+	if (mNeedsTextRender && mPixelWidth > 0 && mPixelHeight > 0) {
+		LayoutOptions options;
+		options.mText				= mText;
+		options.mColor				= mStyle.mColor;
+		options.mPreserveSpanColors = mPreserveSpanColors;
+
+		LayoutMetrics metrics;
+		metrics.mPixelOffsetX = mPixelOffsetX;
+		metrics.mPixelOffsetY = mPixelOffsetY;
+		metrics.mPixelWidth	  = mPixelWidth;
+		metrics.mPixelHeight  = mPixelHeight;
+
+		cairo_surface_t* cairoSurface = rasterizeLayout(mPangoLayout, options, metrics);
+		if (!cairoSurface) {
+			// make sure we don't render garbage
+			releaseCachedText();
+			mTexture = nullptr;
+			return;
+		}
 
-			mNeedsMeasuring = false;
+		uploadTexture(cairoSurface, mPreserveSpanColors);
+		if (!mFitToResizeLimit) {
+			cacheTexture(getLayoutOptions(mStyle.mSize, false).getCacheKey());
 		}
+		mNeedsTextRender = false;
 
-		mNeedsBatchUpdate = true;
-		return true;
-	} else {
-		return false;
+		cairo_surface_destroy(cairoSurface);
 	}
 }
 
-void Text::renderPangoText() {
-	if (mNeedsTextRender && mPixelWidth > 0 && mPixelHeight > 0) {
-
-		_cairo_format cairoFormat = mPreserveSpanColors ? CAIRO_FORMAT_ARGB32 : CAIRO_FORMAT_A8;
-
-		cairo_surface_t* cairoSurface = cairo_image_surface_create(cairoFormat, mPixelWidth, mPixelHeight);
+void Text::updateAsyncRender() {
+	if (mAsyncJob && mAsyncJob->mDone && !mAsyncJob->mApplied) {
+		applyLayoutMetrics(mAsyncJob->mMetrics);
+		mAsyncJob->mApplied = true;
+		mNeedsBatchUpdate	= true;
+	}
 
-		auto cairoSurfaceStatus = cairo_surface_status(cairoSurface);
-		if (CAIRO_STATUS_SUCCESS != cairoSurfaceStatus) {
-			DS_LOG_WARNING("Error creating Cairo surface. Status:" << cairoSurfaceStatus << " w:" << mPixelWidth
-																   << " h:" << mPixelHeight << " text:" << mText);
-			// make sure we don't render garbage
-			if (mTexture) {
-				mTexture = nullptr;
-			}
+	if (needsLayout()) {
+		if (mText.empty() || mStyle.mSize <= 0.0f || !mPangoLayout) {
+			measurePangoText();
 			return;
 		}
+		if (applyCachedText()) return;
+
+		if (mNeedsMarkupDetection) detectMarkup();
+		startAsyncRender();
+
+		// mPangoLayout gets laid out later, if anything asks
+		mNeedsFontUpdate	 = false;
+		mNeedsFontSizeUpdate = false;
+		mNeedsMeasuring		 = false;
+		mLayoutBehind		 = true;
+	} else if (mNeedsTextRender && mPangoLayout) {
+		startAsyncRender();
+	}
+}
 
-		cairo_t* cairoContext = nullptr;
-		if (cairoSurface) {
-			// Create context
-			cairoContext = cairo_create(cairoSurface);
+void Text::startAsyncRender() {
+	cancelAsyncRender();
 
-			auto cairoStatus = cairo_status(cairoContext);
+	// Fitting isn't done async, so this is always the style's size
+	auto job	  = std::make_shared<AsyncRender>();
+	job->mOptions = getLayoutOptions(mStyle.mSize, false);
+	mAsyncJob	  = job;
 
-			if (CAIRO_STATUS_NO_MEMORY == cairoStatus) {
-				DS_LOG_WARNING("Out of memory, error creating Cairo context");
-				cairo_surface_destroy(cairoSurface);
-				return;
-			}
+	mNeedsTextRender = false;
+	mEngine.getPangoFontService().queueTextWork([job](PangoContext* context) { job->run(context); });
+}
 
-			if (CAIRO_STATUS_SUCCESS != cairoStatus) {
-				DS_LOG_WARNING("Error creating Cairo context " << cairoStatus);
-				cairo_surface_destroy(cairoSurface);
-				return;
-			}
-		}
+void Text::cancelAsyncRender() {
+	if (!mAsyncJob) return;
 
-		if (cairoContext) {
+	mAsyncJob->mCancelled = true;
+	mAsyncJob.reset();
+}
 
-			// Draw the text into the buffer
-			cairo_set_source_rgb(cairoContext, mStyle.mColor.r, mStyle.mColor.g, mStyle.mColor.b);
+bool Text::applyCachedText() {
+	if (!needsLayout()) return false;
+	if (mText.empty() || mStyle.mSize <= 0.0f || mFitToResizeLimit || !mPangoLayout) return false;
 
-			// Move the layout into the correct position on the surface/context before drawing!
-			// This removes the need for additional texture padding & fixes clipping ascenders
-			cairo_translate(cairoContext, mPixelOffsetX, mPixelOffsetY);
-			pango_cairo_update_layout(cairoContext, mPangoLayout);
-			pango_cairo_show_layout(cairoContext, mPangoLayout);
+	if (!mTextCache->getEnabled()) return false;
 
-			//	cairo_surface_write_to_png(cairoSurface, "test_font.png");
+	// If the layout had markup, it has to start over, see measurePangoText()
+	if (mNeedsMarkupDetection && detectMarkup()) mLayoutBehind = true;
 
-			// Copy it out to a texture
-			unsigned char* pixels = cairo_image_surface_get_data(cairoSurface);
+	const std::string  key = getLayoutOptions(mStyle.mSize, false).getCacheKey();
+	ci::gl::TextureRef texture;
+	LayoutMetrics	   metrics;
+	if (!mTextCache->acquire(key, texture, metrics)) return false;
 
-			ci::gl::Texture::Format format;
-			format.enableMipmapping(mEngine.getEngineSettings().getBool("text_mipmap", 0, false));
+	cancelAsyncRender();
+	releaseCachedText();
+	mCacheKey = key;
+	mTexture  = texture;
+	applyLayoutMetrics(metrics);
 
-			if (mPreserveSpanColors) {
-				mTexture = ci::gl::Texture::create(pixels, GL_BGRA, mPixelWidth, mPixelHeight, format);
-			} else {
-				auto imgWitdh = mPixelWidth;
-				if (imgWitdh % 4 != 0) {
-					imgWitdh += 4 - imgWitdh % 4;
-				}
-				format.setInternalFormat(GL_RED);
-				format.setDataType(GL_UNSIGNED_BYTE);
-				mTexture = ci::gl::Texture::create(pixels, GL_RED, imgWitdh, mPixelHeight, format);
-			}
+	// mPangoLayout gets laid out later, if anything asks
+	mNeedsFontUpdate	 = false;
+	mNeedsFontSizeUpdate = false;
+	mNeedsMeasuring		 = false;
+	mNeedsTextRender	 = false;
+	mNeedsBatchUpdate	 = true;
+	mLayoutBehind		 = true;
+	return true;
+}
 
-			mTexture->setTopDown(true);
+void Text::cacheTexture(const std::string& key) {
+	if (!mTexture || !mTextCache->getEnabled()) return;
 
-			mNeedsTextRender = false;
+	mTexture  = mTextCache->insert(key, mTexture, mLayoutMetrics);
+	mCacheKey = key;
+}
 
-			cairo_destroy(cairoContext);
-		}
+void Text::releaseCachedText() {
+	if (mCacheKey.empty()) return;
 
-		if (cairoSurface) {
-			cairo_surface_destroy(cairoSurface);
-		}
-	}
+	mTextCache->release(mCacheKey);
+	mCacheKey.clear();
 }
 
 void Text::measureMinMaxTextSize() {
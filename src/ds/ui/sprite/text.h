@@ -1,5 +1,6 @@
 #pragma once
 
+#include "ds/ui/service/text_cache.h"
 #include "ds/ui/sprite/sprite.h"
 #include "ds/ui/sprite/text_defs.h"
 #include <cinder/gl/Texture.h>
@@ -229,6 +230,15 @@ class Text : public ds::ui::Sprite {
 	/// Returns if markup is allowed or not
 	bool getAllowMarkup() { return mAllowMarkup; }
 
+	/// Lays out and renders the text on the text threads instead of during the update, and keeps showing the
+	/// previous texture until the new one is ready, so the size and texture catch up a frame or more after a
+	/// change. Until then getWidth() and getHeight() answer the size of the last render, while anything that
+	/// reads the layout (character positions, line heights, baselines) lays the new text out on the main thread.
+	/// Text that fits to the resize limit is always laid out on the main thread. Defaults to the text:async_render
+	/// setting.
+	void setAsyncRender(const bool async);
+	bool getAsyncRender() const { return mAsyncRender; }
+
 	/// Returns the 2-d position of the character in the current text string
 	/// Will return 0,0 if the string is blank or the index is out-of-bounds
 	/// Note that this position is fudged by 25% vertically to get the top-left corner of most characters in most
@@ -310,6 +320,44 @@ class Text : public ds::ui::Sprite {
 	/// Renders text into the texture.
 	void renderPangoText();
 
+	/// Everything a layout needs, copied out so it can be laid out on any thread
+	struct LayoutOptions;
+	/// The result of measuring a layout
+	typedef TextLayoutMetrics LayoutMetrics;
+	/// A layout and render running on one of the PangoFontService text threads
+	struct AsyncRender;
+
+	LayoutOptions			getLayoutOptions(const double textSize, const bool hadMarkup) const;
+	static void				configureFont(PangoLayout*, const LayoutOptions&);
+	static void				configureLayout(PangoLayout*, const LayoutOptions&);
+	static void				measureLayout(PangoLayout*, const LayoutOptions&, LayoutMetrics&);
+	static cairo_surface_t* rasterizeLayout(PangoLayout*, const LayoutOptions&, const LayoutMetrics&);
+	/// Sizes the sprite from the metrics
+	void applyLayoutMetrics(const LayoutMetrics&);
+	/// Copies a rendered surface into mTexture, reusing it if nothing else holds on to it
+	void uploadTexture(cairo_surface_t*, const bool preserveSpanColors);
+
+	/// Replaces line breaks, parses lists and guesses if there's markup. Answers if there was markup before
+	bool detectMarkup();
+
+	bool isAsyncRender() const { return mAsyncRender && !mFitToResizeLimit; }
+	/// Picks up finished renders and starts new ones. Called in place of measurePangoText() in the update
+	void updateAsyncRender();
+	void startAsyncRender();
+	void cancelAsyncRender();
+
+	/// Sizes and textures the sprite from the TextCache if another sprite already rendered the same thing.
+	/// Called before measuring in the update.
+	bool applyCachedText();
+	/// The update for text that isn't async. Once a cache hit leaves mPangoLayout behind, it's only laid out again
+	/// when the text changes or has to be rendered, or something that reads mPangoLayout asks for it
+	void updateSyncLayout();
+	/// Something the size or layout depends on changed since the last measure
+	bool needsLayout() const { return mNeedsFontUpdate || mNeedsMeasuring || mNeedsMarkupDetection; }
+	/// Hands mTexture to the TextCache under key, which may answer a texture someone else cached first
+	void cacheTexture(const std::string& key);
+	void releaseCachedText();
+
 	/// Measures min/max size of the text for layout purposes
 	void measureMinMaxTextSize();
 
@@ -376,6 +424,18 @@ class Text : public ds::ui::Sprite {
 	/// Pango and cairo references
 
 	cairo_font_options_t* mCairoFontOptions;
+
+	/// Async rendering, see setAsyncRender()
+	bool						 mAsyncRender;
+	std::shared_ptr<AsyncRender> mAsyncJob;
+	/// The last async render measured the text without mPangoLayout, so it needs laying out before it's read
+	bool mLayoutBehind;
+
+	/// The metrics last applied, which get cached along with the texture
+	LayoutMetrics mLayoutMetrics;
+	/// The TextCache entry mTexture came from, if any
+	std::shared_ptr<TextCache> mTextCache;
+	std::string				   mCacheKey;
 };
 
 } // namespace ds::ui
@@ -38,6 +38,11 @@ namespace ds { namespace ui {
 	bool TouchProcess::processTouchInfo(const TouchInfo& touchInfo) {
 		if (!mSprite.visible() || !mSprite.isEnabled()) return false;
 
+		// Idle sprites don't get update() calls when the engine skips them, so catch up on the time here
+		if (mSpriteEngine.getSkipIdleUpdates()) {
+			mLastUpdateTime = static_cast<float>(mSpriteEngine.getElapsedTimeSeconds());
+		}
+
 		mSprite.userInputReceived();
 
 		processTap(touchInfo);
@@ -186,6 +191,10 @@ namespace ds { namespace ui {
 		return !mFingers.empty();
 	}
 
+	bool TouchProcess::hasPendingTap() const {
+		return mOneTap && mSprite.hasDoubleTap();
+	}
+
 	void TouchProcess::sendTouchInfo(const TouchInfo& touchInfo) {
 		TouchInfo t		   = touchInfo;
 		t.mCurrentAngle	   = mCurrentAngle;
@@ -28,6 +28,8 @@ namespace ds { namespace ui {
 		void update(const UpdateParams& updateParams);
 
 		bool hasTouches() const;
+		/// A tap is waiting to see if it turns into a double tap, which update() resolves
+		bool hasPendingTap() const;
 
 		void clearTouches();
 
@@ -30,6 +30,10 @@ bool IdleTimer::isIdling() const {
 	return mIdling;
 }
 
+bool IdleTimer::isCounting() const {
+	return mActive && mSetup && !mIdling;
+}
+
 void IdleTimer::startIdling() {
 	if (!mSetup) return;
 
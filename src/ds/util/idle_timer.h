@@ -13,6 +13,8 @@ class IdleTimer {
 	void   setSecondBeforeIdle(const double);
 	double secondsToIdle() const;
 	bool   isIdling() const;
+	/// Set up and not idling yet, so update() still has something to do
+	bool   isCounting() const;
 	void   startIdling();
 	void   resetIdleTimer();
 	void   clear();
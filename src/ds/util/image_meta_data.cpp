@@ -10,10 +10,16 @@
 #include <Poco/File.h>
 #include <Poco/Path.h>
 #include <Poco/String.h>
+#include <chrono>
 #include <cinder/ImageIo.h>
 #include <cinder/Surface.h>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
 #include <unordered_map>
 
+#include "ds/query/sqlite/sqlite3.h"
+
 #include "ds/util/exif_reader.h"
 
 namespace ds {
@@ -25,12 +31,6 @@ namespace {
 	const int FORMAT_PNG	 = 1;
 	const int FORMAT_JPG	 = 2;
 
-	// Storage object
-	const std::string PATH_SZ("q");
-	const std::string WIDTH_SZ("w");
-	const std::string HEIGHT_SZ("h");
-	const std::string TIMESTAMP_SZ("ts");
-
 	int get_format(const std::string& filename) {
 		const Poco::Path path(filename);
 		std::string		 ext = path.getExtension();
@@ -77,7 +77,8 @@ namespace {
 		return true;
 	}
 
-	bool get_format_jpg(const std::string& filename, ci::vec2& outSize) {
+	/// Also answers the exif orientation, if there's an exif segment before the image data
+	bool get_format_jpg(const std::string& filename, ci::vec2& outSize, int& outOrientation) {
 		std::ifstream file(filename, std::ios_base::binary | std::ios_base::in);
 		if (!file.is_open() || !file) return false;
 
@@ -128,6 +129,18 @@ namespace {
 				return true;
 			} else if (marker == 0xDA || marker == 0xD9) {
 				return false;
+			} else if (marker == 0xE1) {
+				// APP1, which is where exif lives
+				auto length = readWord();
+				if (length < 2) return false;
+				std::vector<unsigned char> segment(length - 2);
+				if (!segment.empty() && !file.read((char*)segment.data(), segment.size())) return false;
+
+				easyexif::EXIFInfo exif;
+				if (exif.parseFromEXIFSegment(segment.data(), static_cast<unsigned>(segment.size())) ==
+					PARSE_EXIF_SUCCESS) {
+					outOrientation = exif.Orientation;
+				}
 			} else {
 				// Skip this segment
 				auto length = readWord();
@@ -202,25 +215,159 @@ namespace {
 
 } // namespace
 
-// Store a cache of parsed files.  We should have this cache to a database, but for now, just have
-// it generate at each run.
+// Store a cache of parsed files. Sizes are kept in a sqlite file between runs, and an entry is only trusted
+// once the file's modified time has been checked this run.
 namespace {
+	typedef std::chrono::steady_clock steady_clock;
+
+	/// Bump this when the table changes, and old files get dropped
+	const int CACHE_VERSION = 1;
+	/// How long a checked modified time is trusted before checking again
+	const auto RECHECK_TIME = std::chrono::seconds(1);
+	/// New entries are held this long so they go to disk in one transaction
+	const auto WRITE_DELAY = std::chrono::seconds(2);
+
 	class ImageAtts {
 	  public:
-		ImageAtts() {}
+		ImageAtts()
+		  : mOrientation(0)
+		  , mFormat(FORMAT_UNKNOWN) {}
 
 		ImageAtts(const ci::vec2& size)
-		  : mSize(size) {}
+		  : mSize(size)
+		  , mOrientation(0)
+		  , mFormat(FORMAT_UNKNOWN) {}
 
 		Poco::Timestamp mLastModified;
 		ci::vec2		mSize;
+		int				mOrientation;
+		int				mFormat;
+		/// When mLastModified was last compared with the file. Never, for entries loaded from disk.
+		steady_clock::time_point mChecked;
 	};
 
+	/// Answers null if the file can't be opened
+	sqlite3* open_cache(const std::string& filename, const bool create) {
+		if (filename.empty()) return nullptr;
+
+		try {
+			if (create) {
+				Poco::File(Poco::Path(filename).parent()).createDirectories();
+			} else if (!ds::safeFileExistsCheck(filename, false)) {
+				return nullptr;
+			}
+		} catch (std::exception const&) {
+			return nullptr;
+		}
+
+		sqlite3*  db	= nullptr;
+		const int flags = create ? (SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE) : SQLITE_OPEN_READONLY;
+		if (sqlite3_open_v2(filename.c_str(), &db, flags, nullptr) != SQLITE_OK) {
+			sqlite3_close(db);
+			return nullptr;
+		}
+		// Other apps on this machine share the file
+		sqlite3_busy_timeout(db, 2000);
+		// Let sqlite read the file through a memory map rather than copying pages in
+		sqlite3_exec(db, "PRAGMA mmap_size=268435456", nullptr, nullptr, nullptr);
+
+		int			  version	= 0;
+		sqlite3_stmt* statement = nullptr;
+		if (sqlite3_prepare_v2(db, "PRAGMA user_version", -1, &statement, nullptr) == SQLITE_OK &&
+			sqlite3_step(statement) == SQLITE_ROW) {
+			version = sqlite3_column_int(statement, 0);
+		}
+		sqlite3_finalize(statement);
+
+		if (version != CACHE_VERSION) {
+			if (!create) {
+				sqlite3_close(db);
+				return nullptr;
+			}
+			const std::string schema = "DROP TABLE IF EXISTS image_meta;"
+									   "CREATE TABLE image_meta (path TEXT PRIMARY KEY, modified INTEGER, width REAL, "
+									   "height REAL, format INTEGER, orientation INTEGER);"
+									   "PRAGMA user_version=" +
+									   std::to_string(CACHE_VERSION) + ";";
+			if (sqlite3_exec(db, schema.c_str(), nullptr, nullptr, nullptr) != SQLITE_OK) {
+				sqlite3_close(db);
+				return nullptr;
+			}
+		}
+		return db;
+	}
+
+	void read_cache(const std::string& filename, std::unordered_map<std::string, ImageAtts>& out) {
+		sqlite3* db = open_cache(filename, false);
+		if (!db) return;
+
+		sqlite3_stmt* statement = nullptr;
+		if (sqlite3_prepare_v2(db, "SELECT path, modified, width, height, format, orientation FROM image_meta", -1,
+							   &statement, nullptr) == SQLITE_OK) {
+			while (sqlite3_step(statement) == SQLITE_ROW) {
+				const char* path = (const char*)sqlite3_column_text(statement, 0);
+				if (!path) continue;
+
+				ImageAtts atts(ci::vec2(static_cast<float>(sqlite3_column_double(statement, 2)),
+										static_cast<float>(sqlite3_column_double(statement, 3))));
+				atts.mLastModified = Poco::Timestamp(sqlite3_column_int64(statement, 1));
+				atts.mFormat	   = sqlite3_column_int(statement, 4);
+				atts.mOrientation  = sqlite3_column_int(statement, 5);
+				out[path]		   = atts;
+			}
+		}
+		sqlite3_finalize(statement);
+		sqlite3_close(db);
+	}
+
+	bool write_cache(const std::string& filename, const std::unordered_map<std::string, ImageAtts>& atts) {
+		sqlite3* db = open_cache(filename, true);
+		if (!db) return false;
+
+		bool		  ok		= sqlite3_exec(db, "BEGIN", nullptr, nullptr, nullptr) == SQLITE_OK;
+		sqlite3_stmt* statement = nullptr;
+		ok = ok && sqlite3_prepare_v2(db, "INSERT OR REPLACE INTO image_meta VALUES (?, ?, ?, ?, ?, ?)", -1, &statement,
+									  nullptr) == SQLITE_OK;
+		for (auto it = atts.begin(); ok && it != atts.end(); ++it) {
+			sqlite3_bind_text(statement, 1, it->first.c_str(), static_cast<int>(it->first.size()), SQLITE_TRANSIENT);
+			sqlite3_bind_int64(statement, 2, it->second.mLastModified.epochMicroseconds());
+			sqlite3_bind_double(statement, 3, it->second.mSize.x);
+			sqlite3_bind_double(statement, 4, it->second.mSize.y);
+			sqlite3_bind_int(statement, 5, it->second.mFormat);
+			sqlite3_bind_int(statement, 6, it->second.mOrientation);
+			ok = sqlite3_step(statement) == SQLITE_DONE;
+			sqlite3_reset(statement);
+		}
+		sqlite3_finalize(statement);
+		ok = sqlite3_exec(db, ok ? "COMMIT" : "ROLLBACK", nullptr, nullptr, nullptr) == SQLITE_OK && ok;
+		sqlite3_close(db);
+		return ok;
+	}
+
+	/// Everything is thread safe. Lookups come from the image loading and content query threads.
 	class ImageAttsCache {
 	  public:
-		ImageAttsCache() {}
+		ImageAttsCache()
+		  : mLoaded(false)
+		  , mStop(false) {}
+
+		~ImageAttsCache() { stopWriting(); }
+
+		/// Where sizes are kept between runs. Empty keeps them in memory only.
+		void setFilename(const std::string& filename) {
+			stopWriting();
+
+			std::lock_guard<std::mutex> lock(mMutex);
+			mFilename = filename;
+			mLoaded	  = false;
+		}
 
-		void clear() { mCache.clear(); }
+		void clear() {
+			std::lock_guard<std::mutex> lock(mMutex);
+			mCache.clear();
+			// Whatever is on disk still gets checked against the files before it's used
+			mLoaded = false;
+		}
 
 		void add(const std::string& filePath, const ci::vec2 size) {
 			if (size.x > 0 && size.y > 0) {
@@ -229,7 +376,12 @@ namespace {
 					if (ds::safeFileExistsCheck(filePath, false)) {
 						const auto file	   = Poco::File(filePath);
 						atts.mLastModified = file.getLastModified();
-						mCache[filePath]   = atts;
+						atts.mFormat	   = get_format(filePath);
+						atts.mChecked	   = steady_clock::now();
+
+						std::lock_guard<std::mutex> lock(mMutex);
+						mCache[filePath] = atts;
+						queueWrite(filePath, atts);
 					} else {
 						DS_LOG_WARNING_M(
 							"ImageAttsCache::add : File does not exist when finding metadata: " << filePath,
@@ -241,9 +393,9 @@ namespace {
 			}
 		}
 
-		ci::vec2 getSize(const std::string& fn) {
+		ImageAtts get(const std::string& fn) {
 			// If I've got a cached item and the modified dates match, use that.
-			// Note: for the actual path, use the expanded fn.
+			// Note: for the actual path, use the expanded fn, which is also what's stored on disk.
 
 			std::string expanded_fn;
 			bool		webMode = false;
@@ -254,16 +406,28 @@ namespace {
 				expanded_fn = ds::Environment::expand(fn);
 			}
 
-			try {
-				auto f = mCache.find(fn);
+			ImageAtts  cached;
+			bool	   found = false;
+			const auto now	 = steady_clock::now();
+			{
+				std::lock_guard<std::mutex> lock(mMutex);
+				if (!mLoaded) load();
 
+				auto f = mCache.find(expanded_fn);
 				if (f != mCache.end()) {
 					// we hope that the remote image hasn't changed since we grabbed it's size.
-					if (webMode) {
-						return f->second.mSize;
-					} else if (f->second.mLastModified == Poco::File(expanded_fn).getLastModified()) {
-						return f->second.mSize;
-					}
+					if (webMode || now - f->second.mChecked < RECHECK_TIME) return f->second;
+					cached = f->second;
+					found  = true;
+				}
+			}
+
+			try {
+				if (found && cached.mLastModified == Poco::File(expanded_fn).getLastModified()) {
+					std::lock_guard<std::mutex> lock(mMutex);
+					auto						f = mCache.find(expanded_fn);
+					if (f != mCache.end()) f->second.mChecked = now;
+					return cached;
 				}
 			} catch (std::exception const&) {}
 
@@ -273,35 +437,44 @@ namespace {
 				if (atts.mSize.x > 0.0f && atts.mSize.y > 0.0f) {
 					// calling anything on an invalid file throws an exception, and web stuff is invalid
 					if (!webMode) atts.mLastModified = Poco::File(expanded_fn).getLastModified();
-					mCache[fn] = atts;
-					return atts.mSize;
+					atts.mChecked = now;
+
+					std::lock_guard<std::mutex> lock(mMutex);
+					mCache[expanded_fn] = atts;
+					// Web images can change between runs without anyone noticing, so they're only kept in memory
+					if (!webMode) queueWrite(expanded_fn, atts);
+					return atts;
 				}
 			} catch (std::exception const&) {}
-			return ci::vec2(0.0f, 0.0f);
+			return ImageAtts();
 		}
 
 	  private:
 		ImageAtts generate(const std::string& fn) const {
+			const int format = get_format(fn);
+
 			// 1. Look for meta data encoded in file name
 			try {
 				FileMetaData meta(fn);
 				const int	 w = meta.findValueType<int>("w", -1), h = meta.findValueType<int>("h", -1);
 				if (w > 0 && h > 0) {
 					DS_LOG_VERBOSE(7, "ImageAttsCache got filename image size " << w << "x" << h << " for " << fn);
-					return ImageAtts(ci::vec2(static_cast<float>(w), static_cast<float>(h)));
+					ImageAtts atts(ci::vec2(static_cast<float>(w), static_cast<float>(h)));
+					atts.mFormat = format;
+					return atts;
 				}
 			} catch (std::exception const&) {}
 
 			// 2. Probe known file formats
 			try {
 				ImageAtts atts;
-				const int format = get_format(fn);
+				atts.mFormat = format;
 				if (format == FORMAT_PNG && get_format_png(fn, atts.mSize)) {
 					DS_LOG_VERBOSE(7, "ImageAttsCache got png image size " << atts.mSize.x << "x" << atts.mSize.y
 																		   << " for " << fn);
 					return atts;
 				}
-				if (format == FORMAT_JPG && get_format_jpg(fn, atts.mSize)) {
+				if (format == FORMAT_JPG && get_format_jpg(fn, atts.mSize, atts.mOrientation)) {
 					DS_LOG_VERBOSE(7, "ImageAttsCache got jpg image size " << atts.mSize.x << "x" << atts.mSize.y
 																		   << " for " << fn);
 					return atts;
@@ -315,18 +488,86 @@ namespace {
 			int outH = 0;
 			if (ds::safeFileExistsCheck(fn) && ds::ExifHelper::getImageSize(fn, outW, outH)) {
 				DS_LOG_VERBOSE(7, "ImageAttsCache got exif image size " << outW << "x" << outH << " for " << fn);
-				return ImageAtts(ci::vec2(static_cast<float>(outW), static_cast<float>(outH)));
+				ImageAtts atts(ci::vec2(static_cast<float>(outW), static_cast<float>(outH)));
+				atts.mFormat = format;
+				return atts;
 			}
 
 			// 4. Load the whole damn image in and get that.
 			ImageAtts atts;
+			atts.mFormat = format;
 			super_slow_image_atts(fn, atts.mSize);
 			DS_LOG_VERBOSE(7, "ImageAttsCache got super slow image size " << atts.mSize.x << "x" << atts.mSize.y
 																		  << " for " << fn);
 			return atts;
 		}
 
+		/// Call with mMutex held
+		void load() {
+			mLoaded = true;
+			if (mFilename.empty()) return;
+
+			std::unordered_map<std::string, ImageAtts> loaded;
+			read_cache(mFilename, loaded);
+			// Anything generated since the last clear() is newer than the disk
+			for (auto& it : mCache) {
+				loaded[it.first] = it.second;
+			}
+			mCache.swap(loaded);
+			DS_LOG_VERBOSE(1, "ImageAttsCache loaded " << mCache.size() << " image sizes from " << mFilename);
+		}
+
+		/// Call with mMutex held
+		void queueWrite(const std::string& filePath, const ImageAtts& atts) {
+			if (mFilename.empty()) return;
+
+			mPending[filePath] = atts;
+			if (!mWriter.joinable()) {
+				mWriter = std::thread([this] { writeLoop(); });
+			}
+			mWriteCondition.notify_one();
+		}
+
+		void writeLoop() {
+			std::unique_lock<std::mutex> lock(mMutex);
+			while (true) {
+				mWriteCondition.wait(lock, [this] { return mStop || !mPending.empty(); });
+				if (mPending.empty()) return;
+				if (!mStop) mWriteCondition.wait_for(lock, WRITE_DELAY, [this] { return mStop; });
+
+				std::unordered_map<std::string, ImageAtts> pending;
+				pending.swap(mPending);
+				const std::string filename = mFilename;
+
+				lock.unlock();
+				// Losing these just means probing the files again next run
+				write_cache(filename, pending);
+				lock.lock();
+			}
+		}
+
+		/// Writes anything pending and stops the writer thread
+		void stopWriting() {
+			{
+				std::lock_guard<std::mutex> lock(mMutex);
+				mStop = true;
+			}
+			mWriteCondition.notify_all();
+			if (mWriter.joinable()) mWriter.join();
+
+			std::lock_guard<std::mutex> lock(mMutex);
+			mStop = false;
+		}
+
+		std::mutex								   mMutex;
 		std::unordered_map<std::string, ImageAtts> mCache;
+		std::string								   mFilename;
+		bool									   mLoaded;
+
+		std::unordered_map<std::string, ImageAtts> mPending;
+		std::condition_variable					   mWriteCondition;
+		std::thread								   mWriter;
+		bool									   mStop;
 	};
 
 	ImageAttsCache CACHE;
@@ -336,11 +577,19 @@ namespace {
  * \class ImageMetaData
  */
 ImageMetaData::ImageMetaData()
-  : mSize(0.0f, 0.0f) {}
+  : mSize(0.0f, 0.0f)
+  , mOrientation(0) {}
 
 ImageMetaData::ImageMetaData(const std::string& filename)
-  : mSize(0.0f, 0.0f) {
-	mSize = CACHE.getSize(filename);
+  : mSize(0.0f, 0.0f)
+  , mOrientation(0) {
+	const ImageAtts atts = CACHE.get(filename);
+	mSize				 = atts.mSize;
+	mOrientation		 = atts.mOrientation;
+}
+
+void ImageMetaData::setPersistentCache(const std::string& filename) {
+	CACHE.setFilename(filename);
 }
 
 void ImageMetaData::clearMetadataCache() {
@@ -11,12 +11,18 @@ namespace ds {
  * \class ImageMetaData
  * \brief Read meta data for image files.
  * NOTE: This can be VERY slow, if the image needs to be loaded.
+ * What's read is cached, and kept between runs if there's a persistent cache.
  */
 class ImageMetaData {
   public:
 	ImageMetaData();
 	ImageMetaData(const std::string& filename);
 
+	/// Keep what's read in a sqlite file, so the next run doesn't have to read it again. Each file's modified time
+	/// is checked before its entry is used. Empty turns it off. The engine sets this from
+	/// load_image:persist_metadata.
+	static void setPersistentCache(const std::string& filename);
+
 	/// Clears any stored w/h info
 	static void clearMetadataCache();
 
@@ -24,6 +30,8 @@ class ImageMetaData {
 	void add(const std::string& filePath, const ci::vec2 size);
 
 	ci::vec2 mSize;
+	/// The exif orientation for jpgs that have one, otherwise 0
+	int mOrientation;
 };
 
 } // namespace ds